@@ -38,6 +38,8 @@ while [[ "$#" -gt 0 ]]; do
         --type) type="$2"; shift ;;
         --team_id) team_id="$2"; shift ;;
         --identity) identity="$2"; shift ;;
+        --trace) trace=1 ;;
+        --tests) tests=1 ;;
         *) echo "Unknown parameter passed: $1"; exit 1 ;;
     esac
     shift
@@ -49,6 +51,16 @@ if [ "$type" == "vst2" ]; then
     FLAGS="-DSMTG_CREATE_VST2_VERSION=ON"
 elif [ "$type" == "au" ]; then
     FLAGS="-GXcode -DSMTG_CREATE_AU_VERSION=ON"
+elif [ "$type" == "benchmark" ]; then
+    FLAGS="-DSMTG_CREATE_BENCHMARK_HOST=ON"
+fi
+
+if [ -n "$trace" ]; then
+    FLAGS="${FLAGS} -DSMTG_ENABLE_TRACE_ZONES=ON"
+fi
+
+if [ -n "$tests" ]; then
+    FLAGS="${FLAGS} -DSMTG_CREATE_TESTS=ON"
 fi
 
 if [ -z "$identity" ]; then
@@ -1,6 +1,9 @@
 // this is a Node.js script that can conveniently generate a lot of the boilerplate
 // code necessary to generate a model for your plugins adjustable parameters, exposing
 // it as a public API to DAWs and generating all UI related code
+//
+// the model is generated as a table of parameter descriptors and a packed struct holding
+// the values (see model.h), which are consumed by both the processor and controller
 
 // define your plugins controller model here
 // NOTE: all values are floats and while these are usually normalized to the 0 - 1 range, any arbitrary value is supported
@@ -16,15 +19,19 @@
 //         type: String,       // optional, defaults to float, accepts:
 //                             // 'bool' where the value is either 0 or 1 (on/off)
 //                             // 'percent' (multiplied by 100)
+//         scaling: String,    // optional, mapping of the normalized value onto the min - max range, defaults to 'linear', accepts:
+//                             // 'log' for logarithmic scaling (e.g. for frequencies, min must be larger than 0)
+//         steps: Number,      // optional, the amount of discrete steps (e.g. 3 for a selection of 4 values), defaults to continuous
 //     },
 //     ui: {               // optional, when defined, will create entry in .uidesc
 //         x: Number,      // x, y coordinates and width and height of control
-//         y: Number,
-//         w: Number,
+//         y: Number,      // (the largest of w and h also defines the resolution at which
+//         w: Number,      // value changes are redrawn in the editor, see PluginController::flushParameterUpdates())
 //         h: Number.
 //     },
 //     normalizedDescr: Boolean, // optional, whether to display the value in the host normalized (otherwise falls back to 0 - 1 range), defaults to false
-//     customDescr: String,      // optional, custom instruction used in controller.cpp to format value
+//     customDescr: String,      // optional, custom instruction used to format value into char* text (valueNormalized and valuePlain are available)
+//     smooth: Boolean,          // optional, whether changes to the value should be smoothed over time (to prevent zipper noise), defaults to false
 // }
 const MODEL = [
     {
@@ -56,17 +63,137 @@ const MODEL = [
         descr: "Wet mix",
         unitDescr: "%",
         value: { min: "0.f", max: "1.f", def: "1.f", type: "percent" },
-        ui: { x: 10, y: 150, w: 134, h: 21 }
+        ui: { x: 10, y: 150, w: 134, h: 21 },
+        smooth: true
     },
     {
         name: "dryMix",
         descr: "Dry mix",
         unitDescr: "%",
         value: { min: "0.f", max: "1.f", type: "percent" },
-        ui: { x: 10, y: 180, w: 134, h: 21 }
+        ui: { x: 10, y: 180, w: 134, h: 21 },
+        smooth: true
+    },
+    {
+        name: "sideChainDuck",
+        descr: "Sidechain duck",
+        unitDescr: "%",
+        value: { min: "0.f", max: "1.f", type: "percent" },
+        ui: { x: 199, y: 90, w: 104, h: 21 }
+    },
+    {
+        name: "sideChainCrush",
+        descr: "Sidechain crush",
+        unitDescr: "%",
+        value: { min: "0.f", max: "1.f", type: "percent" },
+        ui: { x: 199, y: 120, w: 104, h: 21 }
+    },
+    {
+        name: "delayTime",
+        descr: "Delay time",
+        unitDescr: "note",
+        value: { min: "0.f", max: "1.f", def: "1.f", steps: 3 },
+        ui: { x: 10, y: 210, w: 134, h: 21 },
+        // synchronized to the host tempo, see PluginProcess::setDelayTime()
+        customDescr: `static const char* NOTES[] = { "1/16", "1/8", "1/4", "1/2" }; sprintf( text, "%s", NOTES[ ( int ) round( valueNormalized * 3 ) ] );`
+    },
+    {
+        name: "delayFeedback",
+        descr: "Delay feedback",
+        unitDescr: "%",
+        value: { min: "0.f", max: "1.f", def: "0.4f", type: "percent" },
+        ui: { x: 199, y: 195, w: 104, h: 21 }
+    },
+    {
+        name: "delayMix",
+        descr: "Delay mix",
+        unitDescr: "%",
+        value: { min: "0.f", max: "1.f", type: "percent" },
+        ui: { x: 199, y: 225, w: 104, h: 21 },
+        smooth: true
+    },
+    {
+        name: "filterHighPass",
+        descr: "High-pass",
+        unitDescr: "Hz",
+        // the minimum disables the filter, see FilterBank::MIN_HIGH_PASS
+        value: { min: "20.f", max: "2000.f", def: "20.f", scaling: "log" },
+        ui: { x: 10, y: 60, w: 134, h: 21 },
+        normalizedDescr: true
+    },
+    {
+        name: "filterLowPass",
+        descr: "Low-pass",
+        unitDescr: "Hz",
+        // the maximum disables the filter, see FilterBank::MAX_LOW_PASS
+        value: { min: "500.f", max: "20000.f", def: "20000.f", scaling: "log" },
+        ui: { x: 199, y: 60, w: 104, h: 21 },
+        normalizedDescr: true
+    },
+    {
+        name: "filterTilt",
+        descr: "Tilt",
+        unitDescr: "dB",
+        value: { min: "-6.f", max: "6.f", def: "0.f" },
+        ui: { x: 380, y: 225, w: 80, h: 21 },
+        normalizedDescr: true
+    },
+    {
+        name: "convolverImpulse",
+        descr: "Impulse response",
+        unitDescr: "",
+        value: { min: "0.f", max: "1.f", def: "0.f", steps: 3 },
+        ui: { x: 312, y: 90, w: 60, h: 21 },
+        // see Convolver::Impulse
+        customDescr: `static const char* IMPULSES[] = { "Off", "Cabinet", "Room", "Hall" }; sprintf( text, "%s", IMPULSES[ ( int ) round( valueNormalized * 3 ) ] );`
+    },
+    {
+        name: "convolverMix",
+        descr: "Impulse response mix",
+        unitDescr: "%",
+        value: { min: "0.f", max: "1.f", def: "1.f", type: "percent" },
+        ui: { x: 312, y: 120, w: 60, h: 21 },
+        smooth: true
+    },
+    {
+        name: "bitCrushAntiAliasing",
+        descr: "Bit crush anti-aliasing",
+        unitDescr: "",
+        value: { min: "0.f", max: "1.f", def: "0.f", steps: 2 },
+        ui: { x: 312, y: 150, w: 60, h: 21 },
+        // see BitCrusher::AntiAliasing
+        customDescr: `static const char* MODES[] = { "Off", "ADAA 1st", "ADAA 2nd" }; sprintf( text, "%s", MODES[ ( int ) round( valueNormalized * 2 ) ] );`
+    },
+    {
+        name: "bitCrushDither",
+        descr: "Bit crush dither",
+        unitDescr: "",
+        value: { min: "0.f", max: "1.f", def: "0.f", steps: 2 },
+        ui: { x: 312, y: 180, w: 60, h: 21 },
+        // see Dither::Mode
+        customDescr: `static const char* MODES[] = { "Off", "TPDF", "Shaped" }; sprintf( text, "%s", MODES[ ( int ) round( valueNormalized * 2 ) ] );`
+    },
+    {
+        name: "outputLimiter",
+        descr: "Output limiter",
+        unitDescr: "",
+        // limits the output at 0 dBFS, see PluginProcess::setLimiterEnabled()
+        value: { min: "0.f", max: "1.f", def: "0.f", type: "bool" },
+        ui: { x: 312, y: 210, w: 60, h: 21 }
     }
 ];
 
+// define the factory presets here, these are written into a memory mapped preset bank (see presetbank.h)
+// values are normalized (0 - 1 range) and keyed by the models name, omitted values fall back to the models default
+// NOTE: preset names cannot exceed 31 characters
+
+const PRESETS = [
+    { name: "Init", values: {} },
+    { name: "Lo-fi", values: { bitDepth: 0.35, wetMix: 0.8, dryMix: 0.2 } },
+    { name: "Crushed", values: { bitDepth: 0.1, wetMix: 1, dryMix: 0 } },
+    { name: "Wobble", values: { bitDepth: 0.5, bitCrushLfo: 0.2, bitCrushLfoDepth: 0.8, wetMix: 0.7, dryMix: 0.3 } }
+];
+
 // DO NOT CHANGE BELOW
 
 const fs = require( "fs" );
@@ -134,187 +261,81 @@ function generateParamIds() {
     fs.writeFileSync( outputFile, replaceContent( fileData, lines ));
 }
 
-function generateVstHeader() {
-    const outputFile    = `${SOURCE_FOLDER}/vst.h`;
-    const fileData      = fs.readFileSync( outputFile, { encoding:'utf8', flag:'r' });
-    const lines = [];
-
-    MODEL.forEach( entry => {
-        const { descr, value } = entry;
-        const { model } = generateNamesForParam( entry );
-        const type = getType( entry );
-        let line;
-        if ( type === "bool" ) {
-            line = `        bool ${model} = ${!!parseFloat( value.def ) > 0.5};    // ${descr}`;
-        } else {
-            line = `        float ${model} = ${value.def ?? value.min};    // ${descr}`;
-        }
-        lines.push( `${line}\n` );
-    });
-    fs.writeFileSync( outputFile, replaceContent( fileData, lines ));
+function toNumber( value ) {
+    return parseFloat( value );
 }
 
-function generateVstImpl() {
-    const outputFile = `${SOURCE_FOLDER}/vst.cpp`;
-    let fileData     = fs.readFileSync( outputFile, { encoding: "utf8", flag: "r" });
-
-    const processLines = [];
-    const setStateLines = [];
-    const setStateApplyLines = [];
-    const getStateLines = [];
-
-    MODEL.forEach( entry => {
-        const { model, paramId, saved, toSave } = generateNamesForParam( entry );
-        const type = getType( entry );
-
-        if ( type === "bool" ) {
-            // 1. __PLUGIN_NAME__::process
-            processLines.push(`
-                    case ${paramId}:
-                        ${model} = ( value > 0.5f );
-                        break;\n`);
-
-            // 2. __PLUGIN_NAME__::setState
-
-            setStateLines.push(`    int32 ${saved} = 0;
-    if ( streamer.readInt32( ${saved} ) == false )
-        return kResultFalse;\n\n`
-            );
-            setStateApplyLines.push(`    ${model} = ${saved} > 0;\n`); // assignment to model
-
-            // 3. __PLUGIN_NAME__::getState
-
-            getStateLines.push(`    streamer.writeInt32( ${model} ? 1 : 0 );\n` );
-
-        } else {
-
-            // 1. __PLUGIN_NAME__::process
-            processLines.push(`
-                    case ${paramId}:
-                        ${model} = ( float ) value;
-                        break;\n`);
-
-            // 2. __PLUGIN_NAME__::setState
-
-            setStateLines.push(`    float ${saved} = 0.f;
-    if ( streamer.readFloat( ${saved} ) == false )
-        return kResultFalse;\n\n`
-            );
-            setStateApplyLines.push(`    ${model} = ${saved};\n`); // assignment to model
-
-            // 3. __PLUGIN_NAME__::getState
-
-            getStateLines.push(`    streamer.writeFloat( ${model} );\n` );
-        }
-    });
-
-    let startId = '// --- AUTO-GENERATED PROCESS START';
-    let endId   = '// --- AUTO-GENERATED PROCESS END';
-    fileData = replaceContent( fileData, processLines, startId, endId );
-
-    startId = '// --- AUTO-GENERATED SETSTATE START';
-    endId   = '// --- AUTO-GENERATED SETSTATE END';
-    fileData = replaceContent( fileData, setStateLines, startId, endId );
-
-    startId = '// --- AUTO-GENERATED SETSTATE APPLY START';
-    endId   = '// --- AUTO-GENERATED SETSTATE APPLY END';
-    fileData = replaceContent( fileData, setStateApplyLines, startId, endId );
+function toFloatLiteral( value ) {
+    const str = `${toNumber( value )}`;
+    return str.includes( "." ) || str.includes( "e" ) ? `${str}f` : `${str}.f`;
+}
 
-    startId = '// --- AUTO-GENERATED GETSTATE START';
-    endId   = '// --- AUTO-GENERATED GETSTATE END';
-    fileData = replaceContent( fileData, getStateLines, startId, endId );
+function getNormalizedDefault( entry ) {
+    const { min, max, def } = entry.value;
+    const range = toNumber( max ) - toNumber( min );
+    const value = toNumber( def ?? min );
 
-    fs.writeFileSync( outputFile, fileData );
+    if ( range === 0 ) {
+        return 0;
+    }
+    if ( entry.value.scaling === "log" ) {
+        return Math.log( value / toNumber( min )) / Math.log( toNumber( max ) / toNumber( min ));
+    }
+    return ( value - toNumber( min )) / range;
 }
 
-function generateController() {
-    const outputFile = `${SOURCE_FOLDER}/ui/controller.cpp`;
-    let fileData     = fs.readFileSync( outputFile, { encoding:'utf8', flag:'r' });
+function generateModelHeader() {
+    const outputFile = `${SOURCE_FOLDER}/model.h`;
+    let fileData     = fs.readFileSync( outputFile, { encoding: "utf8", flag: "r" });
 
-    const initLines = [];
-    const setStateLines = [];
-    const getParamLines = [];
-    let line;
+    const modelLines = [];
+    const descriptorLines = [];
 
     MODEL.forEach( entry => {
-        const { param, paramId, saved } = generateNamesForParam( entry );
-        const { descr, unitDescr, normalizedDescr, customDescr } = entry;
+        const { name, descr, unitDescr, normalizedDescr, customDescr, smooth, ui } = entry;
+        const { paramId } = generateNamesForParam( entry );
         const type = getType( entry );
-        let { min, max, def } = entry.value;
-        if ( !def ) {
-            def = min;
-        }
+        const { min, max, scaling } = entry.value;
+        const def = toFloatLiteral( getNormalizedDefault( entry ));
 
-        // 1. PluginController::initialize
+        // 1. the packed model struct, note all values (including bools) are stored
+        // as normalized floats to allow table-driven processing and serialization
 
-        if ( type === "bool" ) {
-            line = `
-    parameters.addParameter(
-        USTRING( "${descr}" ), ${min}, ${max}, ${def}, ParameterInfo::kCanAutomate, ${paramId}, unitId
-    );\n\n`;
-        } else {
-            line = `    RangeParameter* ${param} = new RangeParameter(
-        USTRING( "${descr}" ), ${paramId}, USTRING( "${unitDescr}" ),
-        ${min}, ${max}, ${def},
-        0, ParameterInfo::kCanAutomate, unitId
-    );
-    parameters.addParameter( ${param} );\n\n`;
-        }
-        initLines.push( line );
+        modelLines.push( `    float ${name} = ${def};    // ${descr}\n` );
 
-        // 2. PluginController::setComponentState
+        // 2. the parameter descriptor
 
-        if ( type === "bool" ) {
-            setStateLines.push(`    int32 ${saved} = ${parseInt( def )};
-    if ( streamer.readInt32( ${saved} ) == false )
-        return kResultFalse;
-    setParamNormalized( ${paramId}, ${saved} ? 1 : 0 );\n\n`
-            );
-        } else {
-            setStateLines.push(`    float ${saved} = ${def || "0.f" };
-    if ( streamer.readFloat( ${saved} ) == false )
-        return kResultFalse;
-    setParamNormalized( ${paramId}, ${saved} );\n\n`
-            );
-        }
-
-        // 3. PluginController::getParamStringByValue
-        // TODO: we can optimize this by grouping case values
-
-        line = `        case ${paramId}:`;
+        let format;
 
         if ( customDescr ) {
-           line += `
-            ${customDescr}`;
+           format = customDescr;
         } else if ( type === "bool" ) {
-            line += `
-            sprintf( text, "%s", ( valueNormalized == 0 ) ? "Off" : "On" );`;
+            format = `sprintf( text, "%s", ( valueNormalized == 0 ) ? "Off" : "On" );`;
         } else if ( type === "percent" ) {
-            line += `
-            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));`;
+            format = `sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));`;
         } else if ( normalizedDescr ) {
-            line += `
-            sprintf( text, "%.2f ${unitDescr}", normalizedParamToPlain( tag, valueNormalized ));`;
+            format = `sprintf( text, "%.2f ${unitDescr}", valuePlain );`;
         } else {
-            line += `
-            sprintf( text, "%.2f", ( float ) valueNormalized );`;
+            format = `sprintf( text, "%.2f", ( float ) valueNormalized );`;
         }
 
-        line += `
-            Steinberg::UString( string, 128 ).fromAscii( text );
-            return kResultTrue;\n\n`;
-
-        getParamLines.push( line );
+        descriptorLines.push(`    {
+        ${paramId}, "${descr}", "${unitDescr}",
+        ${toFloatLiteral( min )}, ${toFloatLiteral( max )}, ${def}, ${type === "bool" ? 1 : ( entry.value.steps || 0 )},
+        ParameterScaling::${scaling === "log" ? "LOGARITHMIC" : "LINEAR"}, ${!!smooth}, ${ui ? Math.max( ui.w, ui.h ) : 0},
+        []( double valueNormalized, double valuePlain, char* text ) {
+            ${format}
+        }
+    },\n`);
     });
-    fileData = replaceContent( fileData, initLines );
 
-    let startId = '// --- AUTO-GENERATED SETCOMPONENTSTATE START';
-    let endId   = '// --- AUTO-GENERATED SETCOMPONENTSTATE END';
-    fileData = replaceContent( fileData, setStateLines, startId, endId );
+    let startId = '// --- AUTO-GENERATED MODEL START';
+    let endId   = '// --- AUTO-GENERATED MODEL END';
+    fileData = replaceContent( fileData, modelLines, startId, endId );
 
-    startId = '// --- AUTO-GENERATED GETPARAM START';
-    endId   = '// --- AUTO-GENERATED GETPARAM END';
-    fileData = replaceContent( fileData, getParamLines, startId, endId );
+    startId = '// --- AUTO-GENERATED DESCRIPTORS START';
+    endId   = '// --- AUTO-GENERATED DESCRIPTORS END';
+    fileData = replaceContent( fileData, descriptorLines, startId, endId );
 
     fs.writeFileSync( outputFile, fileData );
 }
@@ -380,13 +401,68 @@ function generateUI() {
     fs.writeFileSync( outputFile, fileData );
 }
 
+function generatePresetBank() {
+    const outputFile = `${RESOURCE_FOLDER}/presets.bin`;
+
+    // these must match the definitions in presetbank.h
+
+    const BANK_MAGIC   = 0x4B4E4247;
+    const BANK_VERSION = 1;
+    const HEADER_SIZE  = 6 * 4;
+    const NAME_LENGTH  = 32;
+    const INDEX_SIZE   = NAME_LENGTH + 4 + 4;
+    const RECORD_SIZE  = 4 + MODEL.length * 4; // bypass followed by all model values
+
+    const hash = name => {
+        // 32-bit FNV-1a
+        let value = 2166136261;
+        for ( let i = 0; i < name.length && i < NAME_LENGTH; ++i ) {
+            value ^= name.charCodeAt( i ) & 0xFF;
+            value  = Math.imul( value, 16777619 ) >>> 0;
+        }
+        return value >>> 0;
+    };
+
+    const indexOffset  = HEADER_SIZE;
+    const recordOffset = indexOffset + PRESETS.length * INDEX_SIZE;
+    const buffer       = Buffer.alloc( recordOffset + PRESETS.length * RECORD_SIZE );
+
+    buffer.writeUInt32LE( BANK_MAGIC,     0 );
+    buffer.writeUInt32LE( BANK_VERSION,   4 );
+    buffer.writeUInt32LE( PRESETS.length, 8 );
+    buffer.writeUInt32LE( RECORD_SIZE,    12 );
+    buffer.writeUInt32LE( indexOffset,    16 );
+    buffer.writeUInt32LE( recordOffset,   20 );
+
+    PRESETS.forEach(( preset, index ) => {
+        if ( preset.name.length >= NAME_LENGTH ) {
+            throw new Error( `Preset name "${preset.name}" exceeds ${NAME_LENGTH - 1} characters` );
+        }
+        const entryOffset = indexOffset + index * INDEX_SIZE;
+        buffer.write( preset.name, entryOffset, NAME_LENGTH - 1, "ascii" );
+        buffer.writeUInt32LE( hash( preset.name ), entryOffset + NAME_LENGTH );
+        buffer.writeUInt32LE( index, entryOffset + NAME_LENGTH + 4 );
+
+        const offset = recordOffset + index * RECORD_SIZE;
+        buffer.writeInt32LE( 0, offset ); // bypass
+
+        MODEL.forEach(( entry, paramIndex ) => {
+            let value = preset.values[ entry.name ];
+            if ( value === undefined ) {
+                value = getNormalizedDefault( entry );
+            }
+            buffer.writeFloatLE( value, offset + 4 + paramIndex * 4 );
+        });
+    });
+    fs.writeFileSync( outputFile, buffer );
+}
+
 (function execute() {
     try {
         generateParamIds();
-        generateVstHeader();
-        generateVstImpl();
-        generateController();
+        generateModelHeader();
         generateUI();
+        generatePresetBank();
 
         console.log( 'Successfully generated the plugin model.' );
     } catch ( e ) {
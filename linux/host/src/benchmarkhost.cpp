@@ -0,0 +1,1218 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * A minimal headless VST3 host used to benchmark the plugin binary as a whole (e.g. the
+ * parameter queue decoding, model synchronization, bus handling and silence flags on top
+ * of the DSP) without opening its editor. Reports the timing of each process() call.
+ *
+ * usage: benchmarkhost [options] path/to/__PLUGIN_NAME__.vst3
+ *
+ * --input sine|noise|silence|fade|file.wav  input signal, a file is looped when shorter than the run (defaults to sine)
+ *                   fade fades a sine out to silence (-120 dB) over the first FADE_SECONDS, followed by silence
+ * --seconds S       duration of the processed audio (defaults to 10)
+ * --block N         block size in samples (defaults to 512)
+ * --rate HZ         sample rate (defaults to 48000)
+ * --tempo BPM       tempo provided through the process context (defaults to 120)
+ * --offline         process in offline (rather than realtime) mode
+ * --sidechain       instantiate the sidechain variant of the plugin (its sidechain is fed a gated signal)
+ * --automation F    automation script, each line formatted as: "seconds parameterId normalizedValue"
+ * --automate-all    continuously automate all (automatable) parameters
+ * --warmup N        amount of blocks to process prior to measuring (defaults to 16)
+ * --csv F           write the duration of each measured block (in microseconds) to given file
+ * --segments N      additionally report the CPU load of N consecutive segments of the run (defaults to 10 for the fade input)
+ * --instances N     process each block through N instances in turn, as a session with N tracks would (defaults to 1)
+ * --counters        additionally report the cache and TLB misses within the process() calls (see PerfCounters)
+ * --instantiate N   measure the duration of N instantiations rather than running the benchmark (see runInstantiationBenchmark())
+ * --memory N        measure the memory used by N concurrent instances rather than running the benchmark (see runMemoryBenchmark())
+ * --stress          run the stress test rather than the benchmark (see runStressTest())
+ * --seed N          seed of the random block sizes, input and parameter changes of the stress test (defaults to 1)
+ */
+#include "public.sdk/source/vst/hosting/hostclasses.h"
+#include "public.sdk/source/vst/hosting/module.h"
+#include "public.sdk/source/vst/hosting/parameterchanges.h"
+#include "public.sdk/source/vst/hosting/plugprovider.h"
+#include "public.sdk/source/vst/hosting/processdata.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
+#include "pluginterfaces/vst/ivstcomponent.h"
+#include "pluginterfaces/vst/ivsteditcontroller.h"
+#include "pluginterfaces/vst/ivstprocesscontext.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+namespace {
+
+struct Options {
+    std::string plugin;
+    std::string input      = "sine";
+    std::string automation;
+    std::string csv;
+    double seconds         = 10.0;
+    int32 blockSize        = 512;
+    double sampleRate      = 48000.0;
+    double tempo           = 120.0;
+    bool offline           = false;
+    bool sideChain         = false;
+    bool automateAll       = false;
+    bool stress            = false;
+    bool counters          = false;
+    int instances          = 1;
+    int instantiations     = 0;
+    int memoryInstances    = 0;
+    uint32_t seed          = 1;
+    int warmupBlocks       = 16;
+    int segments           = 0;
+};
+
+// duration of the fade input, after which it is silent (e.g. to measure the
+// CPU load while the recursive processors decay towards subnormal values)
+
+static const double FADE_SECONDS = 2.0;
+
+struct AutomationPoint {
+    double seconds;
+    ParamID id;
+    ParamValue value;
+};
+
+// deinterleaved audio, used as the input signal
+
+struct Audio {
+    std::vector<std::vector<float>> channels;
+    size_t length = 0;
+};
+
+bool parseOptions( int argc, char* argv[], Options& options )
+{
+    for ( int i = 1; i < argc; ++i ) {
+        std::string arg = argv[ i ];
+        bool hasValue   = i + 1 < argc;
+
+        if ( arg == "--input" && hasValue )             options.input        = argv[ ++i ];
+        else if ( arg == "--seconds" && hasValue )      options.seconds      = atof( argv[ ++i ]);
+        else if ( arg == "--block" && hasValue )        options.blockSize    = atoi( argv[ ++i ]);
+        else if ( arg == "--rate" && hasValue )         options.sampleRate   = atof( argv[ ++i ]);
+        else if ( arg == "--tempo" && hasValue )        options.tempo        = atof( argv[ ++i ]);
+        else if ( arg == "--automation" && hasValue )   options.automation   = argv[ ++i ];
+        else if ( arg == "--warmup" && hasValue )       options.warmupBlocks = atoi( argv[ ++i ]);
+        else if ( arg == "--csv" && hasValue )          options.csv          = argv[ ++i ];
+        else if ( arg == "--segments" && hasValue )     options.segments     = atoi( argv[ ++i ]);
+        else if ( arg == "--instances" && hasValue )    options.instances    = std::max( 1, atoi( argv[ ++i ]));
+        else if ( arg == "--instantiate" && hasValue )  options.instantiations = atoi( argv[ ++i ]);
+        else if ( arg == "--memory" && hasValue )       options.memoryInstances = atoi( argv[ ++i ]);
+        else if ( arg == "--seed" && hasValue )         options.seed         = ( uint32_t ) atol( argv[ ++i ]);
+        else if ( arg == "--counters" )                 options.counters     = true;
+        else if ( arg == "--offline" )                  options.offline      = true;
+        else if ( arg == "--sidechain" )                options.sideChain    = true;
+        else if ( arg == "--automate-all" )             options.automateAll  = true;
+        else if ( arg == "--stress" )                   options.stress       = true;
+        else if ( arg.rfind( "--", 0 ) != 0 )           options.plugin       = arg;
+        else {
+            fprintf( stderr, "Unknown option \"%s\"\n", arg.c_str());
+            return false;
+        }
+    }
+    return !options.plugin.empty() && options.blockSize > 0 && options.sampleRate > 0.0 && options.seconds > 0.0;
+}
+
+// reads a 16-bit PCM or 32-bit floating point WAV file
+
+bool readWav( const std::string& path, Audio& audio )
+{
+    std::ifstream file( path, std::ios::binary );
+    if ( !file ) {
+        return false;
+    }
+    std::vector<char> data(( std::istreambuf_iterator<char>( file )), std::istreambuf_iterator<char>());
+    if ( data.size() < 12 || memcmp( data.data(), "RIFF", 4 ) != 0 || memcmp( data.data() + 8, "WAVE", 4 ) != 0 ) {
+        return false;
+    }
+
+    uint16_t format = 0, channels = 0, bitsPerSample = 0;
+    const char* samples = nullptr;
+    uint32_t sampleBytes = 0;
+
+    for ( size_t offset = 12; offset + 8 <= data.size(); ) {
+        uint32_t chunkSize;
+        memcpy( &chunkSize, data.data() + offset + 4, 4 );
+        const char* chunk = data.data() + offset + 8;
+        chunkSize = ( uint32_t ) std::min<size_t>( chunkSize, data.size() - offset - 8 );
+
+        if ( memcmp( data.data() + offset, "fmt ", 4 ) == 0 && chunkSize >= 16 ) {
+            memcpy( &format,        chunk, 2 );
+            memcpy( &channels,      chunk + 2, 2 );
+            memcpy( &bitsPerSample, chunk + 14, 2 );
+        } else if ( memcmp( data.data() + offset, "data", 4 ) == 0 ) {
+            samples     = chunk;
+            sampleBytes = chunkSize;
+        }
+        offset += 8 + chunkSize + ( chunkSize & 1 );
+    }
+
+    bool isPCM   = format == 1 && bitsPerSample == 16;
+    bool isFloat = format == 3 && bitsPerSample == 32;
+
+    if ( samples == nullptr || channels == 0 || !( isPCM || isFloat )) {
+        return false;
+    }
+
+    audio.length = sampleBytes / ( channels * ( bitsPerSample / 8 ));
+    audio.channels.assign( channels, std::vector<float>( audio.length ));
+
+    for ( size_t i = 0; i < audio.length; ++i ) {
+        for ( int c = 0; c < channels; ++c ) {
+            size_t index = i * channels + c;
+            if ( isPCM ) {
+                int16_t value;
+                memcpy( &value, samples + index * 2, 2 );
+                audio.channels[ c ][ i ] = value / 32768.f;
+            } else {
+                memcpy( &audio.channels[ c ][ i ], samples + index * 4, 4 );
+            }
+        }
+    }
+    return audio.length > 0;
+}
+
+bool readAutomation( const std::string& path, std::vector<AutomationPoint>& points )
+{
+    std::ifstream file( path );
+    if ( !file ) {
+        return false;
+    }
+    std::string line;
+    while ( std::getline( file, line )) {
+        if ( line.empty() || line[ 0 ] == '#' ) {
+            continue;
+        }
+        std::istringstream stream( line );
+        AutomationPoint point;
+        if ( stream >> point.seconds >> point.id >> point.value ) {
+            points.push_back( point );
+        }
+    }
+    std::stable_sort( points.begin(), points.end(), []( const AutomationPoint& a, const AutomationPoint& b ) {
+        return a.seconds < b.seconds;
+    });
+    return true;
+}
+
+// generates a synthetic input signal (when no file is used)
+
+float synthesize( const std::string& type, int64_t position, int channel, double sampleRate, uint32_t& seed )
+{
+    if ( type == "noise" ) {
+        seed = seed * 1664525u + 1013904223u;
+        return (( seed >> 8 ) / 8388608.f - 1.f ) * .5f;
+    }
+    if ( type == "silence" ) {
+        return 0.f;
+    }
+    if ( type == "fade" ) {
+        double seconds = position / sampleRate;
+        if ( seconds >= FADE_SECONDS ) {
+            return 0.f;
+        }
+        double gain = pow( 10.0, -6.0 * seconds / FADE_SECONDS ); // -120 dB at FADE_SECONDS
+        return ( float ) ( .5 * gain * sin( 2.0 * M_PI * ( 220.0 + channel * 1.5 ) * position / sampleRate ));
+    }
+    // a sine at a slightly different frequency for each channel
+    return .5f * ( float ) sin( 2.0 * M_PI * ( 220.0 + channel * 1.5 ) * position / sampleRate );
+}
+
+double percentile( std::vector<double> values, double fraction )
+{
+    std::sort( values.begin(), values.end());
+    size_t index = std::min( values.size() - 1, ( size_t ) ( fraction * ( values.size() - 1 ) + .5 ));
+    return values[ index ];
+}
+
+/* hardware counters */
+
+// counts the cache and TLB misses of the calling thread while started, using the perf_event_open()
+// syscall (Linux only). Counters not supported by the CPU (or not exposed to virtual machines) are
+// omitted, none are available when perf_event_paranoid disallows measuring user space
+
+class PerfCounters
+{
+    public:
+        static const int COUNT = 4;
+
+        PerfCounters()
+        {
+#ifdef __linux__
+            const uint64_t READ_MISS = ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+            const uint32_t types[ COUNT ]   = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE };
+            const uint64_t configs[ COUNT ] = {
+                PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+                PERF_COUNT_HW_CACHE_L1D | READ_MISS, PERF_COUNT_HW_CACHE_DTLB | READ_MISS
+            };
+            // the first counter leads the group, the others are started and stopped along with it
+
+            for ( int i = 0; i < COUNT; ++i ) {
+                perf_event_attr attributes = {};
+                attributes.size           = sizeof( perf_event_attr );
+                attributes.type           = types[ i ];
+                attributes.config         = configs[ i ];
+                attributes.disabled       = _fds[ 0 ] < 0 ? 1 : 0;
+                attributes.exclude_kernel = 1;
+                attributes.exclude_hv     = 1;
+                attributes.read_format    = PERF_FORMAT_GROUP;
+
+                _fds[ i ] = ( int ) syscall( SYS_perf_event_open, &attributes, 0, -1, _fds[ 0 ], 0 );
+                if ( i == 0 && _fds[ 0 ] < 0 ) {
+                    return;
+                }
+            }
+#endif
+        }
+
+        ~PerfCounters()
+        {
+            for ( int fd : _fds ) {
+                if ( fd >= 0 ) {
+                    close( fd );
+                }
+            }
+        }
+
+        static const char* name( int index )
+        {
+            static const char* names[ COUNT ] = { "cache references", "cache misses (LLC)", "L1D read misses", "dTLB read misses" };
+            return names[ index ];
+        }
+
+        bool isAvailable() const { return _fds[ 0 ] >= 0; }
+        bool isAvailable( int index ) const { return _fds[ index ] >= 0; }
+
+        void start()
+        {
+#ifdef __linux__
+            if ( isAvailable()) {
+                ioctl( _fds[ 0 ], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+            }
+#endif
+        }
+
+        void stop()
+        {
+#ifdef __linux__
+            if ( isAvailable()) {
+                ioctl( _fds[ 0 ], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP );
+            }
+#endif
+        }
+
+        // the totals of all started periods, unavailable counters remain 0
+
+        void read( uint64_t values[ COUNT ]) const
+        {
+            uint64_t group[ COUNT + 1 ] = {}; // the amount of counters followed by their values
+
+            std::fill( values, values + COUNT, 0 );
+            if ( !isAvailable() || ::read( _fds[ 0 ], group, sizeof( group )) <= 0 ) {
+                return;
+            }
+            for ( int i = 0, value = 0; i < COUNT && value < ( int ) group[ 0 ]; ++i ) {
+                if ( isAvailable( i )) {
+                    values[ i ] = group[ 1 + value++ ];
+                }
+            }
+        }
+
+    private:
+        int _fds[ COUNT ] = { -1, -1, -1, -1 };
+};
+
+/* instances */
+
+// the audio effect class to instantiate (either the plain or the sidechain variant)
+
+bool findEffectClass( VST3::Hosting::PluginFactory& factory, bool sideChain, VST3::Hosting::ClassInfo& result )
+{
+    for ( auto& classInfo : factory.classInfos()) {
+        if ( classInfo.category() != kVstAudioEffectClass ) {
+            continue;
+        }
+        bool isSideChainClass = classInfo.name().find( "Sidechain" ) != std::string::npos;
+        if ( isSideChainClass == sideChain ) {
+            result = classInfo;
+            return true;
+        }
+    }
+    return false;
+}
+
+// activates all busses (including the sidechain) and prepares given instance for processing in given setup,
+// data provides the buffers (holding up to bufferSize samples), data.numSamples is set to the maximum block size
+
+bool startProcessing( IComponent* component, IAudioProcessor* processor, ProcessSetup setup, HostProcessData& data, int32 bufferSize )
+{
+    if ( processor->setupProcessing( setup ) != kResultOk ) {
+        fprintf( stderr, "setupProcessing() failed\n" );
+        return false;
+    }
+
+    for ( BusDirection direction : { kInput, kOutput }) {
+        for ( int32 i = 0, l = component->getBusCount( kAudio, direction ); i < l; ++i ) {
+            component->activateBus( kAudio, direction, i, true );
+        }
+    }
+    data.prepare( *component, bufferSize, setup.symbolicSampleSize );
+    data.processMode        = setup.processMode;
+    data.symbolicSampleSize = setup.symbolicSampleSize;
+    data.numSamples         = setup.maxSamplesPerBlock;
+
+    if ( component->setActive( true ) != kResultOk ) {
+        fprintf( stderr, "setActive() failed\n" );
+        return false;
+    }
+    processor->setProcessing( true );
+
+    return true;
+}
+
+// an instance processed alongside the benchmarked one (see --instances)
+
+struct Instance {
+    IPtr<PlugProvider> provider;
+    IComponent* component = nullptr;
+    FUnknownPtr<IAudioProcessor> processor;
+    std::unique_ptr<HostProcessData> data;
+};
+
+void stopProcessing( IComponent* component, IAudioProcessor* processor )
+{
+    processor->setProcessing( false );
+    component->setActive( false );
+}
+
+// fills the 32-bit input buffers of all busses with a sine
+
+void writeSine( HostProcessData& data, int32 numSamples, double sampleRate )
+{
+    uint32_t seed = 1;
+    for ( int32 bus = 0; bus < data.numInputs; ++bus ) {
+        for ( int32 c = 0; c < data.inputs[ bus ].numChannels; ++c ) {
+            for ( int32 s = 0; s < numSamples; ++s ) {
+                data.inputs[ bus ].channelBuffers32[ c ][ s ] = synthesize( "sine", s, c, sampleRate, seed );
+            }
+        }
+    }
+}
+
+/* instantiation benchmark */
+
+void reportDurations( const char* name, const std::vector<double>& durations )
+{
+    double total = 0.0;
+    for ( double duration : durations ) {
+        total += duration;
+    }
+    printf( "%-36s mean %.3f ms, median %.3f ms, max %.3f ms\n", name, total / durations.size(),
+            percentile( durations, .5 ), *std::max_element( durations.begin(), durations.end()));
+}
+
+// measures the duration of instantiating and terminating the audio effect (e.g. its controller along with
+// its processor, as hosts do when scanning) and that of instantiating it up to the completion of its first
+// process() call (e.g. when loading a session), where the latter includes the allocation of the processors
+
+int runInstantiationBenchmark( const Options& options, VST3::Hosting::PluginFactory& factory, const VST3::Hosting::ClassInfo& classInfo )
+{
+    std::vector<double> scanDurations;
+    std::vector<double> loadDurations;
+
+    ProcessSetup setup;
+    setup.processMode        = options.offline ? kOffline : kRealtime;
+    setup.symbolicSampleSize = kSample32;
+    setup.maxSamplesPerBlock = options.blockSize;
+    setup.sampleRate         = options.sampleRate;
+
+    ProcessContext context = {};
+    context.state              = ProcessContext::kPlaying | ProcessContext::kTempoValid | ProcessContext::kTimeSigValid;
+    context.sampleRate         = options.sampleRate;
+    context.tempo              = options.tempo;
+    context.timeSigNumerator   = 4;
+    context.timeSigDenominator = 4;
+
+    for ( int i = 0; i < options.instantiations; ++i ) {
+
+        // instantiate -> terminate
+
+        auto start = std::chrono::steady_clock::now();
+        IPtr<PlugProvider> provider = owned( new PlugProvider( factory, classInfo, true ));
+        if ( provider->getComponentPtr() == nullptr ) {
+            fprintf( stderr, "Could not instantiate the audio effect\n" );
+            return 1;
+        }
+        provider = nullptr;
+        auto end = std::chrono::steady_clock::now();
+
+        scanDurations.push_back( std::chrono::duration<double, std::milli>( end - start ).count());
+
+        // instantiate -> first process() (the instance is terminated after measuring)
+
+        HostProcessData data;
+
+        start = std::chrono::steady_clock::now();
+        provider = owned( new PlugProvider( factory, classInfo, true ));
+        IComponent* component = provider->getComponentPtr();
+        FUnknownPtr<IAudioProcessor> processor( component );
+
+        if ( !component || !processor || !startProcessing( component, processor, setup, data, options.blockSize )) {
+            return 1;
+        }
+        data.processContext = &context;
+
+        writeSine( data, options.blockSize, options.sampleRate );
+        processor->process( data );
+        end = std::chrono::steady_clock::now();
+
+        loadDurations.push_back( std::chrono::duration<double, std::milli>( end - start ).count());
+
+        stopProcessing( component, processor );
+        provider = nullptr;
+    }
+
+    printf( "%d instantiations\n", options.instantiations );
+    reportDurations( "instantiate -> terminate",       scanDurations );
+    reportDurations( "instantiate -> first process()", loadDurations );
+
+    return 0;
+}
+
+/* memory benchmark */
+
+struct MemoryUsage {
+    double resident = 0.0; // resident set size of the process, in bytes
+    double heap     = 0.0; // bytes allocated on the heap (glibc only, otherwise 0)
+};
+
+MemoryUsage measureMemory()
+{
+    MemoryUsage usage;
+
+    long pages    = 0;
+    long resident = 0;
+    FILE* file    = fopen( "/proc/self/statm", "r" );
+    if ( file != nullptr ) {
+        if ( fscanf( file, "%ld %ld", &pages, &resident ) == 2 ) {
+            usage.resident = ( double ) resident * ( double ) sysconf( _SC_PAGESIZE );
+        }
+        fclose( file );
+    }
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ( 2, 33 )
+    usage.heap = ( double ) mallinfo2().uordblks;
+#endif
+#endif
+    return usage;
+}
+
+void reportMemory( const char* name, double resident, double heap )
+{
+    printf( "%-36s %10.1f KB resident, %10.1f KB heap\n", name, resident / 1024.0, heap / 1024.0 );
+}
+
+// measures the memory used by each instance once it is ready to process (e.g. instantiated with
+// its buffers allocated and after processing a block), as a session with many instances would.
+// The first instance is reported separately as it includes the one-time costs shared by all instances
+// (e.g. the resources in the ResourceRegistry and the lazily initialized state of the libraries)
+
+int runMemoryBenchmark( const Options& options, VST3::Hosting::PluginFactory& factory, const VST3::Hosting::ClassInfo& classInfo )
+{
+    ProcessSetup setup;
+    setup.processMode        = options.offline ? kOffline : kRealtime;
+    setup.symbolicSampleSize = kSample32;
+    setup.maxSamplesPerBlock = options.blockSize;
+    setup.sampleRate         = options.sampleRate;
+
+    ProcessContext context = {};
+    context.state              = ProcessContext::kPlaying | ProcessContext::kTempoValid | ProcessContext::kTimeSigValid;
+    context.sampleRate         = options.sampleRate;
+    context.tempo              = options.tempo;
+    context.timeSigNumerator   = 4;
+    context.timeSigDenominator = 4;
+
+    std::vector<IPtr<PlugProvider>> providers;
+    std::vector<std::unique_ptr<HostProcessData>> datas;
+
+    MemoryUsage baseline = measureMemory();
+    MemoryUsage first;
+
+    for ( int i = 0; i < options.memoryInstances; ++i ) {
+        IPtr<PlugProvider> provider = owned( new PlugProvider( factory, classInfo, true ));
+        IComponent* component = provider->getComponentPtr();
+        FUnknownPtr<IAudioProcessor> processor( component );
+
+        std::unique_ptr<HostProcessData> data( new HostProcessData());
+
+        if ( !component || !processor || !startProcessing( component, processor, setup, *data, options.blockSize )) {
+            return 1;
+        }
+        data->processContext = &context;
+
+        writeSine( *data, options.blockSize, options.sampleRate );
+        processor->process( *data );
+
+        providers.push_back( provider );
+        datas.push_back( std::move( data ));
+
+        if ( i == 0 ) {
+            first = measureMemory();
+        }
+    }
+    MemoryUsage total = measureMemory();
+
+    for ( auto& provider : providers ) {
+        IComponent* component = provider->getComponentPtr();
+        FUnknownPtr<IAudioProcessor> processor( component );
+        stopProcessing( component, processor );
+    }
+    providers.clear();
+    datas.clear();
+
+    MemoryUsage terminated = measureMemory();
+
+    printf( "%d instances at %d samples per block (%.0f Hz)\n", options.memoryInstances, options.blockSize, options.sampleRate );
+    reportMemory( "first instance", first.resident - baseline.resident, first.heap - baseline.heap );
+
+    if ( options.memoryInstances > 1 ) {
+        double additional = options.memoryInstances - 1;
+        reportMemory( "each additional instance", ( total.resident - first.resident ) / additional,
+                      ( total.heap - first.heap ) / additional );
+    }
+    // the heap should return to its baseline (minus the shared resources) once all instances
+    // are terminated, the resident size typically does not as the allocator retains its pages
+
+    reportMemory( "retained after terminating all", terminated.resident - baseline.resident, terminated.heap - baseline.heap );
+
+    return 0;
+}
+
+/* stress test */
+
+// writes the (randomized) input of the stress test into the channels of given bus: a noisy sine
+// interspersed with non-finite (NaN, Inf), subnormal and out of range values and runs of silence
+
+template <typename SampleType>
+void writeStressInput( SampleType** channels, int32 numChannels, int32 numSamples, int64_t position,
+                       double sampleRate, std::mt19937& random )
+{
+    const SampleType SPECIAL_VALUES[] = {
+        std::numeric_limits<SampleType>::quiet_NaN(), std::numeric_limits<SampleType>::infinity(),
+       -std::numeric_limits<SampleType>::infinity(), std::numeric_limits<SampleType>::denorm_min(),
+        std::numeric_limits<SampleType>::min() / ( SampleType ) 2, ( SampleType ) 1e30, ( SampleType ) -1e30
+    };
+    const int SPECIAL_VALUE_COUNT = sizeof( SPECIAL_VALUES ) / sizeof( SampleType );
+
+    std::uniform_real_distribution<double> noise( -.25, .25 );
+    std::uniform_int_distribution<int> chance( 0, 99 );
+
+    // blocks of entirely subnormal values or silence
+
+    int blockType = chance( random );
+
+    for ( int32 c = 0; c < numChannels; ++c ) {
+        SampleType* channel = channels[ c ];
+        for ( int32 i = 0; i < numSamples; ++i ) {
+            if ( blockType < 5 ) {
+                channel[ i ] = std::numeric_limits<SampleType>::denorm_min() * ( i % 7 );
+            } else if ( blockType < 10 ) {
+                channel[ i ] = 0;
+            } else if ( chance( random ) == 0 ) {
+                channel[ i ] = SPECIAL_VALUES[ random() % SPECIAL_VALUE_COUNT ];
+            } else {
+                channel[ i ] = ( SampleType ) ( .5 * sin( 2.0 * M_PI * 110.0 * ( position + i ) / sampleRate ) + noise( random ));
+            }
+        }
+    }
+}
+
+// whether all samples in the channels of given bus are finite
+
+template <typename SampleType>
+bool isFinite( SampleType** channels, int32 numChannels, int32 numSamples )
+{
+    for ( int32 c = 0; c < numChannels; ++c ) {
+        for ( int32 i = 0; i < numSamples; ++i ) {
+            if ( !std::isfinite( channels[ c ][ i ] )) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// processes randomly sized blocks (including single samples and blocks exceeding the maximum block
+// size) with randomly aliased in- and output buffers (as some hosts process in place), randomized
+// non-finite and subnormal input and storms of parameter changes (hundreds of points per block), while
+// periodically cycling the activation and processing setup (sample rate, maximum block size and sample size).
+// Fails when the duration of any block exceeds its deadline (its duration at the sample rate) or when
+// the output is not finite, returning the exit code of the host
+
+int runStressTest( const Options& options, IComponent* component, IAudioProcessor* processor, const std::vector<ParamID>& parameters )
+{
+    const double SAMPLE_RATES[]    = { 44100.0, 48000.0, 88200.0, 96000.0 };
+    const int32 MAX_BLOCK_SIZES[]  = { 32, 64, 256, 512, 1024, 4096 };
+    const int CYCLE_BLOCKS         = 100; // maximum amount of blocks between reconfigurations
+    const int MAX_POINTS_PER_QUEUE = 64;
+
+    std::mt19937 random( options.seed );
+    auto randomInt = [ &random ]( int min, int max ) {
+        return std::uniform_int_distribution<int>( min, max )( random );
+    };
+
+    HostProcessData data;
+    ParameterChanges inputChanges( std::max<int32>( 1, ( int32 ) parameters.size()));
+    ParameterChanges outputChanges( 128 );
+
+    ProcessContext context = {};
+    context.state              = ProcessContext::kPlaying | ProcessContext::kTempoValid | ProcessContext::kTimeSigValid;
+    context.tempo              = options.tempo;
+    context.timeSigNumerator   = 4;
+    context.timeSigDenominator = 4;
+
+    std::vector<double> timings;
+    int64_t overruns       = 0;
+    int64_t nonFinite      = 0;
+    int64_t aliased        = 0;
+    int64_t oversized      = 0;
+    int64_t points         = 0;
+    int cycles             = 0;
+    double processedTime   = 0.0; // in seconds of audio
+    double worstOverrun    = 0.0; // ratio of the duration of a block to its deadline
+    bool isActive          = false;
+    ProcessSetup setup     = {};
+
+    for ( ; processedTime < options.seconds; ++cycles ) {
+
+        // cycle the activation, either with a new or the same processing setup
+
+        if ( isActive ) {
+            stopProcessing( component, processor );
+        }
+        if ( !isActive || randomInt( 0, 1 ) == 1 ) {
+            setup.processMode        = kRealtime;
+            setup.symbolicSampleSize = randomInt( 0, 1 ) == 1 ? kSample64 : kSample32;
+            setup.maxSamplesPerBlock = MAX_BLOCK_SIZES[ randomInt( 0, sizeof( MAX_BLOCK_SIZES ) / sizeof( int32 ) - 1 )];
+            setup.sampleRate         = SAMPLE_RATES[ randomInt( 0, sizeof( SAMPLE_RATES ) / sizeof( double ) - 1 )];
+
+        }
+        // the buffers hold twice the maximum block size, to provide blocks exceeding it
+        if ( !startProcessing( component, processor, setup, data, setup.maxSamplesPerBlock * 2 )) {
+            return 1;
+        }
+        isActive = true;
+
+        data.processContext         = &context;
+        data.inputParameterChanges  = &inputChanges;
+        data.outputParameterChanges = &outputChanges;
+        context.sampleRate          = setup.sampleRate;
+
+        bool isDouble = setup.symbolicSampleSize == kSample64;
+
+        for ( int block = 0, blocks = randomInt( 1, CYCLE_BLOCKS ); block < blocks; ++block ) {
+
+            // single samples, blocks exceeding the maximum block size (up to twice its size) or in between
+
+            int32 numSamples;
+            int type = randomInt( 0, 9 );
+            if ( type == 0 ) {
+                numSamples = 1;
+            } else if ( type == 1 ) {
+                numSamples = randomInt( setup.maxSamplesPerBlock + 1, setup.maxSamplesPerBlock * 2 );
+                ++oversized;
+            } else {
+                numSamples = randomInt( 1, setup.maxSamplesPerBlock );
+            }
+            data.numSamples = numSamples;
+
+            int64_t position = ( int64_t ) ( processedTime * setup.sampleRate );
+
+            for ( int32 bus = 0; bus < data.numInputs; ++bus ) {
+                AudioBusBuffers& buffers = data.inputs[ bus ];
+                if ( isDouble ) {
+                    writeStressInput( buffers.channelBuffers64, buffers.numChannels, numSamples, position, setup.sampleRate, random );
+                } else {
+                    writeStressInput( buffers.channelBuffers32, buffers.numChannels, numSamples, position, setup.sampleRate, random );
+                }
+                buffers.silenceFlags = 0;
+            }
+
+            // process in place (the main output reuses the main input buffers), the host owned
+            // output buffers are restored after processing
+
+            bool isAliased = randomInt( 0, 3 ) == 0 && data.numInputs > 0 && data.numOutputs > 0;
+            void* outputBuffers[ 64 ] = {};
+            int32 numAliased = 0;
+
+            if ( isAliased ) {
+                AudioBusBuffers& in  = data.inputs[ 0 ];
+                AudioBusBuffers& out = data.outputs[ 0 ];
+                numAliased = std::min( std::min( in.numChannels, out.numChannels ), ( int32 ) 64 );
+
+                for ( int32 c = 0; c < numAliased; ++c ) {
+                    if ( isDouble ) {
+                        outputBuffers[ c ] = out.channelBuffers64[ c ];
+                        out.channelBuffers64[ c ] = in.channelBuffers64[ c ];
+                    } else {
+                        outputBuffers[ c ] = out.channelBuffers32[ c ];
+                        out.channelBuffers32[ c ] = in.channelBuffers32[ c ];
+                    }
+                }
+                ++aliased;
+            }
+
+            // a storm of changes for each parameter, at ascending (possibly coinciding) offsets
+
+            inputChanges.clearQueue();
+            outputChanges.clearQueue();
+
+            for ( ParamID id : parameters ) {
+                int32 queueIndex, pointIndex;
+                IParamValueQueue* queue = inputChanges.addParameterData( id, queueIndex );
+                if ( queue == nullptr ) {
+                    continue;
+                }
+                for ( int p = 0, l = randomInt( 1, MAX_POINTS_PER_QUEUE ); p < l; ++p ) {
+                    int32 offset = ( int32 ) (( int64_t ) numSamples * p / l );
+                    queue->addPoint( offset, randomInt( 0, 1000 ) / 1000.0, pointIndex );
+                }
+                points += queue->getPointCount();
+            }
+
+            context.projectTimeSamples = position;
+            context.projectTimeMusic   = position * options.tempo / ( 60.0 * setup.sampleRate );
+
+            auto start = std::chrono::steady_clock::now();
+            processor->process( data );
+            auto end = std::chrono::steady_clock::now();
+
+            double duration = std::chrono::duration<double, std::micro>( end - start ).count();
+            double deadline = 1e6 * numSamples / setup.sampleRate;
+
+            timings.push_back( duration );
+            worstOverrun = std::max( worstOverrun, duration / deadline );
+            if ( duration > deadline ) {
+                ++overruns;
+                fprintf( stderr, "block of %d samples at %.0f Hz took %.2f us, exceeding its deadline of %.2f us\n",
+                         numSamples, setup.sampleRate, duration, deadline );
+            }
+
+            for ( int32 bus = 0; bus < data.numOutputs; ++bus ) {
+                AudioBusBuffers& buffers = data.outputs[ bus ];
+                bool finite = isDouble ? isFinite( buffers.channelBuffers64, buffers.numChannels, numSamples )
+                                       : isFinite( buffers.channelBuffers32, buffers.numChannels, numSamples );
+                if ( !finite ) {
+                    ++nonFinite;
+                }
+            }
+
+            for ( int32 c = 0; c < numAliased; ++c ) {
+                if ( isDouble ) {
+                    data.outputs[ 0 ].channelBuffers64[ c ] = ( Sample64* ) outputBuffers[ c ];
+                } else {
+                    data.outputs[ 0 ].channelBuffers32[ c ] = ( Sample32* ) outputBuffers[ c ];
+                }
+            }
+            processedTime += numSamples / setup.sampleRate;
+        }
+    }
+
+    if ( isActive ) {
+        stopProcessing( component, processor );
+    }
+
+    // report
+
+    printf( "%zu blocks in %d activation cycles (%lld exceeding the maximum block size, %lld processed in place), %lld parameter changes\n",
+            timings.size(), cycles, ( long long ) oversized, ( long long ) aliased, ( long long ) points );
+    printf( "max %.2f us, p99.9 %.2f us, p99 %.2f us, worst block at %.1f %% of its deadline\n",
+            *std::max_element( timings.begin(), timings.end()), percentile( timings, .999 ), percentile( timings, .99 ), 100.0 * worstOverrun );
+
+    bool passed = overruns == 0 && nonFinite == 0;
+    if ( overruns > 0 ) {
+        printf( "FAILED: %lld blocks exceeded their deadline\n", ( long long ) overruns );
+    }
+    if ( nonFinite > 0 ) {
+        printf( "FAILED: %lld blocks output non-finite values\n", ( long long ) nonFinite );
+    }
+    if ( passed ) {
+        printf( "passed\n" );
+    }
+    return passed ? 0 : 1;
+}
+
+}
+
+int main( int argc, char* argv[] )
+{
+    Options options;
+    if ( !parseOptions( argc, argv, options )) {
+        fprintf( stderr, "usage: %s [--input sine|noise|silence|fade|file.wav] [--seconds S] [--block N] [--rate HZ] [--tempo BPM] "
+                         "[--offline] [--sidechain] [--automation file] [--automate-all] [--warmup N] [--csv file] [--segments N] "
+                         "[--instances N] [--counters] "
+                         "[--instantiate N] [--memory N] [--stress] [--seed N] plugin.vst3\n", argv[ 0 ]);
+        return 1;
+    }
+
+    Audio fileInput;
+    bool isSynthesized = options.input == "sine" || options.input == "noise" || options.input == "silence" || options.input == "fade";
+    if ( !isSynthesized && !readWav( options.input, fileInput )) {
+        fprintf( stderr, "Could not read \"%s\" (16-bit PCM and 32-bit floating point WAV files are supported)\n", options.input.c_str());
+        return 1;
+    }
+
+    std::vector<AutomationPoint> automation;
+    if ( !options.automation.empty() && !readAutomation( options.automation, automation )) {
+        fprintf( stderr, "Could not read automation \"%s\"\n", options.automation.c_str());
+        return 1;
+    }
+
+    // load the module and instantiate the requested audio effect class
+
+    HostApplication hostApplication;
+    PluginContextFactory::instance().setPluginContext( &hostApplication );
+
+    std::string error;
+    VST3::Hosting::Module::Ptr module = VST3::Hosting::Module::create( options.plugin, error );
+    if ( !module ) {
+        fprintf( stderr, "Could not load \"%s\": %s\n", options.plugin.c_str(), error.c_str());
+        return 1;
+    }
+
+    VST3::Hosting::PluginFactory factory = module->getFactory();
+    VST3::Hosting::ClassInfo classInfo;
+    IPtr<PlugProvider> provider;
+
+    if ( findEffectClass( factory, options.sideChain, classInfo )) {
+        printf( "Benchmarking \"%s\"\n", classInfo.name().c_str());
+
+        if ( options.instantiations > 0 || options.memoryInstances > 0 ) {
+            int result = options.instantiations > 0 ? runInstantiationBenchmark( options, factory, classInfo )
+                                                    : runMemoryBenchmark( options, factory, classInfo );
+
+            module = nullptr;
+            PluginContextFactory::instance().setPluginContext( nullptr );
+
+            return result;
+        }
+        provider = owned( new PlugProvider( factory, classInfo, true ));
+    }
+
+    IComponent* component = provider ? provider->getComponentPtr() : nullptr;
+    IEditController* controller = provider ? provider->getControllerPtr() : nullptr;
+    FUnknownPtr<IAudioProcessor> processor( component );
+
+    if ( !component || !processor ) {
+        fprintf( stderr, "Could not instantiate the audio effect\n" );
+        return 1;
+    }
+
+    // the parameters to automate when automating all (or stress testing)
+
+    std::vector<ParamID> parameters;
+    if (( options.automateAll || options.stress ) && controller != nullptr ) {
+        for ( int32 i = 0, l = controller->getParameterCount(); i < l; ++i ) {
+            ParameterInfo info;
+            if ( controller->getParameterInfo( i, info ) == kResultOk &&
+                ( info.flags & ParameterInfo::kCanAutomate ) &&
+               !( info.flags & ( ParameterInfo::kIsBypass | ParameterInfo::kIsProgramChange | ParameterInfo::kIsReadOnly ))) {
+                parameters.push_back( info.id );
+            }
+        }
+    }
+
+    if ( options.stress ) {
+        int result = runStressTest( options, component, processor, parameters );
+
+        provider = nullptr;
+        module   = nullptr;
+        PluginContextFactory::instance().setPluginContext( nullptr );
+
+        return result;
+    }
+
+    // prepare the processing
+
+    ProcessSetup setup;
+    setup.processMode        = options.offline ? kOffline : kRealtime;
+    setup.symbolicSampleSize = kSample32;
+    setup.maxSamplesPerBlock = options.blockSize;
+    setup.sampleRate         = options.sampleRate;
+
+    HostProcessData data;
+    if ( !startProcessing( component, processor, setup, data, options.blockSize )) {
+        return 1;
+    }
+
+    ParameterChanges inputChanges( std::max<int32>( 1, ( int32 ) parameters.size() + 8 ));
+    ParameterChanges outputChanges( controller != nullptr ? controller->getParameterCount() : 8 );
+
+    ProcessContext context = {};
+    context.state              = ProcessContext::kPlaying | ProcessContext::kTempoValid | ProcessContext::kTimeSigValid;
+    context.sampleRate         = options.sampleRate;
+    context.tempo              = options.tempo;
+    context.timeSigNumerator   = 4;
+    context.timeSigDenominator = 4;
+
+    data.processContext         = &context;
+    data.inputParameterChanges  = &inputChanges;
+    data.outputParameterChanges = &outputChanges;
+
+    // the additional instances, each block is processed by all instances in turn (as a host processes
+    // the tracks of a session), meaning their working sets compete for the caches and the TLB
+
+    std::vector<Instance> instances( options.instances - 1 );
+    for ( Instance& instance : instances ) {
+        instance.provider  = owned( new PlugProvider( factory, classInfo, true ));
+        instance.component = instance.provider->getComponentPtr();
+        instance.processor = FUnknownPtr<IAudioProcessor>( instance.component );
+        instance.data.reset( new HostProcessData());
+
+        if ( !instance.component || !instance.processor ||
+             !startProcessing( instance.component, instance.processor, setup, *instance.data, options.blockSize )) {
+            return 1;
+        }
+        instance.data->processContext         = &context;
+        instance.data->inputParameterChanges  = &inputChanges;
+        instance.data->outputParameterChanges = &outputChanges;
+    }
+
+    PerfCounters counters;
+    if ( options.counters && !counters.isAvailable()) {
+        fprintf( stderr, "Hardware counters are not available (see /proc/sys/kernel/perf_event_paranoid)\n" );
+    }
+
+    // process
+
+    int64_t totalSamples = ( int64_t ) ( options.seconds * options.sampleRate );
+    int64_t totalBlocks  = std::max<int64_t>( 1, totalSamples / options.blockSize );
+    size_t automationIndex = 0;
+    uint32_t seed = 1;
+
+    std::vector<double> timings;
+    timings.reserve( totalBlocks );
+
+    for ( int64_t block = -options.warmupBlocks; block < totalBlocks; ++block ) {
+        int64_t position = std::max<int64_t>( 0, block ) * options.blockSize;
+
+        // input (the sidechain bus is fed a signal gated at the beat)
+
+        for ( int32 bus = 0; bus < data.numInputs; ++bus ) {
+            AudioBusBuffers& buffers = data.inputs[ bus ];
+            bool isSilent = true;
+
+            for ( int32 c = 0; c < buffers.numChannels; ++c ) {
+                float* channel = buffers.channelBuffers32[ c ];
+                for ( int32 i = 0; i < options.blockSize; ++i ) {
+                    int64_t frame = position + i;
+                    float sample;
+                    if ( bus > 0 ) {
+                        double beat = frame * options.tempo / ( 60.0 * options.sampleRate );
+                        sample = ( beat - floor( beat )) < .25 ? .8f * ( float ) sin( 2.0 * M_PI * 60.0 * frame / options.sampleRate ) : 0.f;
+                    } else if ( fileInput.length > 0 ) {
+                        sample = fileInput.channels[ c % fileInput.channels.size() ][ frame % fileInput.length ];
+                    } else {
+                        sample = synthesize( options.input, frame, c, options.sampleRate, seed );
+                    }
+                    channel[ i ] = sample;
+                    isSilent = isSilent && sample == 0.f;
+                }
+            }
+            buffers.silenceFlags = isSilent ? (( uint64 ) 1 << buffers.numChannels ) - 1 : 0;
+
+            for ( Instance& instance : instances ) {
+                AudioBusBuffers& instanceBuffers = instance.data->inputs[ bus ];
+                for ( int32 c = 0; c < buffers.numChannels; ++c ) {
+                    memcpy( instanceBuffers.channelBuffers32[ c ], buffers.channelBuffers32[ c ], options.blockSize * sizeof( float ));
+                }
+                instanceBuffers.silenceFlags = buffers.silenceFlags;
+            }
+        }
+
+        // automation
+
+        inputChanges.clearQueue();
+        outputChanges.clearQueue();
+
+        double blockEnd = ( double ) ( position + options.blockSize ) / options.sampleRate;
+        for ( ; automationIndex < automation.size() && automation[ automationIndex ].seconds < blockEnd; ++automationIndex ) {
+            const AutomationPoint& point = automation[ automationIndex ];
+            int32 queueIndex, pointIndex;
+            int32 offset = std::max<int32>( 0, ( int32 ) ( point.seconds * options.sampleRate - position ));
+
+            IParamValueQueue* queue = inputChanges.addParameterData( point.id, queueIndex );
+            if ( queue != nullptr ) {
+                queue->addPoint( std::min( offset, options.blockSize - 1 ), point.value, pointIndex );
+            }
+        }
+        for ( size_t p = 0; p < parameters.size(); ++p ) {
+            // a triangle wave of a different period for each parameter
+            double phase = fmod(( double ) position / options.sampleRate / ( 1.0 + p * .25 ), 1.0 );
+            int32 queueIndex, pointIndex;
+
+            IParamValueQueue* queue = inputChanges.addParameterData( parameters[ p ], queueIndex );
+            if ( queue != nullptr ) {
+                queue->addPoint( 0, phase < .5 ? phase * 2.0 : 2.0 - phase * 2.0, pointIndex );
+            }
+        }
+
+        context.projectTimeSamples = position;
+        context.projectTimeMusic   = position * options.tempo / ( 60.0 * options.sampleRate );
+
+        // the counters only run within the measured process() calls
+
+        bool isCounting = options.counters && block >= 0;
+        double duration = 0.0;
+
+        for ( size_t i = 0; i <= instances.size(); ++i ) {
+            IAudioProcessor* instanceProcessor = i == 0 ? processor.get() : instances[ i - 1 ].processor.get();
+            HostProcessData& instanceData      = i == 0 ? data : *instances[ i - 1 ].data;
+
+            outputChanges.clearQueue();
+
+            if ( isCounting ) {
+                counters.start();
+            }
+            auto start = std::chrono::steady_clock::now();
+            instanceProcessor->process( instanceData );
+            auto end = std::chrono::steady_clock::now();
+
+            if ( isCounting ) {
+                counters.stop();
+            }
+            duration += std::chrono::duration<double, std::micro>( end - start ).count();
+        }
+
+        if ( block >= 0 ) {
+            timings.push_back( duration );
+        }
+    }
+
+    stopProcessing( component, processor );
+    for ( Instance& instance : instances ) {
+        stopProcessing( instance.component, instance.processor );
+    }
+
+    // report
+
+    double blockDuration = 1e6 * options.blockSize / options.sampleRate; // in microseconds
+    double total = 0.0;
+    for ( double timing : timings ) {
+        total += timing;
+    }
+    double mean = total / timings.size();
+
+    printf( "%zu blocks of %d samples at %.0f Hz (%.1f us of audio per block)\n", timings.size(), options.blockSize, options.sampleRate, blockDuration );
+    printf( "mean %.2f us, median %.2f us, p99 %.2f us, max %.2f us\n",
+            mean, percentile( timings, .5 ), percentile( timings, .99 ), *std::max_element( timings.begin(), timings.end()));
+    printf( "CPU load %.2f %% of realtime\n", 100.0 * mean / blockDuration );
+
+    if ( options.instances > 1 ) {
+        printf( "each block is processed by %d instances (the above includes all), mean %.2f us per instance\n",
+                options.instances, mean / options.instances );
+    }
+
+    if ( options.counters && counters.isAvailable()) {
+        uint64_t values[ PerfCounters::COUNT ];
+        counters.read( values );
+
+        double calls = ( double ) timings.size() * options.instances;
+        printf( "per process() call:\n" );
+        for ( int i = 0; i < PerfCounters::COUNT; ++i ) {
+            if ( counters.isAvailable( i )) {
+                printf( "  %-20s %12.1f\n", PerfCounters::name( i ), values[ i ] / calls );
+            } else {
+                printf( "  %-20s %12s\n", PerfCounters::name( i ), "n/a" );
+            }
+        }
+    }
+
+    // the load over the course of the run (e.g. while fading to silence, where it should remain flat)
+
+    int segments = options.segments > 0 ? options.segments : ( options.input == "fade" ? 10 : 0 );
+    segments = std::min( segments, ( int ) timings.size());
+
+    if ( segments > 0 ) {
+        double firstLoad = 0.0, maxLoad = 0.0;
+
+        for ( int i = 0; i < segments; ++i ) {
+            size_t first = timings.size() * i / segments;
+            size_t last  = timings.size() * ( i + 1 ) / segments;
+            double sum   = 0.0;
+            for ( size_t b = first; b < last; ++b ) {
+                sum += timings[ b ];
+            }
+            double load = 100.0 * sum / ( last - first ) / blockDuration;
+            if ( i == 0 ) {
+                firstLoad = load;
+            }
+            maxLoad = std::max( maxLoad, load );
+
+            printf( "  %6.2f - %6.2f s  CPU load %.2f %%\n", first * blockDuration / 1e6, last * blockDuration / 1e6, load );
+        }
+        printf( "peak segment load is %.2fx that of the first segment\n", maxLoad / firstLoad );
+    }
+
+    if ( !options.csv.empty()) {
+        std::ofstream csv( options.csv );
+        csv << "block,microseconds\n";
+        for ( size_t i = 0; i < timings.size(); ++i ) {
+            csv << i << "," << timings[ i ] << "\n";
+        }
+    }
+
+    instances.clear();
+    provider = nullptr;
+    module   = nullptr;
+    PluginContextFactory::instance().setPluginContext( nullptr );
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __ANALYSISRING_H_INCLUDED__
+#define __ANALYSISRING_H_INCLUDED__
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string.h>
+#include <vector>
+
+namespace Igorski {
+
+/**
+ * AnalysisRing provides the UI thread with the most recent output of the audio
+ * thread (e.g. for spectrum analysis or an oscilloscope).
+ *
+ * The audio thread mixes its output down to mono, decimating it by an integer factor, and
+ * publishes each block with a single (two segment) bulk copy into a lock-free ring.
+ * The UI thread copies the most recent window out of the ring and discards it when the
+ * writer has overwritten it in the meantime. Nothing is written while the ring is disabled
+ * (e.g. while the editor is closed).
+ *
+ * SIZE must be a power of two.
+ */
+template <uint32_t SIZE>
+class AnalysisRing {
+
+    static_assert(( SIZE & ( SIZE - 1 )) == 0, "AnalysisRing SIZE must be a power of two" );
+
+    public:
+        // configuration, should not be invoked from the audio thread
+
+        void prepare( int maxBufferSize, float sampleRate )
+        {
+            // keep the analysed bandwidth around 20 kHz at higher sample rates
+
+            // the ring is allocated once, its location is shared with the reading thread
+
+            if ( _samples.empty()) {
+                _samples.resize( SIZE, 0.f );
+            }
+            _decimation = std::max( 1, ( int ) ( sampleRate / 48000.f ));
+            _sampleRate = sampleRate / _decimation;
+            _decimationPhase = 0;
+            _block.resize( maxBufferSize / _decimation + 1 );
+        }
+
+        // sample rate of the signal in the ring (e.g. after decimation)
+
+        float getSampleRate() const { return _sampleRate; }
+
+        void setEnabled( bool enabled )
+        {
+            _enabled.store( enabled, std::memory_order_release );
+        }
+
+        bool isEnabled() const
+        {
+            return _enabled.load( std::memory_order_relaxed );
+        }
+
+        // invoked by the audio thread only
+
+        template <typename SampleType>
+        void write( SampleType** channels, int numChannels, int bufferSize )
+        {
+            if ( !isEnabled() || numChannels == 0 || _samples.empty() || _block.empty()) {
+                return;
+            }
+
+            // mix down and decimate into the block buffer
+
+            float scale = 1.f / ( float ) numChannels;
+            uint32_t count = 0;
+
+            for ( int i = _decimationPhase; i < bufferSize; i += _decimation ) {
+                float sample = 0.f;
+                for ( int c = 0; c < numChannels; ++c ) {
+                    sample += ( float ) channels[ c ][ i ];
+                }
+                _block[ count ] = sample * scale;
+
+                if ( ++count == _block.size()) {
+                    break;
+                }
+            }
+            _decimationPhase = ( _decimationPhase + ( int ) count * _decimation ) - bufferSize;
+            _decimationPhase = std::max( 0, std::min( _decimationPhase, _decimation - 1 ));
+
+            writeSamples( _block.data(), count );
+        }
+
+        // invoked by the reading thread only: copy the most recent count samples into given buffer
+        // returns false when not enough samples have been written yet, when no new samples have been
+        // written since the previous read or when the writer overwrote the window during the copy
+
+        bool readLatest( float* buffer, uint32_t count )
+        {
+            uint32_t write = _writeIndex.load( std::memory_order_acquire );
+
+            if ( count > SIZE / 2 || write < count || write == _lastRead || _samples.empty()) {
+                return false;
+            }
+
+            uint32_t start = write - count;
+            uint32_t position = start & MASK;
+            uint32_t first = std::min( count, SIZE - position );
+
+            memcpy( buffer, &_samples[ position ], first * sizeof( float ));
+            memcpy( buffer + first, &_samples[ 0 ], ( count - first ) * sizeof( float ));
+
+            // validate the writer has not wrapped into the copied window
+
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( _writeIndex.load( std::memory_order_relaxed ) - start > SIZE ) {
+                return false;
+            }
+            _lastRead = write;
+
+            return true;
+        }
+
+    private:
+        static const uint32_t MASK = SIZE - 1;
+
+        void writeSamples( const float* samples, uint32_t count )
+        {
+            uint32_t write    = _writeIndex.load( std::memory_order_relaxed );
+            uint32_t position = write & MASK;
+            uint32_t first    = std::min( count, SIZE - position );
+
+            memcpy( &_samples[ position ], samples, first * sizeof( float ));
+            memcpy( &_samples[ 0 ], samples + first, ( count - first ) * sizeof( float ));
+
+            _writeIndex.store( write + count, std::memory_order_release );
+        }
+
+        std::vector<float> _samples; // SIZE, allocated in prepare()
+        std::vector<float> _block;
+        int _decimation      = 1;
+        int _decimationPhase = 0;
+        float _sampleRate    = 44100.f;
+
+        std::atomic<bool> _enabled { false };
+        alignas( 64 ) std::atomic<uint32_t> _writeIndex { 0 };
+        alignas( 64 ) uint32_t _lastRead = 0;
+};
+
+// the ring used to share the plugins output with the controller
+
+static const uint32_t ANALYSIS_RING_SIZE = 8192;
+typedef AnalysisRing<ANALYSIS_RING_SIZE> OutputAnalysisRing;
+
+}
+
+#endif
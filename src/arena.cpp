@@ -0,0 +1,64 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "arena.h"
+#include <cstdint>
+
+namespace Igorski {
+
+Arena::Arena( size_t capacity )
+{
+    _capacity = alignSize( capacity );
+    _used     = 0;
+
+    // over allocate so the start of the memory can be aligned
+
+    _block  = new char[ _capacity + ALIGNMENT ];
+    _memory = _block + (( ALIGNMENT - (( uintptr_t ) _block % ALIGNMENT )) % ALIGNMENT );
+}
+
+Arena::~Arena()
+{
+    while ( !_destructors.empty()) {
+        Destructor& destructor = _destructors.back();
+        destructor.destroy( destructor.object );
+        _destructors.pop_back();
+    }
+    delete[] _block;
+}
+
+/* private methods */
+
+void* Arena::allocate( size_t size )
+{
+    size_t alignedSize = alignSize( size );
+
+    if ( _used + alignedSize > _capacity ) {
+        return nullptr;
+    }
+    void* memory = _memory + _used;
+    _used += alignedSize;
+
+    return memory;
+}
+
+}
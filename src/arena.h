@@ -0,0 +1,114 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __ARENA_H_INCLUDED__
+#define __ARENA_H_INCLUDED__
+
+#include <cstddef>
+#include <new>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Igorski {
+
+/**
+ * An Arena is a single, up front allocated block of memory in which objects and buffers are
+ * created consecutively (e.g. all processors and buffers of a plugin instance). Each allocation
+ * is aligned to a cache line. Objects are destroyed (in reverse order of creation) and the block
+ * is freed when the Arena is destroyed, individual allocations can not be freed.
+ *
+ * The capacity should be calculated up front using alignSize() for each allocation.
+ * Allocating beyond the capacity returns nullptr.
+ */
+class Arena {
+
+    public:
+        static const size_t ALIGNMENT = 64; // in bytes
+
+        Arena( size_t capacity );
+        ~Arena();
+
+        Arena( const Arena& ) = delete;
+        Arena& operator=( const Arena& ) = delete;
+
+        // the size an allocation of given size occupies within the arena
+
+        static constexpr size_t alignSize( size_t size )
+        {
+            return ( size + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+        }
+
+        // create an instance of T within the arena
+
+        template <typename T, typename... Args>
+        T* create( Args&&... args )
+        {
+            void* memory = allocate( sizeof( T ));
+            if ( memory == nullptr ) {
+                return nullptr;
+            }
+            T* object = new ( memory ) T( std::forward<Args>( args )... );
+
+            if ( !std::is_trivially_destructible<T>::value ) {
+                _destructors.push_back({ object, []( void* instance ) { static_cast<T*>( instance )->~T(); } });
+            }
+            return object;
+        }
+
+        // allocate a zeroed array of given length (for trivial types such as samples or pointers)
+
+        template <typename T>
+        T* allocateArray( size_t length )
+        {
+            static_assert( std::is_trivial<T>::value, "Arena::allocateArray() is for trivial types only" );
+
+            void* memory = allocate( sizeof( T ) * length );
+            if ( memory != nullptr ) {
+                memset( memory, 0, sizeof( T ) * length );
+            }
+            return static_cast<T*>( memory );
+        }
+
+        size_t getCapacity() const { return _capacity; }
+        size_t getUsed() const { return _used; }
+
+    private:
+        struct Destructor {
+            void* object;
+            void ( *destroy )( void* object );
+        };
+
+        char* _block;  // as allocated
+        char* _memory; // _block aligned to ALIGNMENT
+        size_t _capacity;
+        size_t _used;
+
+        std::vector<Destructor> _destructors;
+
+        void* allocate( size_t size );
+};
+
+}
+
+#endif
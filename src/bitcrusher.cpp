@@ -25,6 +25,7 @@
 #include "calc.h"
 #include <limits.h>
 #include <math.h>
+#include <string.h>
 
 namespace Igorski {
 
@@ -32,19 +33,31 @@ namespace Igorski {
 
 BitCrusher::BitCrusher( float amount, float inputMix, float outputMix )
 {
+    hasLFO = false;
+
+    // ensure all state read by the setters is initialized
+
+    _amount     = amount;
+    _tempAmount = amount;
+    _lfoDepth   = 0.f;
+
+    _modulation      = nullptr;
+    _modulationDepth = 0.f;
+    _isModulated     = false;
+    _isActive        = false;
+    _antiAliasing    = AntiAliasing::NONE;
+    _channelHistory  = _history[ 0 ];
+
+    memset( _history, 0, sizeof( _history ));
+
     setAmount   ( amount );
     setInputMix ( inputMix );
     setOutputMix( outputMix );
-
-    _tempAmount = _amount;
-
-    lfo = new LFO();
-    hasLFO = false;
 }
 
 BitCrusher::~BitCrusher()
 {
-    delete lfo;
+
 }
 
 /* public methods */
@@ -59,7 +72,7 @@ void BitCrusher::setLFO( float LFORatePercentage, float LFODepth )
     bool hadChange = ( wasEnabled != enabled ) || _lfoDepth != LFODepth;
 
     if ( enabled )
-        lfo->setRate(
+        lfo.setRate(
             VST::MIN_LFO_RATE() + (
                 LFORatePercentage * ( VST::MAX_LFO_RATE() - VST::MIN_LFO_RATE() )
             )
@@ -77,31 +90,53 @@ void BitCrusher::setLFO( float LFORatePercentage, float LFODepth )
     }
 }
 
+void BitCrusher::setSampleRate( float sampleRate )
+{
+    lfo.setSampleRate( sampleRate );
+}
+
 void BitCrusher::process( float* inBuffer, int bufferSize )
 {
-    // sound should not be crushed ? do nothing
-    if ( _bits == 16 && !hasLFO )
+    process( inBuffer, bufferSize, nullptr, 0.f );
+}
+
+void BitCrusher::process( float* inBuffer, int bufferSize, const float* modulation, float depth )
+{
+    begin( modulation, depth );
+
+    if ( !_isActive && _antiAliasing == AntiAliasing::NONE )
         return;
 
-    int bitsPlusOne = _bits + 1;
+    for ( int i = 0; i < bufferSize; ++i ) {
+        inBuffer[ i ] = tick( inBuffer[ i ], i );
+    }
+}
 
-    for ( int i = 0; i < bufferSize; ++i )
-    {
-        short input = ( short ) (( inBuffer[ i ] * _inputMix ) * SHRT_MAX );
-        short prevent_offset = ( short )( -1 >> bitsPlusOne );
-        input &= ( -1 << ( 16 - _bits ));
-        inBuffer[ i ] = (( input + prevent_offset ) * _outputMix ) / SHRT_MAX;
-
-        if ( hasLFO ) {
-            // multiply by .5 and add .5 to make the LFO's bipolar waveform unipolar
-            float lfoValue = lfo->peek() * .5f  + .5f;
-            _tempAmount = std::min( _lfoMax, _lfoMin + _lfoRange * lfoValue );
-
-            // recalculate the current resolution
-            calcBits();
-            bitsPlusOne = _bits + 1;
-        }
+void BitCrusher::begin( const float* modulation, float depth, int channel )
+{
+    _channelHistory  = _history[ std::min( channel, MAX_CHANNELS - 1 ) ];
+    dither.begin( channel );
+    _isModulated     = modulation != nullptr && depth > 0.f;
+    _modulation      = modulation;
+    _modulationDepth = depth;
+
+    // restore the resolution after modulation has ended
+    if ( !_isModulated && !hasLFO && _tempAmount != _amount ) {
+        _tempAmount = _amount;
+        calcBits();
     }
+    _isActive = _bits < 16 || hasLFO || _isModulated;
+}
+
+void BitCrusher::reset()
+{
+    lfo.reset();
+
+    _tempAmount = _amount;
+    calcBits();
+
+    memset( _history, 0, sizeof( _history ));
+    dither.reset();
 }
 
 /* setters */
@@ -130,8 +165,138 @@ void BitCrusher::setOutputMix( float value )
     _outputMix = Calc::cap( value );
 }
 
+void BitCrusher::setAntiAliasing( AntiAliasing mode )
+{
+    // the history is not retained while anti-aliasing is disabled, seed it with silence
+
+    if ( _antiAliasing == AntiAliasing::NONE && mode != AntiAliasing::NONE ) {
+        memset( _history, 0, sizeof( _history ));
+    }
+    _antiAliasing = mode;
+}
+
+void BitCrusher::setDither( Dither::Mode mode )
+{
+    dither.setMode( mode );
+}
+
 /* private methods */
 
+float BitCrusher::quantizeDithered( float sample )
+{
+    // as the plain quantizer in tick(), adding the dither noise (and optionally shaping
+    // the quantization error) prior to quantization
+
+    int mask   = ( int ) ( ~0u << ( 16 - _bits ));
+    float step = ( float ) ( 1 << ( 16 - _bits ));
+
+    float input    = dither.shape( Calc::capSample( sample ) * _inputMix * SHRT_MAX );
+    float dithered = std::min(( float ) SHRT_MAX, std::max(( float ) SHRT_MIN, input + dither.next() * step ));
+
+    short quantized      = ( short ) dithered;
+    short prevent_offset = ( short )( -1 >> ( _bits + 1 ));
+    quantized &= mask;
+
+    dither.feedback( quantized, step );
+
+    return (( quantized + prevent_offset ) * _outputMix ) / SHRT_MAX;
+}
+
+/**
+ * The quantizer as a function of the input sample: a staircase with steps of given height
+ * and width (e.g. the input mix scales the width) for input within the -1 to +1 range,
+ * continuing at the outermost step for input beyond this range, along with its first
+ * and second antiderivative. Evaluated in double precision as the antiderivatives are
+ * differenced over (very) small intervals.
+ */
+struct Staircase {
+    double height;
+    double width;
+
+    inline double f( double x ) const
+    {
+        return height * floor( std::min( 1., std::max( -1., x )) / width );
+    }
+
+    inline double F( double x ) const
+    {
+        if ( x > 1. )  return F( 1. )  + f( 1. )  * ( x - 1. );
+        if ( x < -1. ) return F( -1. ) + f( -1. ) * ( x + 1. );
+
+        double k = floor( x / width );
+        double r = x - k * width;
+
+        return height * width * k * ( k - 1. ) / 2. + height * k * r;
+    }
+
+    inline double G( double x ) const
+    {
+        if ( x > 1. )  return G( 1. )  + F( 1. )  * ( x - 1. ) + f( 1. )  * ( x - 1. ) * ( x - 1. ) / 2.;
+        if ( x < -1. ) return G( -1. ) + F( -1. ) * ( x + 1. ) + f( -1. ) * ( x + 1. ) * ( x + 1. ) / 2.;
+
+        double k = floor( x / width );
+        double r = x - k * width;
+
+        return height * width * width * ( k - 1. ) * k * ( 2. * k - 1. ) / 12. +
+               height * width * k * ( k - 1. ) / 2. * r + height * k * r * r / 2.;
+    }
+};
+
+static const double ADAA_EPSILON = 1e-6; // below which the difference between samples is considered ill-conditioned
+
+float BitCrusher::quantizeAntiAliased( float sample )
+{
+    // the step size of the current resolution, note the staircase is recreated for each sample as the resolution
+    // can change per sample, as such the antiderivatives of the previous samples are not cached
+
+    double height = ( double ) ( 1 << ( 16 - _bits )) / SHRT_MAX;
+    double offset = -1. / SHRT_MAX; // see tick()
+
+    float* history = _channelHistory;
+    double x  = sample;
+    double x1 = history[ 0 ];
+    double y;
+
+    if ( _inputMix <= 0.f ) {
+        y = 0.;
+    } else {
+        Staircase stairs = { height, height / _inputMix };
+
+        // the dither noise is added to the input of the (anti-aliased) quantizer
+
+        if ( dither.getMode() != Dither::Mode::NONE ) {
+            x += dither.next() * stairs.width;
+        }
+
+        if ( _antiAliasing == AntiAliasing::FIRST_ORDER ) {
+            double delta = x - x1;
+            y = fabs( delta ) < ADAA_EPSILON ? stairs.f(( x + x1 ) / 2. ) : ( stairs.F( x ) - stairs.F( x1 )) / delta;
+        } else {
+            double x2 = history[ 1 ];
+
+            // first divided difference of the second antiderivative
+
+            auto difference = [ &stairs ]( double a, double b ) {
+                return fabs( a - b ) < ADAA_EPSILON ? stairs.F(( a + b ) / 2. ) : ( stairs.G( a ) - stairs.G( b )) / ( a - b );
+            };
+
+            if ( fabs( x - x2 ) < ADAA_EPSILON ) {
+                double average = ( x + x2 ) / 2.;
+                double delta   = average - x1;
+
+                y = fabs( delta ) < ADAA_EPSILON ? stairs.f(( average + x1 ) / 2. ) :
+                    2. / delta * ( stairs.F( average ) + ( stairs.G( x1 ) - stairs.G( average )) / delta );
+            } else {
+                y = 2. / ( x - x2 ) * ( difference( x, x1 ) - difference( x1, x2 ));
+            }
+            history[ 1 ] = history[ 0 ];
+        }
+    }
+    history[ 0 ] = ( float ) x;
+
+    return ( float ) (( y + offset ) * _outputMix );
+}
+
 void BitCrusher::cacheLFO()
 {
     _lfoRange = ( float ) _amount * _lfoDepth;
@@ -24,22 +24,126 @@
 #define __BITCRUSHER_H_INCLUDED__
 
 #include "lfo.h"
+#include "dither.h"
+#include "calc.h"
+#include <algorithm>
+#include <limits.h>
 
 namespace Igorski {
 class BitCrusher {
 
     public:
+        static constexpr int MAX_CHANNELS = 8;
+
+        // the quantizer is discontinuous and as such aliases, antiderivative anti-aliasing (ADAA) suppresses
+        // the aliasing at a fraction of the cost of oversampling. NONE applies the plain quantizer, FIRST_ORDER
+        // adds half a sample of latency and SECOND_ORDER (stronger suppression) a full sample (see getLatencySamples())
+
+        enum class AntiAliasing {
+            NONE = 0,
+            FIRST_ORDER,
+            SECOND_ORDER
+        };
+
         BitCrusher( float amount, float inputMix, float outputMix );
         ~BitCrusher();
 
         void setLFO( float LFORatePercentage, float LFODepth );
+        void setSampleRate( float sampleRate );
         void process( float* inBuffer, int bufferSize );
 
+        // process with the resolution additionally modulated by given signal (e.g. a sidechain envelope), where
+        // modulation holds a 0 - 1 range value for each sample and depth the amount by which it reduces the resolution
+
+        void process( float* inBuffer, int bufferSize, const float* modulation, float depth );
+
+        // per sample processing (e.g. as a stage within a Chain, see chain.h), begin() must be invoked prior
+        // to processing each block of each channel (modulation and depth as described above)
+
+        void begin( const float* modulation = nullptr, float depth = 0.f, int channel = 0 );
+
+        inline float tick( float sample, int index )
+        {
+            // sound should not be crushed ? do nothing (though the anti-aliasing latency and history are retained)
+            if ( !_isActive )
+                return _antiAliasing == AntiAliasing::NONE ? sample : delayAntiAliased( sample );
+
+            float output;
+            if ( _antiAliasing == AntiAliasing::NONE && dither.getMode() == Dither::Mode::NONE ) {
+                // note the input is capped as out of range values cannot be represented by the quantizer
+                short input = ( short ) (( Calc::capSample( sample ) * _inputMix ) * SHRT_MAX );
+                short prevent_offset = ( short )( -1 >> ( _bits + 1 ));
+                input &= ( int ) ( ~0u << ( 16 - _bits ));
+                output = (( input + prevent_offset ) * _outputMix ) / SHRT_MAX;
+            } else if ( _antiAliasing == AntiAliasing::NONE ) {
+                output = quantizeDithered( sample );
+            } else {
+                output = quantizeAntiAliased( sample );
+            }
+
+            if ( hasLFO || _isModulated ) {
+                _tempAmount = _amount;
+
+                if ( hasLFO ) {
+                    // multiply by .5 and add .5 to make the LFO's bipolar waveform unipolar
+                    float lfoValue = lfo.peek() * .5f  + .5f;
+                    _tempAmount = std::min( _lfoMax, _lfoMin + _lfoRange * lfoValue );
+                }
+                if ( _isModulated ) {
+                    _tempAmount *= 1.f - _modulationDepth * std::min( 1.f, _modulation[ index ] );
+                }
+
+                // recalculate the current resolution
+                calcBits();
+            }
+            return output;
+        }
+
+        // restore the initial processing state (e.g. restart the LFO) while retaining the settings
+        void reset();
+
         void setAmount( float value ); // range between -1 to +1
         void setInputMix( float value );
         void setOutputMix( float value );
+        void setAntiAliasing( AntiAliasing mode );
+
+        // the latency introduced by the anti-aliasing, the half sample of FIRST_ORDER is rounded up
+
+        static constexpr int MAX_LATENCY_SAMPLES = 1;
 
-        LFO* lfo;
+        int getLatencySamples() const { return _antiAliasing == AntiAliasing::NONE ? 0 : MAX_LATENCY_SAMPLES; }
+
+        AntiAliasing getAntiAliasing() const { return _antiAliasing; }
+
+        // the average the anti-aliased quantizer reduces to at full resolution (e.g. of the current and
+        // previous input samples for FIRST_ORDER), delaying given signal by the same (fractional) amount.
+        // This aligns signals mixed with the output (e.g. the dry signal) without comb filtering, where
+        // history holds the two previous samples of the signal (initialized to silence)
+
+        template <typename T>
+        static inline T alignWithAntiAliasing( AntiAliasing mode, T sample, T* history )
+        {
+            T output;
+
+            if ( mode == AntiAliasing::NONE ) {
+                return sample;
+            }
+            if ( mode == AntiAliasing::FIRST_ORDER ) {
+                output = ( sample + history[ 0 ] ) * ( T ) .5;
+            } else {
+                output = ( sample + history[ 0 ] + history[ 1 ] ) * ( T ) ( 1. / 3. );
+                history[ 1 ] = history[ 0 ];
+            }
+            history[ 0 ] = sample;
+
+            return output;
+        }
+
+        // dither the quantizer (the noise shaping only applies when anti-aliasing is disabled)
+        void setDither( Dither::Mode mode );
+
+        LFO lfo; // stored inline to keep the oscillator state next to that of the BitCrusher
+        Dither dither;
         bool hasLFO;
 
     private:
@@ -55,6 +159,30 @@ class BitCrusher {
         float _lfoRange;
         float _lfoMax;
         float _lfoMin;
+
+        // per sample processing state (see begin())
+
+        const float* _modulation;
+        float _modulationDepth;
+        bool _isModulated;
+        bool _isActive;
+
+        // anti-aliasing related (the previous input samples of each channel)
+
+        AntiAliasing _antiAliasing;
+        float _history[ MAX_CHANNELS ][ 2 ];
+        float* _channelHistory;
+
+        float quantizeDithered( float sample );
+        float quantizeAntiAliased( float sample );
+
+        // while inactive, the input is delayed as the anti-aliased quantizer would at full resolution
+        // (e.g. half a sample or a full sample), so resuming the quantizer is free of discontinuities
+
+        inline float delayAntiAliased( float sample )
+        {
+            return alignWithAntiAliasing<float>( _antiAliasing, sample, _channelHistory );
+        }
 };
 }
 
@@ -0,0 +1,70 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "blockadapter.h"
+#include <algorithm>
+
+namespace Igorski {
+
+/* constructor */
+
+BlockAdapter::BlockAdapter( Mode mode, int blockSize, int amountOfChannels )
+{
+    // round the block size up to the next power of two
+
+    int size = 1;
+    while ( size < blockSize ) {
+        size <<= 1;
+    }
+
+    _mode             = mode;
+    _blockSize        = size;
+    _amountOfChannels = std::min( amountOfChannels, MAX_CHANNELS );
+    _fifoPosition     = 0;
+
+    _inputFifo.resize ( _amountOfChannels * _blockSize, 0.0 );
+    _outputFifo.resize( _amountOfChannels * _blockSize, 0.0 );
+
+    for ( int c = 0; c < MAX_CHANNELS; ++c ) {
+        bool hasChannel = c < _amountOfChannels;
+
+        _inputChannels [ c ] = hasChannel ? &_inputFifo [ c * _blockSize ] : nullptr;
+        _outputChannels[ c ] = hasChannel ? &_outputFifo[ c * _blockSize ] : nullptr;
+    }
+}
+
+/* public methods */
+
+int BlockAdapter::getLatencySamples() const
+{
+    return _mode == Mode::FIXED_LATENCY ? _blockSize : 0;
+}
+
+void BlockAdapter::reset()
+{
+    std::fill( _inputFifo.begin(),  _inputFifo.end(),  0.0 );
+    std::fill( _outputFifo.begin(), _outputFifo.end(), 0.0 );
+
+    _fifoPosition = 0;
+}
+
+}
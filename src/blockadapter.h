@@ -0,0 +1,97 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __BLOCKADAPTER_H_INCLUDED__
+#define __BLOCKADAPTER_H_INCLUDED__
+
+#include <algorithm>
+#include <vector>
+
+namespace Igorski {
+
+/**
+ * BlockAdapter feeds variable sized host blocks (e.g. 441, 17 or even 1 sample)
+ * to a processing callback in fixed size internal blocks, which benefits unrolled/vectorised
+ * loops and block based (e.g. FFT) stages. The block size is a power of two. Two modes are supported:
+ *
+ * ZERO_LATENCY  the stream is divided into internal blocks (starting at the last reset()), whole
+ *               internal blocks within the host block (the aligned middle) are processed directly in
+ *               the host buffers. The ragged edges (completing the internal block a previous host block
+ *               ended in, or starting the next) are processed through the FIFO at their position within
+ *               the internal block, such that the FIFO holds the whole internal block once completed.
+ *               A callback never spans two internal blocks
+ * FIXED_LATENCY buffers the input in a FIFO and only ever processes whole internal blocks, samples
+ *               remaining at the end of a host block are carried over to the next. As such the output
+ *               is delayed by the block size, which is to be reported to the host (see getLatencySamples())
+ *
+ * The callback is a generic callable invoked as:
+ * callback( SampleType** in, SampleType** out, int numChannels, int offset, int bufferSize )
+ * where SampleType is double when operating on the internal FIFO buffers. Any input only (key)
+ * channels are passed (and in FIXED_LATENCY mode delayed) along with the processed channels.
+ */
+class BlockAdapter {
+
+    public:
+        enum class Mode {
+            ZERO_LATENCY,
+            FIXED_LATENCY
+        };
+
+        static constexpr int MAX_CHANNELS = 8;
+
+        // allocates the FIFO buffers (should not be invoked from the audio thread)
+
+        BlockAdapter( Mode mode, int blockSize, int amountOfChannels );
+
+        // numKeyChannels describes the amount of additional, input only channels in inBuffer
+        // (directly following the numChannels processed channels, e.g. a sidechain signal)
+
+        template <typename SampleType, typename Callback>
+        void process( SampleType** inBuffer, SampleType** outBuffer, int numChannels, int numKeyChannels,
+                      int bufferSize, Callback&& callback );
+
+        Mode getMode() const { return _mode; }
+        int getBlockSize() const { return _blockSize; }
+        int getLatencySamples() const;
+
+        // clear the FIFO contents
+
+        void reset();
+
+    private:
+        Mode _mode;
+        int _blockSize;
+        int _amountOfChannels;
+        int _fifoPosition; // shared by input and output FIFO (the position within the current internal block)
+
+        std::vector<double> _inputFifo;  // _amountOfChannels * _blockSize samples
+        std::vector<double> _outputFifo;
+
+        double* _inputChannels [ MAX_CHANNELS ];
+        double* _outputChannels[ MAX_CHANNELS ];
+};
+
+}
+
+#include "blockadapter.tcc"
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+namespace Igorski
+{
+template <typename SampleType, typename Callback>
+void BlockAdapter::process( SampleType** inBuffer, SampleType** outBuffer, int numChannels, int numKeyChannels,
+                            int bufferSize, Callback&& callback )
+{
+    numChannels    = std::min( numChannels, _amountOfChannels );
+    numKeyChannels = std::min( numKeyChannels, _amountOfChannels - numChannels );
+
+    int readOffset = 0;
+
+    if ( _mode == Mode::ZERO_LATENCY )
+    {
+        while ( readOffset < bufferSize )
+        {
+            int remaining = bufferSize - readOffset;
+
+            // the aligned middle: a whole internal block is processed directly in the host buffers
+
+            if ( _fifoPosition == 0 && remaining >= _blockSize ) {
+                callback( inBuffer, outBuffer, numChannels, readOffset, _blockSize );
+                readOffset += _blockSize;
+                continue;
+            }
+
+            // a ragged edge: processed in place within the FIFO (at its position within the internal block)
+
+            int segmentSize = std::min( remaining, _blockSize - _fifoPosition );
+
+            for ( int c = 0; c < numChannels + numKeyChannels; ++c )
+            {
+                double* inputFifo = _inputChannels[ c ] + _fifoPosition;
+                SampleType* channelInBuffer = inBuffer[ c ] + readOffset;
+
+                for ( int i = 0; i < segmentSize; ++i ) {
+                    inputFifo[ i ] = ( double ) channelInBuffer[ i ];
+                }
+            }
+
+            callback( _inputChannels, _outputChannels, numChannels, _fifoPosition, segmentSize );
+
+            for ( int c = 0; c < numChannels; ++c )
+            {
+                SampleType* channelOutBuffer = outBuffer[ c ] + readOffset;
+                double* outputFifo = _outputChannels[ c ] + _fifoPosition;
+
+                for ( int i = 0; i < segmentSize; ++i ) {
+                    channelOutBuffer[ i ] = ( SampleType ) outputFifo[ i ];
+                }
+            }
+
+            _fifoPosition = ( _fifoPosition + segmentSize ) % _blockSize;
+            readOffset   += segmentSize;
+        }
+        return;
+    }
+
+    // FIXED_LATENCY: copy the host input into the input FIFO and output the previously processed
+    // block from the output FIFO, segment-wise up to the end of the current FIFO block.
+    // Note the input is read before the output is written as the host buffers can be the same
+
+    while ( readOffset < bufferSize )
+    {
+        int segmentSize = std::min( bufferSize - readOffset, _blockSize - _fifoPosition );
+
+        for ( int c = 0; c < numChannels + numKeyChannels; ++c )
+        {
+            double* inputFifo = _inputChannels[ c ] + _fifoPosition;
+            SampleType* channelInBuffer = inBuffer[ c ] + readOffset;
+
+            for ( int i = 0; i < segmentSize; ++i ) {
+                inputFifo[ i ] = ( double ) channelInBuffer[ i ];
+            }
+        }
+
+        for ( int c = 0; c < numChannels; ++c )
+        {
+            SampleType* channelOutBuffer = outBuffer[ c ] + readOffset;
+            double* outputFifo = _outputChannels[ c ] + _fifoPosition;
+
+            for ( int i = 0; i < segmentSize; ++i ) {
+                channelOutBuffer[ i ] = ( SampleType ) outputFifo[ i ];
+            }
+        }
+
+        _fifoPosition += segmentSize;
+        readOffset    += segmentSize;
+
+        // a whole block is available, process it into the output FIFO (to be output during the next block)
+
+        if ( _fifoPosition == _blockSize ) {
+            callback( _inputChannels, _outputChannels, numChannels, 0, _blockSize );
+            _fifoPosition = 0;
+        }
+    }
+}
+
+}
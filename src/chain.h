@@ -0,0 +1,143 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __CHAIN_H_INCLUDED__
+#define __CHAIN_H_INCLUDED__
+
+#include "trace.h"
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace Igorski {
+
+/**
+ * A Chain composes processors ("stages") into an effect chain at compile time. Stages are
+ * processed in order and come in two kinds:
+ *
+ * per sample stages provide:
+ *     inline float tick( float sample, int index ) // index of the sample within the current block
+ *
+ * block stages (that require the whole block, e.g. for look ahead or FFT processing) declare
+ *     static constexpr bool IS_BLOCK_STAGE = true;
+ * and provide:
+ *     void process( float* buffer, int bufferSize )
+ *
+ * Consecutive per sample stages are fused into a single loop over the buffer, as such adding
+ * a per sample stage does not add a pass over the buffer. When a chain only consists of per sample
+ * stages (see IS_FUSED), it can be ticked directly, e.g. while reading the input and writing the output
+ * without materializing an intermediate buffer.
+ *
+ * The Chain references its stages, which should outlive it.
+ */
+template <typename T, typename = void>
+struct IsBlockStage : std::false_type {};
+
+template <typename T>
+struct IsBlockStage<T, typename std::enable_if<T::IS_BLOCK_STAGE>::type> : std::true_type {};
+
+template <typename... Stages>
+class Chain {
+
+    public:
+        static constexpr size_t STAGE_COUNT = sizeof...( Stages );
+        static constexpr bool IS_FUSED      = !( IsBlockStage<Stages>::value || ... );
+
+        Chain( Stages&... stages ) : _stages( stages... ) {}
+
+        template <size_t I>
+        inline auto& get() { return std::get<I>( _stages ); }
+
+        // process given sample through all stages (only available when the chain has no block stages)
+
+        inline float tick( float sample, int index )
+        {
+            static_assert( IS_FUSED, "Chain::tick() is not available for chains containing block stages" );
+            return tickRange<0, STAGE_COUNT>( sample, index );
+        }
+
+        // process given buffer in place through all stages
+
+        void process( float* buffer, int bufferSize )
+        {
+            processFrom<0>( buffer, bufferSize );
+        }
+
+    private:
+        std::tuple<Stages&...> _stages;
+
+        template <size_t I>
+        using Stage = typename std::remove_reference<typename std::tuple_element<I, std::tuple<Stages...>>::type>::type;
+
+        // index of the first block stage at or after index I (STAGE_COUNT when there is none)
+
+        template <size_t I>
+        static constexpr size_t nextBlockStage()
+        {
+            if constexpr ( I >= STAGE_COUNT ) {
+                return STAGE_COUNT;
+            } else if constexpr ( IsBlockStage<Stage<I>>::value ) {
+                return I;
+            } else {
+                return nextBlockStage<I + 1>();
+            }
+        }
+
+        template <size_t I, size_t END>
+        inline float tickRange( float sample, int index )
+        {
+            if constexpr ( I < END ) {
+                return tickRange<I + 1, END>( get<I>().tick( sample, index ), index );
+            } else {
+                return sample;
+            }
+        }
+
+        template <size_t I>
+        void processFrom( float* buffer, int bufferSize )
+        {
+            if constexpr ( I < STAGE_COUNT ) {
+                if constexpr ( IsBlockStage<Stage<I>>::value ) {
+                    {
+                        TRACE_ZONE( "Chain::blockStage" );
+                        get<I>().process( buffer, bufferSize );
+                    }
+                    processFrom<I + 1>( buffer, bufferSize );
+                } else {
+                    // fuse all per sample stages up to the next block stage into a single loop
+
+                    constexpr size_t END = nextBlockStage<I>();
+                    {
+                        TRACE_ZONE( "Chain::fusedStages" );
+                        for ( int i = 0; i < bufferSize; ++i ) {
+                            buffer[ i ] = tickRange<I, END>( buffer[ i ], i );
+                        }
+                    }
+                    processFrom<END>( buffer, bufferSize );
+                }
+            }
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,668 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "convolver.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+namespace Igorski {
+
+static const int LOAD_INTERVAL = 50; // in milliseconds, interval at which the loading thread checks for changes
+
+/* constructor / destructor */
+
+Convolver::Convolver( int amountOfChannels )
+: _amountOfChannels( std::max( 1, amountOfChannels ))
+, _mix( 0.f )
+, _fft( FFT_SIZE )
+, _kernelTable( Kernels::get())
+, _real( FFT_SIZE )
+, _imag( FFT_SIZE )
+, _farReal( BINS )
+, _farImag( BINS )
+, _tailFallbacks( 0 )
+, _kernel( nullptr )
+, _replaced( nullptr )
+, _current( nullptr )
+, _fading( nullptr )
+, _fadeRemaining( _amountOfChannels, 0 )
+, _channelIndex( 0 )
+, _impulse(( int ) Impulse::NONE )
+, _sampleRate( 0.f )
+, _pending( nullptr )
+, _retired( nullptr )
+, _tailDelay( 0 )
+, _hazard( nullptr )
+, _loadedImpulse( Impulse::NONE )
+, _loadedSampleRate( 0.f )
+, _loadedTailDelay( 0 )
+{
+    _deferred[ 0 ].store( nullptr );
+    _deferred[ 1 ].store( nullptr );
+
+    ConvolverLoader::getInstance()->add( this );
+    ConvolverWorker::getInstance()->add( this );
+}
+
+Convolver::~Convolver()
+{
+    ConvolverWorker::getInstance()->remove( this );
+    ConvolverLoader::getInstance()->remove( this );
+
+    delete _kernel;
+    delete _replaced;
+    delete _pending.exchange( nullptr );
+    delete _retired.exchange( nullptr );
+}
+
+/* public methods */
+
+void Convolver::setImpulse( Impulse impulse )
+{
+    _impulse.store(( int ) impulse );
+}
+
+void Convolver::setSampleRate( float sampleRate )
+{
+    _sampleRate.store( sampleRate );
+    ConvolverLoader::getInstance()->request();
+}
+
+void Convolver::setDeferredTail( int maxBufferSize )
+{
+    // a job is posted tailDelay frames ahead of its use, at most two blocks worth of frames complete between
+    // the block posting it and the block before the one requiring it, leaving the worker the duration of a block
+
+    int framesPerBlock = ( std::max( 0, maxBufferSize ) + PARTITION_SIZE - 1 ) / PARTITION_SIZE;
+
+    _tailDelay.store( framesPerBlock > 0 ? framesPerBlock * 2 + 2 : 0 );
+    ConvolverLoader::getInstance()->request();
+}
+
+void Convolver::loadImpulse()
+{
+    ConvolverLoader::getInstance()->load( this );
+}
+
+void Convolver::setMix( float value )
+{
+    _mix = value;
+}
+
+void Convolver::prepare()
+{
+    // kernels are only swapped and (dis)engaged once the previous crossfade has completed
+
+    for ( int c = 0; c < _amountOfChannels; ++c ) {
+        if ( _fadeRemaining[ c ] > 0 ) {
+            return;
+        }
+    }
+    _fading = nullptr;
+    publishDeferred();
+
+    // hand the replaced kernel to the loading thread for disposal, once it has disposed the previous one
+
+    if ( _replaced != nullptr && _retired.load() == nullptr ) {
+        _retired.store( _replaced );
+        _replaced = nullptr;
+    }
+
+    // swap in a newly loaded kernel
+
+    if ( _replaced == nullptr ) {
+        Kernel* kernel = _pending.exchange( nullptr );
+        if ( kernel != nullptr ) {
+            _replaced = _kernel;
+            _kernel   = kernel;
+        }
+    }
+
+    // a newly selected impulse response keeps the current kernel in use until it has been loaded,
+    // when engaging however, the convolution is deferred until the selected impulse response is available
+
+    Impulse impulse = ( Impulse ) _impulse.load();
+    bool isActive   = _kernel != nullptr && impulse != Impulse::NONE && _mix > 0.f &&
+                    ( _kernel->impulse == impulse || _current != nullptr );
+
+    Kernel* target = isActive ? _kernel : nullptr;
+
+    if ( target == _current ) {
+        return;
+    }
+
+    // crossfade from the kernel (or dry signal) currently in use, starting the new kernel from silence
+
+    if ( target != nullptr ) {
+        target->reset();
+    }
+    _fading  = _current;
+    _current = target;
+    publishDeferred();
+
+    std::fill( _fadeRemaining.begin(), _fadeRemaining.end(), FADE_LENGTH );
+}
+
+void Convolver::begin( int channel )
+{
+    _channelIndex = std::min( channel, _amountOfChannels - 1 );
+}
+
+void Convolver::reset()
+{
+    if ( _current != nullptr ) {
+        _current->reset();
+    }
+    _fading = nullptr;
+    publishDeferred();
+    std::fill( _fadeRemaining.begin(), _fadeRemaining.end(), 0 );
+}
+
+/* private methods */
+
+void Convolver::load()
+{
+    // a retired kernel is disposed once the worker no longer processes it (otherwise during the next load())
+
+    Kernel* retired = _retired.load();
+    if ( retired != nullptr && _hazard.load() != retired ) {
+        _retired.store( nullptr );
+        delete retired;
+    }
+
+    Impulse impulse  = ( Impulse ) _impulse.load();
+    float sampleRate = _sampleRate.load();
+    int tailDelay    = _tailDelay.load();
+
+    // when no impulse response is selected, the last loaded one is retained
+
+    if ( impulse != Impulse::NONE && sampleRate > 0.f &&
+       ( impulse != _loadedImpulse || sampleRate != _loadedSampleRate || tailDelay != _loadedTailDelay )) {
+        // a previously loaded kernel the audio thread has not picked up yet is discarded (it is not published to the worker)
+        delete _pending.exchange( createKernel( impulse, sampleRate, tailDelay ));
+
+        _loadedImpulse    = impulse;
+        _loadedSampleRate = sampleRate;
+        _loadedTailDelay  = tailDelay;
+
+        // have the worker poll for jobs before the audio thread starts posting these
+
+        if ( tailDelay > 0 ) {
+            ConvolverWorker::getInstance()->request();
+        }
+    }
+}
+
+Convolver::Kernel* Convolver::createKernel( Impulse impulse, float sampleRate, int tailDelay )
+{
+    TRACE_ZONE( "Convolver::createKernel" );
+
+    ResourceId id = impulse == Impulse::CABINET ? ResourceId::CABINET_IMPULSE :
+                    impulse == Impulse::ROOM    ? ResourceId::ROOM_IMPULSE : ResourceId::HALL_IMPULSE;
+
+    SharedResource resource = ResourceRegistry::getInstance()->acquire( id, sampleRate );
+    const float* taps = resource->getData();
+    int length        = resource->getSize();
+
+    Kernel* kernel     = new Kernel();
+    kernel->impulse    = impulse;
+    kernel->partitions = std::max( 0, ( length - 1 ) / PARTITION_SIZE ); // the head is not partitioned
+
+    // when deferred, the partitions starting at tailDelay are far partitions (their input frames are available
+    // tailDelay frames ahead of their use), the delay line retains these frames for the duration of a job
+
+    kernel->nearPartitions = tailDelay > 0 ? std::min( kernel->partitions, tailDelay ) : kernel->partitions;
+    kernel->tailDelay      = kernel->isDeferred() ? tailDelay : 0;
+    kernel->slots          = kernel->partitions + kernel->tailDelay;
+
+    kernel->head.resize( PARTITION_SIZE, 0.f );
+    for ( int i = 0, l = std::min( length, PARTITION_SIZE ); i < l; ++i ) {
+        kernel->head[ PARTITION_SIZE - 1 - i ] = taps[ i ];
+    }
+
+    // the spectra of the (zero padded) tail partitions, these include
+    // the normalization of the inverse transform (see processFrame())
+
+    kernel->spectraReal.resize( kernel->partitions * BINS );
+    kernel->spectraImag.resize( kernel->partitions * BINS );
+
+    std::vector<float> real( FFT_SIZE );
+    std::vector<float> imag( FFT_SIZE );
+    const float scale = 1.f / FFT_SIZE;
+
+    for ( int p = 0; p < kernel->partitions; ++p ) {
+        int offset = ( p + 1 ) * PARTITION_SIZE;
+
+        std::fill( real.begin(), real.end(), 0.f );
+        std::fill( imag.begin(), imag.end(), 0.f );
+
+        for ( int i = 0, l = std::min( PARTITION_SIZE, length - offset ); i < l; ++i ) {
+            real[ i ] = taps[ offset + i ] * scale;
+        }
+        _fft.forward( real.data(), imag.data()); // does not modify the FFT, as such safe to share with the audio thread
+
+        std::copy( real.begin(), real.begin() + BINS, kernel->spectraReal.begin() + p * BINS );
+        std::copy( imag.begin(), imag.begin() + BINS, kernel->spectraImag.begin() + p * BINS );
+    }
+
+    kernel->channels.resize( _amountOfChannels );
+    for ( Channel& channel : kernel->channels ) {
+        channel.frames.resize( FFT_SIZE );
+        channel.tail.resize( PARTITION_SIZE );
+        channel.delayLineReal.resize( kernel->slots * BINS, 0.f );
+        channel.delayLineImag.resize( kernel->slots * BINS, 0.f );
+        channel.sumReal.resize( BINS );
+        channel.sumImag.resize( BINS );
+
+        if ( kernel->isDeferred()) {
+            channel.jobs.reset( new TailJob[ kernel->tailDelay ]);
+            for ( int i = 0; i < kernel->tailDelay; ++i ) {
+                channel.jobs[ i ].real.resize( BINS );
+                channel.jobs[ i ].imag.resize( BINS );
+            }
+        }
+    }
+    kernel->reset();
+
+    return kernel;
+}
+
+void Convolver::accumulatePartitions( Kernel& kernel, Channel& channel )
+{
+    // accumulate the (near) partitions operating on previous frames in even steps over the current frame,
+    // only the partitions for which a frame has been written since the last reset are accumulated
+
+    int partitions = kernel.nearPartitions;
+    int available  = std::min( partitions, channel.frameCount + 1 );
+    int target     = 1 + (( partitions - 1 ) * channel.position + PARTITION_SIZE - 1 ) / PARTITION_SIZE;
+
+    target = std::min( target, available );
+
+    // the frame the partition applies to, relative to the slot the current frame will be written to
+
+    int next = ( channel.delayLineIndex + 1 ) % kernel.slots;
+
+    for ( ; channel.partition < target; ++channel.partition ) {
+        int slot = next - channel.partition;
+        accumulatePartition( kernel, channel, channel.partition, slot < 0 ? slot + kernel.slots : slot );
+    }
+}
+
+void Convolver::accumulatePartition( Kernel& kernel, Channel& channel, int partition, int slot )
+{
+    // multiply the partition with the spectrum of the input frame of its delay and accumulate
+    // (as the input is real valued, only the bins up to Nyquist are calculated)
+
+    _kernelTable.complexMultiplyAccumulate(
+        channel.sumReal.data(), channel.sumImag.data(),
+        &channel.delayLineReal[ slot * BINS ], &channel.delayLineImag[ slot * BINS ],
+        &kernel.spectraReal[ partition * BINS ], &kernel.spectraImag[ partition * BINS ], BINS
+    );
+}
+
+void Convolver::processFrame( Kernel& kernel, Channel& channel )
+{
+    TRACE_ZONE( "Convolver::processFrame" );
+
+    const int partitions = kernel.partitions;
+
+    channel.position = 0;
+
+    if ( partitions > 0 ) {
+        float* real = _real.data();
+        float* imag = _imag.data();
+
+        // complete the partitions operating on previous frames (usually none or a single one remain)
+
+        channel.position = PARTITION_SIZE;
+        accumulatePartitions( kernel, channel );
+        channel.position = 0;
+
+        // transform the previous and current input frame and store the
+        // spectrum as the most recent entry of the frequency-domain delay line
+
+        memcpy( real, channel.frames.data(), FFT_SIZE * sizeof( float ));
+        memset( imag, 0, FFT_SIZE * sizeof( float ));
+
+        _fft.forward( real, imag );
+
+        channel.delayLineIndex = ( channel.delayLineIndex + 1 ) % kernel.slots;
+        channel.frameCount     = std::min( channel.frameCount + 1, partitions );
+
+        memcpy( &channel.delayLineReal[ channel.delayLineIndex * BINS ], real, BINS * sizeof( float ));
+        memcpy( &channel.delayLineImag[ channel.delayLineIndex * BINS ], imag, BINS * sizeof( float ));
+
+        // the first partition operates on the current frame
+
+        accumulatePartition( kernel, channel, 0, channel.delayLineIndex );
+
+        if ( kernel.isDeferred()) {
+            deferTail( kernel, channel );
+        }
+
+        // restore the conjugate symmetric bins and transform back, the second half holds
+        // the (non-circular) output of the tail partitions, to be added during the next frame
+
+        memcpy( real, channel.sumReal.data(), BINS * sizeof( float ));
+        memcpy( imag, channel.sumImag.data(), BINS * sizeof( float ));
+
+        for ( int k = 1; k < PARTITION_SIZE; ++k ) {
+            real[ FFT_SIZE - k ] = real[ k ];
+            imag[ FFT_SIZE - k ] = -imag[ k ];
+        }
+        _fft.inverse( real, imag );
+
+        memcpy( channel.tail.data(), real + PARTITION_SIZE, PARTITION_SIZE * sizeof( float ));
+
+        // start accumulating the next frame
+
+        std::fill( channel.sumReal.begin(), channel.sumReal.end(), 0.f );
+        std::fill( channel.sumImag.begin(), channel.sumImag.end(), 0.f );
+        channel.partition = 1;
+    }
+
+    // the current frame becomes the previous frame
+
+    memcpy( channel.frames.data(), channel.frames.data() + PARTITION_SIZE, PARTITION_SIZE * sizeof( float ));
+}
+
+void Convolver::deferTail( Kernel& kernel, Channel& channel )
+{
+    TailJob& job = channel.jobs[ channel.jobIndex ];
+
+    // the far partitions of the completed frame (posted tailDelay frames ago, unless the delay line
+    // held no frames at the time, in which case there is nothing to add)
+
+    int state = job.state.exchange( TailJob::EMPTY, std::memory_order_acq_rel );
+    const float* real = nullptr;
+    const float* imag = nullptr;
+
+    if ( state == TailJob::DONE ) {
+        real = job.real.data();
+        imag = job.imag.data();
+    } else if ( state != TailJob::EMPTY ) {
+        // not completed in time, the job is cancelled (the worker discards its result)
+
+        TRACE_ZONE( "Convolver::deferTail (fallback)" );
+
+        accumulateFarPartitions( kernel, channel, job.newestSlot.load( std::memory_order_relaxed ),
+                                 job.frames.load( std::memory_order_relaxed ), _farReal.data(), _farImag.data());
+        real = _farReal.data();
+        imag = _farImag.data();
+        ++_tailFallbacks;
+    }
+
+    if ( real != nullptr ) {
+        for ( int k = 0; k < BINS; ++k ) {
+            channel.sumReal[ k ] += real[ k ];
+            channel.sumImag[ k ] += imag[ k ];
+        }
+    }
+
+    // post the job for the frame tailDelay frames ahead, its far partitions operate on
+    // the frames up to the current one (the most recent entry of the delay line)
+
+    job.newestSlot.store( channel.delayLineIndex, std::memory_order_relaxed );
+    job.frames.store( channel.frameCount, std::memory_order_relaxed );
+    job.state.store( TailJob::POSTED, std::memory_order_release );
+
+    channel.jobIndex = ( channel.jobIndex + 1 ) % kernel.tailDelay;
+}
+
+void Convolver::accumulateFarPartitions( const Kernel& kernel, const Channel& channel, int newestSlot, int frames,
+                                         float* real, float* imag ) const
+{
+    std::fill( real, real + BINS, 0.f );
+    std::fill( imag, imag + BINS, 0.f );
+
+    // the first far partition operates on the most recent frame at the time of posting, only
+    // the partitions for which a frame had been written since the last reset are accumulated
+
+    int count = std::min( kernel.partitions - kernel.nearPartitions, frames );
+
+    for ( int i = 0; i < count; ++i ) {
+        int slot      = newestSlot - i;
+        int partition = kernel.nearPartitions + i;
+
+        if ( slot < 0 ) {
+            slot += kernel.slots;
+        }
+        _kernelTable.complexMultiplyAccumulate(
+            real, imag,
+            &channel.delayLineReal[ slot * BINS ], &channel.delayLineImag[ slot * BINS ],
+            &kernel.spectraReal[ partition * BINS ], &kernel.spectraImag[ partition * BINS ], BINS
+        );
+    }
+}
+
+void Convolver::publishDeferred()
+{
+    Kernel* current = _current != nullptr && _current->isDeferred() ? _current : nullptr;
+    Kernel* fading  = _fading  != nullptr && _fading->isDeferred()  ? _fading  : nullptr;
+
+    if ( _deferred[ 0 ].load( std::memory_order_relaxed ) != current ) {
+        _deferred[ 0 ].store( current );
+    }
+    if ( _deferred[ 1 ].load( std::memory_order_relaxed ) != fading ) {
+        _deferred[ 1 ].store( fading );
+    }
+}
+
+bool Convolver::processDeferred()
+{
+    bool isDeferring = _tailDelay.load() > 0 && ( Impulse ) _impulse.load() != Impulse::NONE;
+
+    for ( int i = 0; i < 2; ++i ) {
+        Kernel* kernel = _deferred[ i ].load();
+        if ( kernel == nullptr ) {
+            continue;
+        }
+
+        // guard the kernel against disposal, it is only retired after the audio thread has
+        // stopped publishing it, as such it is safe to use when it is still published
+
+        _hazard.store( kernel );
+        if ( _deferred[ i ].load() != kernel ) {
+            _hazard.store( nullptr );
+            continue;
+        }
+        isDeferring = true;
+
+        for ( Channel& channel : kernel->channels ) {
+            for ( int j = 0; j < kernel->tailDelay; ++j ) {
+                TailJob& job = channel.jobs[ j ];
+                int expected = TailJob::POSTED;
+
+                if ( !job.state.compare_exchange_strong( expected, TailJob::CLAIMED, std::memory_order_acquire )) {
+                    continue;
+                }
+                accumulateFarPartitions( *kernel, channel, job.newestSlot.load( std::memory_order_relaxed ),
+                                         job.frames.load( std::memory_order_relaxed ), job.real.data(), job.imag.data());
+
+                // fails when the audio thread has cancelled the job in the meantime
+
+                expected = TailJob::CLAIMED;
+                job.state.compare_exchange_strong( expected, TailJob::DONE, std::memory_order_release );
+            }
+        }
+        _hazard.store( nullptr );
+    }
+    return isDeferring;
+}
+
+/* Kernel */
+
+void Convolver::Kernel::reset()
+{
+    for ( Channel& channel : channels ) {
+        std::fill( channel.frames.begin(), channel.frames.end(), 0.f );
+        std::fill( channel.tail.begin(), channel.tail.end(), 0.f );
+        std::fill( channel.sumReal.begin(), channel.sumReal.end(), 0.f );
+        std::fill( channel.sumImag.begin(), channel.sumImag.end(), 0.f );
+
+        channel.position       = 0;
+        channel.delayLineIndex = 0;
+        channel.frameCount     = 0;
+        channel.partition      = 1;
+        channel.jobIndex       = 0;
+
+        for ( int i = 0; i < tailDelay; ++i ) {
+            channel.jobs[ i ].state.store( TailJob::EMPTY );
+        }
+    }
+}
+
+/* ConvolverLoader */
+
+ConvolverLoader* ConvolverLoader::getInstance()
+{
+    static ConvolverLoader instance;
+    return &instance;
+}
+
+void ConvolverLoader::add( Convolver* convolver )
+{
+    std::lock_guard<std::mutex> lifecycleLock( _lifecycleMutex );
+    bool start = false;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _convolvers.push_back( convolver );
+
+        if ( !_running ) {
+            _running = true;
+            start    = true;
+        }
+    }
+    if ( start ) {
+        _thread = std::thread( &ConvolverLoader::run, this );
+    }
+}
+
+void ConvolverLoader::remove( Convolver* convolver )
+{
+    std::lock_guard<std::mutex> lifecycleLock( _lifecycleMutex );
+    bool stop = false;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _convolvers.erase( std::remove( _convolvers.begin(), _convolvers.end(), convolver ), _convolvers.end());
+
+        if ( _convolvers.empty()) {
+            _running = false;
+            stop     = true;
+        }
+    }
+    if ( stop ) {
+        _condition.notify_one();
+        _thread.join();
+    }
+}
+
+void ConvolverLoader::request()
+{
+    _condition.notify_one();
+}
+
+void ConvolverLoader::load( Convolver* convolver )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    convolver->load();
+}
+
+void ConvolverLoader::run()
+{
+    std::unique_lock<std::mutex> lock( _mutex );
+
+    while ( _running ) {
+        for ( Convolver* convolver : _convolvers ) {
+            convolver->load();
+        }
+        _condition.wait_for( lock, std::chrono::milliseconds( LOAD_INTERVAL ));
+    }
+}
+
+/* ConvolverWorker */
+
+ConvolverWorker* ConvolverWorker::getInstance()
+{
+    static ConvolverWorker instance;
+    return &instance;
+}
+
+void ConvolverWorker::add( Convolver* convolver )
+{
+    std::lock_guard<std::mutex> lifecycleLock( _lifecycleMutex );
+    bool start = false;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _convolvers.push_back( convolver );
+
+        if ( !_running ) {
+            _running = true;
+            start    = true;
+        }
+    }
+    if ( start ) {
+        _thread = std::thread( &ConvolverWorker::run, this );
+    }
+}
+
+void ConvolverWorker::remove( Convolver* convolver )
+{
+    std::lock_guard<std::mutex> lifecycleLock( _lifecycleMutex );
+    bool stop = false;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _convolvers.erase( std::remove( _convolvers.begin(), _convolvers.end(), convolver ), _convolvers.end());
+
+        if ( _convolvers.empty()) {
+            _running = false;
+            stop     = true;
+        }
+    }
+    if ( stop ) {
+        _condition.notify_one();
+        _thread.join();
+    }
+}
+
+void ConvolverWorker::request()
+{
+    _condition.notify_one();
+}
+
+void ConvolverWorker::run()
+{
+    std::unique_lock<std::mutex> lock( _mutex );
+
+    while ( _running ) {
+        bool isDeferring = false;
+        for ( Convolver* convolver : _convolvers ) {
+            isDeferring = convolver->processDeferred() || isDeferring;
+        }
+        // without deferred tails in use, the worker merely checks for these at the loading interval
+        _condition.wait_for( lock, std::chrono::milliseconds( isDeferring ? TAIL_INTERVAL : LOAD_INTERVAL ));
+    }
+}
+
+}
@@ -0,0 +1,357 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __CONVOLVER_H_INCLUDED__
+#define __CONVOLVER_H_INCLUDED__
+
+#include "fft.h"
+#include "kernels/kernels.h"
+#include "resourceregistry.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Igorski {
+
+class ConvolverLoader;
+class ConvolverWorker;
+
+/**
+ * Convolver applies an impulse response (e.g. a speaker cabinet or room) as a per sample
+ * stage within an effect chain (see chain.h), without introducing latency.
+ *
+ * The first PARTITION_SIZE samples of the impulse response (the "head") are convolved directly
+ * in the time domain, the remainder (the "tail") is split into partitions of PARTITION_SIZE
+ * samples that are convolved in the frequency domain (uniformly partitioned overlap-save). The
+ * spectra of the input frames are kept in a frequency-domain delay line, so each frame is only
+ * transformed once. Only the first tail partition requires the spectrum of the current frame,
+ * the others operate on previous frames and are accumulated while the current frame is being
+ * filled, spreading their cost evenly over its samples. Upon completion of a frame only its
+ * transform, the first partition and the inverse transform remain.
+ *
+ * Impulse responses are loaded and transformed in the background by a loading thread shared
+ * by all instances within the module (see ConvolverLoader). Once ready, these are swapped in
+ * atomically at the start of the next block (see prepare()), as such the audio thread does not
+ * allocate, lock or wait for loading to complete (in the meantime the previous impulse response
+ * remains in use). Swapping impulse responses, as well as engaging and disengaging the
+ * convolution, crossfades over FADE_LENGTH samples.
+ *
+ * By default the whole tail is convolved on the audio thread, which is deterministic in both output and
+ * cost (e.g. for offline renders). As the cost of a frame is still concentrated in the blocks in which frames
+ * complete, the tail can be deferred (see setDeferredTail()): the audio thread then only convolves the
+ * partitions required within the next few blocks ("near"), while the remaining ("far") partitions of each
+ * frame are computed ahead of time on a background thread (see ConvolverWorker), reading the spectra from the
+ * frequency-domain delay line, which holds additional frames for this purpose. The audio thread and the worker
+ * hand over these computations through lock-free jobs. When a job has not completed by the time the frame
+ * requires it, the audio thread computes it instead (with identical results, only the cost differs).
+ */
+class Convolver {
+
+    friend class ConvolverLoader;
+    friend class ConvolverWorker;
+
+    public:
+        static constexpr int PARTITION_SIZE = 128; // in samples
+        static constexpr int FFT_SIZE       = PARTITION_SIZE * 2;
+        static constexpr int BINS           = PARTITION_SIZE + 1; // DC to Nyquist
+        static constexpr int FADE_LENGTH    = 2048; // in samples, crossfade between impulse responses
+
+        enum class Impulse {
+            NONE = 0,
+            CABINET,
+            ROOM,
+            HALL
+        };
+        static constexpr int IMPULSE_COUNT = 4;
+
+        Convolver( int amountOfChannels );
+        ~Convolver();
+
+        Convolver( const Convolver& ) = delete;
+        Convolver& operator=( const Convolver& ) = delete;
+
+        // select the impulse response, safe to invoke from the audio thread (loading happens in the background)
+
+        void setImpulse( Impulse impulse );
+        void setSampleRate( float sampleRate );
+
+        // defer the far partitions of the tail to the background thread, where maxBufferSize is the largest block
+        // processed at once (the worker is given at least the duration of such a block to complete each frame).
+        // 0 convolves the whole tail on the audio thread (the default). Reloads the impulse response (see loadImpulse())
+
+        void setDeferredTail( int maxBufferSize );
+
+        // loads the selected impulse response on the calling thread (rather than awaiting the loading thread)
+        // so that the next processed block uses it, e.g. for deterministic renders. Should not be invoked from the audio thread
+
+        void loadImpulse();
+
+        // mix between the incoming (0) and convolved (1) signal
+
+        void setMix( float value );
+
+        // invoke once per block prior to processing its channels (swaps in a newly loaded impulse response)
+
+        void prepare();
+
+        // select the channel for the next tick() calls
+
+        void begin( int channel );
+
+        inline float tick( float sample, int /*index*/ )
+        {
+            if ( _current == nullptr && _fading == nullptr )
+                return sample;
+
+            float wet = _current != nullptr ? convolve( *_current, sample ) : sample;
+
+            int& fadeRemaining = _fadeRemaining[ _channelIndex ];
+
+            if ( fadeRemaining > 0 ) {
+                float previous = _fading != nullptr ? convolve( *_fading, sample ) : sample;
+                wet += ( previous - wet ) * (( float ) fadeRemaining-- / ( float ) FADE_LENGTH );
+            }
+            return sample + ( wet - sample ) * _mix;
+        }
+
+        // clear the convolution state while retaining the settings and impulse response
+        void reset();
+
+        // diagnostic: the amount of deferred frames the worker did not complete in time (computed on the audio thread instead)
+
+        int getTailFallbackCount() const { return _tailFallbacks; }
+
+    private:
+        // the far partitions of a single frame, computed by the worker (see deferTail())
+
+        struct TailJob {
+            enum State { EMPTY = 0, POSTED, CLAIMED, DONE };
+
+            std::atomic<int> state { EMPTY };
+            std::atomic<int> newestSlot { 0 }; // the delay line slot holding the most recent frame at the time of posting
+            std::atomic<int> frames { 0 };     // the amount of frames in the delay line at the time of posting
+            std::vector<float> real;           // accumulated spectrum (BINS values), written by the worker
+            std::vector<float> imag;
+        };
+
+        struct Channel {
+            std::vector<float> frames;  // the previous and current input frame (FFT_SIZE samples)
+            std::vector<float> tail;    // output of the tail partitions for the current frame
+            std::vector<float> delayLineReal; // spectra of the most recent input frames, one for each partition
+            std::vector<float> delayLineImag;
+            std::vector<float> sumReal; // accumulated spectrum of the tail partitions for the next frame
+            std::vector<float> sumImag;
+            int position;   // within the current frame
+            int delayLineIndex;
+            int frameCount; // amount of frames in the delay line since the last reset (capped to the partition count)
+            int partition;  // next partition to accumulate for the next frame
+            std::unique_ptr<TailJob[]> jobs; // when deferred, one for each frame in flight (tailDelay)
+            int jobIndex;   // the job of the current frame
+        };
+
+        // an impulse response prepared for convolution, along with the convolution state for each channel
+
+        struct Kernel {
+            Impulse impulse;
+            int partitions;                 // amount of partitions of the tail
+            int nearPartitions;             // those convolved on the audio thread (all unless deferred)
+            int tailDelay;                  // when deferred, the amount of frames a job is posted ahead of its use
+            int slots;                      // size of the frequency-domain delay line (in frames)
+            std::vector<float> head;        // first PARTITION_SIZE taps of the impulse response, reversed
+            std::vector<float> spectraReal; // spectra of the tail partitions (BINS values each)
+            std::vector<float> spectraImag;
+            std::vector<Channel> channels;
+
+            bool isDeferred() const { return nearPartitions < partitions; }
+
+            // clears the convolution state, the delay line is not cleared as
+            // only the frames written since the reset are accumulated (pending jobs are cancelled)
+
+            void reset();
+        };
+
+        int _amountOfChannels;
+        float _mix;
+
+        FFT _fft;
+        const Kernels::Table& _kernelTable; // vectorised inner loops for the CPU (see kernels.h)
+        std::vector<float> _real; // buffers used by processFrame() (FFT_SIZE values)
+        std::vector<float> _imag;
+        std::vector<float> _farReal; // buffers used by deferTail() (BINS values)
+        std::vector<float> _farImag;
+        int _tailFallbacks;
+
+        Kernel* _kernel;   // most recently loaded, owned by the audio thread
+        Kernel* _replaced; // previously loaded, retained until its crossfade has completed
+
+        // the kernels in use by the audio thread (nullptr meaning the dry signal), while
+        // _fadeRemaining is non-zero the output crossfades from _fading to _current
+
+        Kernel* _current;
+        Kernel* _fading;
+        std::vector<int> _fadeRemaining; // for each channel
+        int _channelIndex;
+
+        // the handover between the loading thread and the audio thread
+
+        std::atomic<int> _impulse;
+        std::atomic<float> _sampleRate;
+        std::atomic<Kernel*> _pending;  // loaded, yet to be used by the audio thread
+        std::atomic<Kernel*> _retired;  // replaced by the audio thread, to be disposed by the loading thread
+        std::atomic<int> _tailDelay;    // in frames, 0 when the tail is not deferred
+
+        // the handover between the audio thread and the worker, the kernels in use with a deferred tail
+        // (published by the audio thread) and the kernel the worker is processing (a hazard pointer
+        // preventing its disposal by the loading thread)
+
+        std::atomic<Kernel*> _deferred[ 2 ];
+        std::atomic<Kernel*> _hazard;
+
+        // owned by the loading thread
+
+        Impulse _loadedImpulse;
+        float _loadedSampleRate;
+        int _loadedTailDelay;
+
+        void load();
+        Kernel* createKernel( Impulse impulse, float sampleRate, int tailDelay );
+
+        // publish the kernels currently in use for the worker (invoked by the audio thread when these change)
+
+        void publishDeferred();
+
+        // process the posted jobs of the published kernels, invoked by the worker
+        // returns whether a deferred tail is in use (or about to be, e.g. once its kernel has been loaded)
+
+        bool processDeferred();
+
+        inline float convolve( Kernel& kernel, float sample )
+        {
+            Channel& channel = kernel.channels[ _channelIndex ];
+            float* frames    = channel.frames.data();
+
+            frames[ PARTITION_SIZE + channel.position ] = sample;
+
+            // the head is convolved directly, its taps are stored in reverse order so these align
+            // with the last PARTITION_SIZE input samples (the tail of the previous frame has
+            // been calculated upon its completion)
+
+            const float* taps  = kernel.head.data();
+            const float* input = frames + channel.position + 1;
+
+            float wet = channel.tail[ channel.position ] + _kernelTable.dotProduct( taps, input, PARTITION_SIZE );
+
+            if ( ++channel.position == PARTITION_SIZE ) {
+                processFrame( kernel, channel );
+            } else if ( channel.partition < kernel.nearPartitions ) {
+                accumulatePartitions( kernel, channel );
+            }
+            return wet;
+        }
+
+        void accumulatePartitions( Kernel& kernel, Channel& channel );
+        void accumulatePartition( Kernel& kernel, Channel& channel, int partition, int slot );
+        void processFrame( Kernel& kernel, Channel& channel );
+
+        // adds the far partitions of the completed frame (as computed by the worker, or
+        // computed here when it has not completed) and posts the job of the frame ahead
+
+        void deferTail( Kernel& kernel, Channel& channel );
+
+        // the accumulated spectrum of the far partitions given the state of the delay line at the time of posting
+        // (invoked by both the worker and the audio thread, computing the same result)
+
+        void accumulateFarPartitions( const Kernel& kernel, const Channel& channel, int newestSlot, int frames,
+                                      float* real, float* imag ) const;
+};
+
+/**
+ * ConvolverLoader loads the impulse responses of all Convolvers within the module on a single
+ * background thread. The thread is started once the first Convolver is constructed and stopped
+ * once the last Convolver is destroyed. Requests made on the audio thread (see Convolver::setImpulse())
+ * do not signal the thread, these are picked up by its periodic check.
+ */
+class ConvolverLoader {
+
+    public:
+        static ConvolverLoader* getInstance();
+
+        void add( Convolver* convolver );
+        void remove( Convolver* convolver ); // once returned, the loading thread no longer accesses given Convolver
+
+        // wake the loading thread, should not be invoked from the audio thread
+
+        void request();
+
+        // load the selected impulse response of given Convolver on the calling thread
+
+        void load( Convolver* convolver );
+
+    private:
+        std::vector<Convolver*> _convolvers;
+        std::mutex _mutex;          // guards the convolvers, held while loading
+        std::mutex _lifecycleMutex; // serializes starting and stopping the thread
+        std::condition_variable _condition;
+        std::thread _thread;
+        bool _running = false;
+
+        void run();
+};
+
+/**
+ * ConvolverWorker computes the deferred tail partitions of all Convolvers within the module on a single
+ * background thread (see Convolver::setDeferredTail()), with the same lifecycle as the ConvolverLoader.
+ * The audio thread posts its jobs without signalling the thread, while a deferred tail is in use the
+ * thread polls for jobs every TAIL_INTERVAL milliseconds (otherwise at the interval of the loading thread). Note the handover relies on there being a single
+ * worker (e.g. a cancelled job can only be claimed again once the worker has finished with it).
+ */
+class ConvolverWorker {
+
+    public:
+        static constexpr int TAIL_INTERVAL = 1; // in milliseconds
+
+        static ConvolverWorker* getInstance();
+
+        void add( Convolver* convolver );
+        void remove( Convolver* convolver ); // once returned, the worker no longer accesses given Convolver
+
+        // wake the worker (e.g. once a kernel with a deferred tail has been loaded), should not be invoked from the audio thread
+
+        void request();
+
+    private:
+        std::vector<Convolver*> _convolvers;
+        std::mutex _mutex;          // guards the convolvers, held while processing
+        std::mutex _lifecycleMutex; // serializes starting and stopping the thread
+        std::condition_variable _condition;
+        std::thread _thread;
+        bool _running = false;
+
+        void run();
+};
+
+}
+
+#endif
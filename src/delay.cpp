@@ -0,0 +1,197 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "delay.h"
+#include <algorithm>
+#include <string.h>
+
+namespace Igorski {
+
+Delay::Delay( float** rings, int amountOfChannels, int ringSize, float** taps, int maxBufferSize )
+: _kernelTable( Kernels::get())
+{
+    _rings            = rings;
+    _tap              = taps[ 0 ];
+    _previousTap      = taps[ 1 ];
+    _amountOfChannels = std::min( amountOfChannels, MAX_CHANNELS );
+    _ringSize         = ringSize;
+    _ringMask         = ( uint32_t ) ringSize - 1;
+    _maxBufferSize    = maxBufferSize;
+    _channel          = 0;
+
+    _delay    = 1;
+    _feedback = 0.f;
+    _mix      = 0.f;
+
+    for ( int c = 0; c < MAX_CHANNELS; ++c ) {
+        _state[ c ] = { 0, 0, _delay, _delay, 0, true };
+    }
+}
+
+int Delay::getRingSize( float maxDelaySeconds, float sampleRate )
+{
+    int samples = std::max( 1, ( int ) ( maxDelaySeconds * sampleRate ));
+    int size    = 1;
+
+    while ( size < samples ) {
+        size <<= 1;
+    }
+    return size;
+}
+
+void Delay::setDelayTime( int delaySamples )
+{
+    // the taps crossfade towards the new delay time during process()
+
+    _delay = std::max( 1, std::min( delaySamples, _ringSize ));
+}
+
+void Delay::setFeedback( float value )
+{
+    _feedback = std::max( 0.f, std::min( 1.f, value )) * MAX_FEEDBACK;
+}
+
+void Delay::setMix( float value )
+{
+    // no signal is written while the mix is 0, clear the history when enabling (see process())
+
+    if ( _mix == 0.f && value > 0.f ) {
+        for ( int c = 0; c < _amountOfChannels; ++c ) {
+            _state[ c ].clear = true;
+        }
+    }
+    _mix = std::max( 0.f, std::min( 1.f, value ));
+}
+
+void Delay::copySettings( const Delay& other )
+{
+    _delay    = std::max( 1, std::min( other._delay, _ringSize ));
+    _feedback = other._feedback;
+    _mix      = other._mix;
+
+    for ( int c = 0; c < MAX_CHANNELS; ++c ) {
+        _state[ c ].delay         = _delay;
+        _state[ c ].previousDelay = _delay;
+        _state[ c ].fadeRemaining = 0;
+    }
+}
+
+void Delay::begin( int channel )
+{
+    _channel = channel;
+}
+
+void Delay::process( float* buffer, int bufferSize )
+{
+    if ( _mix == 0.f || _channel >= _amountOfChannels ) {
+        return;
+    }
+
+    ChannelState& state = _state[ _channel ];
+    float* ring = _rings[ _channel ];
+
+    // the ring isn't silenced, its unwritten samples are read as silence (see read())
+
+    if ( state.clear ) {
+        state.writeIndex    = 0;
+        state.written       = 0;
+        state.delay         = _delay;
+        state.previousDelay = _delay;
+        state.fadeRemaining = 0;
+        state.clear         = false;
+    }
+
+    for ( int offset = 0; offset < bufferSize; )
+    {
+        // start crossfading towards a changed delay time once the previous crossfade has completed
+
+        if ( state.fadeRemaining == 0 && state.delay != _delay ) {
+            state.previousDelay = state.delay;
+            state.delay         = _delay;
+            state.fadeRemaining = FADE_LENGTH;
+        }
+
+        // process in spans no longer than the delay time, so the read span
+        // never overlaps the span written in the same iteration
+
+        int shortestDelay = state.fadeRemaining > 0 ? std::min( state.delay, state.previousDelay ) : state.delay;
+        int length = std::min( std::min( bufferSize - offset, shortestDelay ), _maxBufferSize );
+
+        read( ring, state, state.delay, _tap, length );
+
+        if ( state.fadeRemaining > 0 ) {
+            read( ring, state, state.previousDelay, _previousTap, length );
+
+            for ( int i = 0; i < length; ++i ) {
+                float fade = ( float ) std::max( 0, state.fadeRemaining - i ) / ( float ) FADE_LENGTH;
+                _tap[ i ] += ( _previousTap[ i ] - _tap[ i ] ) * fade;
+            }
+            state.fadeRemaining = std::max( 0, state.fadeRemaining - length );
+        }
+
+        // feed the input and the delayed signal back into the ring, mixing the delayed signal into the output
+
+        _kernelTable.feedbackMix( buffer + offset, _tap, _feedback, _mix, length );
+
+        write( ring, state.writeIndex, _tap, length );
+
+        state.writeIndex += length;
+        state.written     = std::min(( uint32_t ) _ringSize, state.written + ( uint32_t ) length );
+        offset += length;
+    }
+}
+
+void Delay::reset()
+{
+    for ( int c = 0; c < _amountOfChannels; ++c ) {
+        _state[ c ].clear = true;
+    }
+}
+
+/* private methods */
+
+void Delay::read( const float* ring, const ChannelState& state, int delay, float* target, int length ) const
+{
+    // samples preceding the last clear of the ring are silent
+
+    int silent = std::max( 0, std::min( length, delay - ( int ) state.written ));
+
+    memset( target, 0, silent * sizeof( float ));
+
+    uint32_t position = ( state.writeIndex - delay + silent ) & _ringMask;
+    int remaining = length - silent;
+    int first     = std::min( remaining, ( int ) ( _ringSize - position ));
+
+    memcpy( target + silent, ring + position, first * sizeof( float ));
+    memcpy( target + silent + first, ring, ( remaining - first ) * sizeof( float ));
+}
+
+void Delay::write( float* ring, uint32_t index, const float* source, int length ) const
+{
+    uint32_t position = index & _ringMask;
+    int first = std::min( length, ( int ) ( _ringSize - position ));
+
+    memcpy( ring + position, source, first * sizeof( float ));
+    memcpy( ring, source + first, ( length - first ) * sizeof( float ));
+}
+
+}
@@ -0,0 +1,114 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DELAY_H_INCLUDED__
+#define __DELAY_H_INCLUDED__
+
+#include "kernels/kernels.h"
+#include <cstdint>
+
+namespace Igorski {
+
+/**
+ * A feedback delay, operating as a block stage within an effect chain (see chain.h).
+ *
+ * Each channel has a power of two sized ring buffer (indexed by mask), the delayed signal
+ * is read and written in spans of at most two consecutive segments. Changes to the delay time
+ * crossfade between the previous and the new tap (changes made during a crossfade are applied
+ * once it completes). Clearing a ring doesn't touch its memory, rather the samples that haven't
+ * been written since are read as silence. The Delay doesn't allocate, its memory
+ * is provided on construction (see PluginProcess::createGraph()).
+ */
+class Delay {
+
+    public:
+        static constexpr bool IS_BLOCK_STAGE = true;
+        static constexpr int MAX_CHANNELS    = 8;
+        static constexpr int FADE_LENGTH     = 2048; // in samples, crossfade between taps on delay time changes
+        static constexpr float MAX_FEEDBACK  = .95f; // keeps the feedback loop decaying at full feedback
+
+        // rings contains amountOfChannels buffers of ringSize (a power of two, see getRingSize()) samples
+        // taps contains two buffers of maxBufferSize samples (the largest block size passed to process())
+
+        Delay( float** rings, int amountOfChannels, int ringSize, float** taps, int maxBufferSize );
+
+        // the size of the ring buffer required to hold given duration at given sample rate
+
+        static int getRingSize( float maxDelaySeconds, float sampleRate );
+
+        // delay time in samples (capped to the ring size)
+
+        void setDelayTime( int delaySamples );
+        int getDelayTime() const { return _delay; }
+
+        void setFeedback( float value ); // 0 - 1 range (scaled to MAX_FEEDBACK)
+        void setMix( float value );      // 0 - 1 range, the amount of delayed signal added to the input
+
+        // copy the settings of given Delay (not its contents)
+
+        void copySettings( const Delay& other );
+
+        // select the channel for the next process() call
+
+        void begin( int channel );
+
+        // apply the delay onto given buffer (in place) for the channel selected in begin()
+
+        void process( float* buffer, int bufferSize );
+
+        // silence the contents of the delay lines
+        void reset();
+
+    private:
+        struct ChannelState {
+            uint32_t writeIndex;
+            uint32_t written;  // samples written since the ring was cleared (capped to the ring size)
+            int delay;         // delay time of the tap, follows _delay
+            int previousDelay;
+            int fadeRemaining; // samples left in the crossfade from previousDelay to delay
+            bool clear;        // whether the ring should be cleared before processing
+        };
+
+        const Kernels::Table& _kernelTable; // vectorised inner loops for the CPU (see kernels.h)
+
+        float** _rings;
+        float* _tap;
+        float* _previousTap;
+        int _amountOfChannels;
+        int _ringSize;
+        uint32_t _ringMask;
+        int _maxBufferSize;
+        int _channel;
+
+        int _delay;
+        float _feedback;
+        float _mix;
+
+        ChannelState _state[ MAX_CHANNELS ];
+
+        void read( const float* ring, const ChannelState& state, int delay, float* target, int length ) const;
+        void write( float* ring, uint32_t index, const float* source, int length ) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DENORMALS_H_INCLUDED__
+#define __DENORMALS_H_INCLUDED__
+
+#include <cmath>
+#include <cstdint>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define DENORMALS_X86 1
+#include <xmmintrin.h>
+#elif defined( _M_ARM64 )
+#define DENORMALS_ARM64_MSVC 1
+#include <intrin.h>
+#elif defined( __aarch64__ )
+#define DENORMALS_ARM64 1
+#endif
+
+namespace Igorski {
+
+/**
+ * Disables denormal (subnormal) floating point numbers for the lifetime of the instance, by
+ * enabling flush-to-zero and denormals-are-zero on x86 (MXCSR) or flush-to-zero on arm64 (FPCR).
+ * The previous state of the floating point unit (as configured by the host) is restored
+ * upon destruction. Should be created on the stack at the start of each process cycle.
+ */
+class ScopedNoDenormals
+{
+    public:
+        ScopedNoDenormals()
+        {
+#if DENORMALS_X86
+            _state = _mm_getcsr();
+            _mm_setcsr( _state | FTZ_DAZ );
+#elif DENORMALS_ARM64_MSVC
+            _state = _ReadStatusReg( ARM64_FPCR );
+            _WriteStatusReg( ARM64_FPCR, _state | FZ );
+#elif DENORMALS_ARM64
+            asm volatile( "mrs %0, fpcr" : "=r"( _state ));
+            asm volatile( "msr fpcr, %0" : : "r"( _state | FZ ));
+#endif
+        }
+
+        ~ScopedNoDenormals()
+        {
+#if DENORMALS_X86
+            _mm_setcsr( _state );
+#elif DENORMALS_ARM64_MSVC
+            _WriteStatusReg( ARM64_FPCR, _state );
+#elif DENORMALS_ARM64
+            asm volatile( "msr fpcr, %0" : : "r"( _state ));
+#endif
+        }
+
+        ScopedNoDenormals( const ScopedNoDenormals& ) = delete;
+        ScopedNoDenormals& operator=( const ScopedNoDenormals& ) = delete;
+
+    private:
+#if DENORMALS_X86
+        static const unsigned int FTZ_DAZ = 0x8040; // bit 15 (FTZ) and bit 6 (DAZ)
+        unsigned int _state;
+#elif DENORMALS_ARM64_MSVC || DENORMALS_ARM64
+        static const uint64_t FZ = 1ull << 24;
+        uint64_t _state;
+#endif
+};
+
+namespace Denormals {
+
+    // the guard above is not available on every platform (and double precision
+    // processing on 32-bit x86 hosts uses the x87 unit, which it doesn't affect), as such
+    // recursive state (e.g. filter memory, envelopes) should additionally be flushed to zero
+    // when it decays below the audible range
+
+    template <typename T>
+    inline T flush( T value )
+    {
+        return std::fabs( value ) < ( T ) 1e-15 ? ( T ) 0 : value;
+    }
+
+    // diagnostic: the amount of subnormal values in given buffer
+
+    template <typename T>
+    inline int countSubnormals( const T* buffer, int bufferSize )
+    {
+        int count = 0;
+        for ( int i = 0; i < bufferSize; ++i ) {
+            count += std::fpclassify( buffer[ i ] ) == FP_SUBNORMAL;
+        }
+        return count;
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "displayqueues.h"
+#include <random>
+
+namespace Igorski {
+
+DisplayQueueRegistry* DisplayQueueRegistry::getInstance()
+{
+    static DisplayQueueRegistry instance;
+    return &instance;
+}
+
+DisplayQueueRegistry::DisplayQueueRegistry()
+{
+    std::random_device random;
+    _salt = ( int64_t ) (( uint64_t ) random() << 32 );
+}
+
+int64_t DisplayQueueRegistry::add( const DisplayQueues& queues )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    int64_t token = 0;
+    while ( token == 0 || _queues.count( token ) > 0 ) {
+        token = _salt | ( int64_t ) ++_counter;
+    }
+    _queues[ token ] = queues;
+
+    return token;
+}
+
+void DisplayQueueRegistry::remove( int64_t token )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    _queues.erase( token );
+}
+
+}
@@ -0,0 +1,93 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DISPLAYQUEUES_H_INCLUDED__
+#define __DISPLAYQUEUES_H_INCLUDED__
+
+#include "meter.h"
+#include "analysisring.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace Igorski {
+
+// the queues written by the processor and read by the controller for display purposes
+
+struct DisplayQueues {
+    Meter::Fifo* meter;
+    OutputAnalysisRing* analysis;
+};
+
+/**
+ * The DisplayQueueRegistry shares the display queues of a processor with its controller.
+ * Rather than sending the location of the queues (which is meaningless - and unsafe to
+ * dereference - when the controller lives in another process or module, or when the
+ * processor has since been destroyed), the processor registers its queues and sends the
+ * resulting token. The controller can only access the queues while they are registered
+ * within the same module, otherwise it should fall back to the values it receives as
+ * (read-only) parameters.
+ *
+ * Tokens are never 0 (which signals no queues are available) and are salted per module load,
+ * so a token received from another module will not resolve to a local processor.
+ *
+ * The registry locks while accessing the queues, as such it should not be invoked from the audio thread.
+ */
+class DisplayQueueRegistry {
+
+    public:
+        // the registry shared by all instances within the module
+
+        static DisplayQueueRegistry* getInstance();
+
+        int64_t add( const DisplayQueues& queues );
+        void remove( int64_t token );
+
+        // invoke given callback with the queues registered under given token (the queues remain
+        // registered for the duration of the callback), returns false when the token is unknown
+
+        template <typename Callback>
+        bool access( int64_t token, Callback callback )
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+
+            auto entry = _queues.find( token );
+            if ( entry == _queues.end()) {
+                return false;
+            }
+            callback( entry->second );
+
+            return true;
+        }
+
+    private:
+        DisplayQueueRegistry();
+
+        std::mutex _mutex;
+        std::map<int64_t, DisplayQueues> _queues;
+        int64_t _salt;
+        uint32_t _counter = 0;
+};
+
+}
+
+#endif
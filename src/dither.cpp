@@ -0,0 +1,103 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "dither.h"
+#include <algorithm>
+
+namespace Igorski {
+
+// integer hash with good avalanche behaviour ("lowbias32" by Chris Wellons), being
+// branchless and free of lookups, loops over it are vectorised by the compiler
+
+static inline uint32_t hash( uint32_t x )
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+/* constructor */
+
+Dither::Dither()
+{
+    _mode  = Mode::NONE;
+    _state = &_channels[ 0 ];
+
+    setSeed( DEFAULT_SEED );
+}
+
+/* public methods */
+
+void Dither::setMode( Mode mode )
+{
+    _mode = mode;
+}
+
+void Dither::setSeed( uint32_t seed )
+{
+    _seed = seed;
+    reset();
+}
+
+void Dither::begin( int channel )
+{
+    _state = &_channels[ std::min( channel, MAX_CHANNELS - 1 ) ];
+}
+
+void Dither::reset()
+{
+    for ( int c = 0; c < MAX_CHANNELS; ++c ) {
+        Channel& channel = _channels[ c ];
+
+        channel.key      = hash( _seed ^ hash( c + 1 ));
+        channel.counter  = 0;
+        channel.position = BLOCK_SIZE; // generates on the next request
+        channel.shaped   = 0.f;
+        channel.error    = 0.f;
+    }
+}
+
+/* private methods */
+
+void Dither::generate( Channel& channel )
+{
+    // the sum of two uniformly distributed values (each in the 0 - 1 range, taken from
+    // the upper 24 bits of the hash) minus one yields a triangular distribution in the -1 to +1 range
+
+    const float scale  = 1.f / 16777216.f;
+    const uint32_t key = channel.key;
+    uint32_t counter   = channel.counter * 2;
+
+    for ( int i = 0; i < BLOCK_SIZE; ++i ) {
+        uint32_t first  = hash( key + counter + i * 2 ) >> 8;
+        uint32_t second = hash( key + counter + i * 2 + 1 ) >> 8;
+
+        channel.noise[ i ] = ( float ) ( int32_t ) first * scale + ( float ) ( int32_t ) second * scale - 1.f;
+    }
+    channel.counter += BLOCK_SIZE;
+    channel.position = 0;
+}
+
+}
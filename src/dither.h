@@ -0,0 +1,118 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DITHER_H_INCLUDED__
+#define __DITHER_H_INCLUDED__
+
+#include <cstdint>
+
+namespace Igorski {
+
+/**
+ * Dither provides the noise added prior to quantization (e.g. by the BitCrusher) so that low
+ * resolutions yield noise rather than distortion correlated with the signal. The noise has a
+ * triangular probability density function (TPDF) spanning -1 to +1 step of the quantizer and
+ * can optionally be shaped (first order error feedback, moving the noise towards the highs).
+ *
+ * Noise is generated BLOCK_SIZE values at a time for each channel by a counter-based generator
+ * (a hash of the seed, channel and sample position), as such the sequence does not depend on
+ * the size of the processed blocks and renders are reproducible for a given seed (see reset()).
+ */
+class Dither {
+
+    public:
+        static constexpr int MAX_CHANNELS = 8;
+        static constexpr int BLOCK_SIZE   = 64;
+        static constexpr uint32_t DEFAULT_SEED = 0x2f6b0a41;
+
+        enum class Mode {
+            NONE = 0,
+            TPDF,
+            SHAPED
+        };
+
+        Dither();
+
+        Mode getMode() const { return _mode; }
+        void setMode( Mode mode );
+
+        // restarts the noise sequence for given seed
+        void setSeed( uint32_t seed );
+
+        // select the channel for the next calls to next() and shape()
+        void begin( int channel );
+
+        // the next noise value (in the -1 to +1 range, to be scaled by the step size of the quantizer)
+
+        inline float next()
+        {
+            if ( _state->position == BLOCK_SIZE ) {
+                generate( *_state );
+            }
+            return _state->noise[ _state->position++ ];
+        }
+
+        // apply the error feedback to given value (in the units of the quantizer) prior to adding the noise
+        // and quantizing it, after which the quantized value must be passed to feedback() (along with the step size)
+
+        inline float shape( float value )
+        {
+            if ( _mode == Mode::SHAPED ) {
+                value -= _state->error;
+            }
+            _state->shaped = value;
+            return value;
+        }
+
+        inline void feedback( float quantized, float step )
+        {
+            if ( _mode == Mode::SHAPED ) {
+                // the error is bounded to prevent it from building up when the quantizer clips
+                float error = quantized - _state->shaped;
+                _state->error = error > step ? step : ( error < -step ? -step : error );
+            }
+        }
+
+        // restarts the noise sequence and clears the error feedback
+        void reset();
+
+    private:
+        struct Channel {
+            float noise[ BLOCK_SIZE ];
+            uint32_t key;     // derived from the seed and channel index
+            uint32_t counter; // position within the noise sequence
+            int position;     // within noise
+            float shaped;
+            float error;
+        };
+
+        Mode _mode;
+        uint32_t _seed;
+        Channel _channels[ MAX_CHANNELS ];
+        Channel* _state;
+
+        void generate( Channel& channel );
+};
+
+}
+
+#endif
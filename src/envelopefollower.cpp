@@ -0,0 +1,75 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "envelopefollower.h"
+#include <math.h>
+
+namespace Igorski {
+
+/* constructor */
+
+EnvelopeFollower::EnvelopeFollower( float attackMs, float releaseMs )
+{
+    _sampleRate = 44100.f;
+    _attackMs   = attackMs;
+    _releaseMs  = releaseMs;
+    _envelope   = 0.f;
+
+    recalculate();
+}
+
+/* public methods */
+
+void EnvelopeFollower::setSampleRate( float sampleRate )
+{
+    _sampleRate = sampleRate;
+    recalculate();
+}
+
+void EnvelopeFollower::setAttack( float attackMs )
+{
+    _attackMs = attackMs;
+    recalculate();
+}
+
+void EnvelopeFollower::setRelease( float releaseMs )
+{
+    _releaseMs = releaseMs;
+    recalculate();
+}
+
+void EnvelopeFollower::reset()
+{
+    _envelope = 0.f;
+}
+
+/* private methods */
+
+void EnvelopeFollower::recalculate()
+{
+    // one-pole coefficients, reaching ~63% of the target within given time
+
+    _attackCoefficient  = expf( -1000.f / ( fmaxf( 0.01f, _attackMs )  * _sampleRate ));
+    _releaseCoefficient = expf( -1000.f / ( fmaxf( 0.01f, _releaseMs ) * _sampleRate ));
+}
+
+}
@@ -0,0 +1,71 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __ENVELOPEFOLLOWER_H_INCLUDED__
+#define __ENVELOPEFOLLOWER_H_INCLUDED__
+
+namespace Igorski {
+
+/**
+ * EnvelopeFollower tracks the amplitude of a (sidechain) signal, e.g. to
+ * duck or modulate the effect by a kick drum or bus signal. Multiple channels
+ * are linked (the loudest channel determines the envelope).
+ *
+ * Rectification is performed as a branchless loop across the block (which the
+ * compiler vectorises), only the one-pole attack/release smoothing is scalar
+ * as it is recursive by nature.
+ */
+class EnvelopeFollower {
+
+    public:
+        EnvelopeFollower( float attackMs, float releaseMs );
+
+        void setSampleRate( float sampleRate );
+        void setAttack( float attackMs );
+        void setRelease( float releaseMs );
+
+        // writes the envelope of given channels (starting at offset) into envelope,
+        // which must be able to hold bufferSize samples
+
+        template <typename SampleType>
+        void process( SampleType** channels, int numChannels, int offset, int bufferSize, float* envelope );
+
+        float getEnvelope() const { return _envelope; }
+
+        void reset();
+
+    private:
+        void recalculate();
+
+        float _sampleRate;
+        float _attackMs;
+        float _releaseMs;
+        float _attackCoefficient;
+        float _releaseCoefficient;
+        float _envelope;
+};
+
+}
+
+#include "envelopefollower.tcc"
+
+#endif
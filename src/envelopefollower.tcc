@@ -0,0 +1,72 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "denormals.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Igorski
+{
+template <typename SampleType>
+void EnvelopeFollower::process( SampleType** channels, int numChannels, int offset, int bufferSize, float* envelope )
+{
+    // 1. rectify, linking all channels by their maximum
+    // non-finite and excessive values (e.g. corrupt sidechain input) are ignored
+
+    const float MAX_LEVEL = 16.f;
+
+    if ( numChannels == 0 ) {
+        std::fill( envelope, envelope + bufferSize, 0.f );
+    }
+
+    for ( int c = 0; c < numChannels; ++c )
+    {
+        const SampleType* channel = channels[ c ] + offset;
+
+        if ( c == 0 ) {
+            for ( int i = 0; i < bufferSize; ++i ) {
+                float level = std::fabs(( float ) channel[ i ]);
+                envelope[ i ] = level <= MAX_LEVEL ? level : 0.f;
+            }
+            continue;
+        }
+        for ( int i = 0; i < bufferSize; ++i ) {
+            float level = std::fabs(( float ) channel[ i ]);
+            envelope[ i ] = std::max( envelope[ i ], level <= MAX_LEVEL ? level : 0.f );
+        }
+    }
+
+    // 2. smooth the rectified signal
+
+    float env = _envelope;
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        float level = envelope[ i ];
+        float coefficient = level > env ? _attackCoefficient : _releaseCoefficient;
+
+        env = level + coefficient * ( env - level );
+        envelope[ i ] = env;
+    }
+    _envelope = Denormals::flush( env );
+}
+
+}
@@ -0,0 +1,122 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "fft.h"
+#include "kernels/kernels.h"
+#include <math.h>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+FFT::FFT( int size )
+: _size( size )
+, _stages( 0 )
+, _bitReverse( size )
+, _real( size )
+, _imag( size )
+{
+    while (( 1 << _stages ) < _size ) {
+        ++_stages;
+    }
+
+    for ( int i = 0; i < _size; ++i ) {
+        int reversed = 0;
+        for ( int b = 0; b < _stages; ++b ) {
+            reversed |= (( i >> b ) & 1 ) << ( _stages - 1 - b );
+        }
+        _bitReverse[ i ] = reversed;
+    }
+
+    // twiddle factors for each stage (of half size 1, 2, 4 ... size / 2) stored back to back
+
+    const double PI = 3.141592653589793;
+
+    for ( int half = 1; half < _size; half <<= 1 ) {
+        for ( int j = 0; j < half; ++j ) {
+            double angle = -PI * j / half;
+            _twiddleReal.push_back(( float ) cos( angle ));
+            _twiddleImag.push_back(( float ) sin( angle ));
+        }
+    }
+}
+
+FFT::~FFT()
+{
+    // nowt...
+}
+
+/* public methods */
+
+void FFT::forward( float* real, float* imag )
+{
+    // bit reversal permutation
+
+    for ( int i = 0; i < _size; ++i ) {
+        int j = _bitReverse[ i ];
+        if ( j > i ) {
+            float tempReal = real[ i ];
+            float tempImag = imag[ i ];
+            real[ i ] = real[ j ];
+            imag[ i ] = imag[ j ];
+            real[ j ] = tempReal;
+            imag[ j ] = tempImag;
+        }
+    }
+
+    // butterflies, for each stage (of half span 1, 2, 4 ... size / 2)
+
+    const Kernels::Table& kernels = Kernels::get();
+    const float* twiddleReal = _twiddleReal.data();
+    const float* twiddleImag = _twiddleImag.data();
+
+    for ( int half = 1; half < _size; half <<= 1 ) {
+        kernels.fftButterflies( real, imag, twiddleReal, twiddleImag, half, _size );
+
+        twiddleReal += half;
+        twiddleImag += half;
+    }
+}
+
+void FFT::inverse( float* real, float* imag )
+{
+    // the forward transform of the data with its real and imaginary parts
+    // swapped equals the inverse transform with its parts swapped
+
+    forward( imag, real );
+}
+
+void FFT::magnitudes( const float* input, float* magnitudes )
+{
+    for ( int i = 0; i < _size; ++i ) {
+        _real[ i ] = input[ i ];
+        _imag[ i ] = 0.f;
+    }
+
+    forward( _real.data(), _imag.data());
+
+    for ( int i = 0, l = _size / 2 + 1; i < l; ++i ) {
+        magnitudes[ i ] = sqrtf( _real[ i ] * _real[ i ] + _imag[ i ] * _imag[ i ] );
+    }
+}
+
+}
@@ -0,0 +1,77 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __FFT_H_INCLUDED__
+#define __FFT_H_INCLUDED__
+
+#include <vector>
+
+namespace Igorski {
+
+/**
+ * Radix-2 complex Fast Fourier Transform of a fixed (power of two) size.
+ *
+ * Data is kept in split format (separate real and imaginary arrays) and the twiddle
+ * factors are stored contiguously per stage, so the butterfly loops operate on
+ * contiguous memory without shuffles (the butterflies of each stage are applied
+ * by the vectorised kernel for the CPU, see kernels.h).
+ * All memory is allocated upon construction, transforms do not allocate.
+ */
+class FFT {
+
+    public:
+        FFT( int size ); // size must be a power of two
+        ~FFT();
+
+        int getSize() const { return _size; }
+
+        // in-place forward transform of given split complex data (both arrays hold size values)
+
+        void forward( float* real, float* imag );
+
+        // in-place inverse transform of given split complex data, note the
+        // result is not normalized (e.g. it is scaled by the size of the transform)
+
+        void inverse( float* real, float* imag );
+
+        // forward transform of given real valued input (holding size values) writing
+        // the magnitudes of the first size / 2 + 1 bins (DC to Nyquist) into magnitudes
+
+        void magnitudes( const float* input, float* magnitudes );
+
+    private:
+        int _size;
+        int _stages;
+
+        std::vector<int> _bitReverse;
+        std::vector<float> _twiddleReal; // per stage, size - 1 values in total
+        std::vector<float> _twiddleImag;
+
+        // buffers used by magnitudes()
+
+        std::vector<float> _real;
+        std::vector<float> _imag;
+};
+
+}
+
+#endif
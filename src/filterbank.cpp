@@ -0,0 +1,212 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "filterbank.h"
+#include "global.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace Igorski {
+
+static const float Q = .7071f; // Butterworth response for the high- and low-pass sections
+
+FilterBank::FilterBank( int amountOfChannels )
+{
+    _amountOfChannels = std::min( amountOfChannels, MAX_CHANNELS );
+    _channel          = 0;
+    _sampleRate       = 44100.f;
+
+    _highPass = MIN_HIGH_PASS;
+    _lowPass  = MAX_LOW_PASS;
+    _tilt     = 0.f;
+
+    _isActive        = false;
+    _isInterpolating = false;
+
+    calculateCoefficients();
+
+    for ( int s = 0; s < SECTIONS; ++s ) {
+        _start[ s ]        = _target[ s ];
+        _coefficients[ s ] = _target[ s ];
+        _delta[ s ]        = { 0.f, 0.f, 0.f, 0.f, 0.f };
+    }
+    _hasChanged = false;
+
+    reset();
+}
+
+void FilterBank::setSampleRate( float sampleRate )
+{
+    _sampleRate = sampleRate;
+    _hasChanged = true;
+}
+
+void FilterBank::setHighPass( float frequency )
+{
+    if ( frequency != _highPass ) {
+        _highPass   = frequency;
+        _hasChanged = true;
+    }
+}
+
+void FilterBank::setLowPass( float frequency )
+{
+    if ( frequency != _lowPass ) {
+        _lowPass    = frequency;
+        _hasChanged = true;
+    }
+}
+
+void FilterBank::setTilt( float gain )
+{
+    if ( gain != _tilt ) {
+        _tilt       = gain;
+        _hasChanged = true;
+    }
+}
+
+void FilterBank::prepare( int bufferSize )
+{
+    bool wasActive = _isActive;
+
+    // the interpolation of the previous block has ended at the target
+
+    for ( int s = 0; s < SECTIONS; ++s ) {
+        _start[ s ] = _target[ s ];
+    }
+    _isInterpolating = false;
+
+    if ( _hasChanged ) {
+        _hasChanged = false;
+        calculateCoefficients();
+
+        float scale = 1.f / ( float ) std::max( 1, bufferSize );
+
+        for ( int s = 0; s < SECTIONS; ++s ) {
+            _delta[ s ] = {
+                ( _target[ s ].b0 - _start[ s ].b0 ) * scale,
+                ( _target[ s ].b1 - _start[ s ].b1 ) * scale,
+                ( _target[ s ].b2 - _start[ s ].b2 ) * scale,
+                ( _target[ s ].a1 - _start[ s ].a1 ) * scale,
+                ( _target[ s ].a2 - _start[ s ].a2 ) * scale
+            };
+        }
+        _isInterpolating = true;
+    }
+    _isActive = _isInterpolating || !isNeutral();
+
+    // start from silence when the filters (re)engage
+
+    if ( _isActive && !wasActive ) {
+        reset();
+    }
+}
+
+void FilterBank::begin( int channel )
+{
+    _channel = std::min( channel, _amountOfChannels - 1 );
+
+    // each channel interpolates from the coefficients at the start of the block
+
+    for ( int s = 0; s < SECTIONS; ++s ) {
+        _coefficients[ s ] = _start[ s ];
+    }
+}
+
+void FilterBank::reset()
+{
+    memset( _state, 0, sizeof( _state ));
+}
+
+/* private methods */
+
+bool FilterBank::isNeutral() const
+{
+    return _highPass <= MIN_HIGH_PASS && _lowPass >= MAX_LOW_PASS && fabs( _tilt ) < .01f;
+}
+
+void FilterBank::calculateCoefficients()
+{
+    // RBJ Audio EQ Cookbook formulae, normalized by a0
+    // sections in their neutral position pass the signal unchanged
+
+    const Coefficients NEUTRAL = { 1.f, 0.f, 0.f, 0.f, 0.f };
+    float maxFrequency = _sampleRate * .45f;
+
+    // high-pass
+
+    if ( _highPass <= MIN_HIGH_PASS ) {
+        _target[ HIGH_PASS ] = NEUTRAL;
+    } else {
+        float w0    = VST::TWO_PI * std::min( _highPass, maxFrequency ) / _sampleRate;
+        float cosw  = cosf( w0 );
+        float alpha = sinf( w0 ) / ( 2.f * Q );
+        float a0    = 1.f + alpha;
+
+        _target[ HIGH_PASS ] = {
+            (( 1.f + cosw ) / 2.f ) / a0, -( 1.f + cosw ) / a0, (( 1.f + cosw ) / 2.f ) / a0,
+            ( -2.f * cosw ) / a0, ( 1.f - alpha ) / a0
+        };
+    }
+
+    // low-pass
+
+    if ( _lowPass >= MAX_LOW_PASS ) {
+        _target[ LOW_PASS ] = NEUTRAL;
+    } else {
+        float w0    = VST::TWO_PI * std::min( _lowPass, maxFrequency ) / _sampleRate;
+        float cosw  = cosf( w0 );
+        float alpha = sinf( w0 ) / ( 2.f * Q );
+        float a0    = 1.f + alpha;
+
+        _target[ LOW_PASS ] = {
+            (( 1.f - cosw ) / 2.f ) / a0, ( 1.f - cosw ) / a0, (( 1.f - cosw ) / 2.f ) / a0,
+            ( -2.f * cosw ) / a0, ( 1.f - alpha ) / a0
+        };
+    }
+
+    // tilt: a high shelf boosting by the tilt gain, attenuated by half the gain so the
+    // lows are cut by as much as the highs are boosted (unity gain at the pivot)
+
+    if ( fabs( _tilt ) < .01f ) {
+        _target[ TILT ] = NEUTRAL;
+    } else {
+        float A     = powf( 10.f, _tilt / 40.f );
+        float w0    = VST::TWO_PI * std::min( TILT_FREQUENCY, maxFrequency ) / _sampleRate;
+        float cosw  = cosf( w0 );
+        float alpha = sinf( w0 ) / 2.f * sqrtf( 2.f ); // shelf slope of 1
+        float sqrtA = sqrtf( A );
+        float a0    = ( A + 1.f ) - ( A - 1.f ) * cosw + 2.f * sqrtA * alpha;
+        float trim  = 1.f / A;
+
+        _target[ TILT ] = {
+            trim * A * (( A + 1.f ) + ( A - 1.f ) * cosw + 2.f * sqrtA * alpha ) / a0,
+            trim * -2.f * A * (( A - 1.f ) + ( A + 1.f ) * cosw ) / a0,
+            trim * A * (( A + 1.f ) + ( A - 1.f ) * cosw - 2.f * sqrtA * alpha ) / a0,
+            2.f * (( A - 1.f ) - ( A + 1.f ) * cosw ) / a0,
+            (( A + 1.f ) - ( A - 1.f ) * cosw - 2.f * sqrtA * alpha ) / a0
+        };
+    }
+}
+
+}
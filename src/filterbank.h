@@ -0,0 +1,123 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __FILTERBANK_H_INCLUDED__
+#define __FILTERBANK_H_INCLUDED__
+
+namespace Igorski {
+
+/**
+ * FilterBank provides tone shaping through a cascade of biquad sections (high-pass, low-pass
+ * and a tilt equalizer pivoting around TILT_FREQUENCY) in transposed direct form II, operating
+ * as a per sample stage within an effect chain (see chain.h).
+ *
+ * Coefficients are only recalculated when a parameter has changed, after which these are
+ * interpolated over the next block. When all sections are in their neutral position, the
+ * FilterBank doesn't process at all.
+ */
+class FilterBank {
+
+    public:
+        static constexpr int MAX_CHANNELS = 8;
+
+        static constexpr float MIN_HIGH_PASS  = 20.f;    // in Hz, at which the high-pass is disabled
+        static constexpr float MAX_LOW_PASS   = 20000.f; // in Hz, at which the low-pass is disabled
+        static constexpr float TILT_FREQUENCY = 1000.f;  // in Hz
+
+        FilterBank( int amountOfChannels );
+
+        void setSampleRate( float sampleRate );
+
+        void setHighPass( float frequency ); // in Hz
+        void setLowPass( float frequency );  // in Hz
+        void setTilt( float gain );          // in dB between the lows and highs, positive values boost the highs
+
+        // invoke once per block prior to processing its channels (calculates
+        // the coefficient interpolation across given amount of samples)
+
+        void prepare( int bufferSize );
+
+        // select the channel for the next tick() calls
+
+        void begin( int channel );
+
+        inline float tick( float sample, int /*index*/ )
+        {
+            if ( !_isActive )
+                return sample;
+
+            float* state = _state[ _channel ];
+
+            for ( int s = 0; s < SECTIONS; ++s, state += 2 ) {
+                Coefficients& c = _coefficients[ s ];
+
+                float output = c.b0 * sample + state[ 0 ];
+                state[ 0 ]   = c.b1 * sample - c.a1 * output + state[ 1 ];
+                state[ 1 ]   = c.b2 * sample - c.a2 * output;
+                sample       = output;
+
+                if ( _isInterpolating ) {
+                    c.b0 += _delta[ s ].b0;
+                    c.b1 += _delta[ s ].b1;
+                    c.b2 += _delta[ s ].b2;
+                    c.a1 += _delta[ s ].a1;
+                    c.a2 += _delta[ s ].a2;
+                }
+            }
+            return sample;
+        }
+
+        // clear the filter state while retaining the settings
+        void reset();
+
+    private:
+        enum { HIGH_PASS = 0, LOW_PASS, TILT, SECTIONS };
+
+        struct Coefficients {
+            float b0, b1, b2, a1, a2; // normalized by a0
+        };
+
+        int _amountOfChannels;
+        int _channel;
+        float _sampleRate;
+
+        float _highPass;
+        float _lowPass;
+        float _tilt;
+        bool _hasChanged;
+        bool _isActive;
+        bool _isInterpolating;
+
+        Coefficients _target[ SECTIONS ];       // for the current settings
+        Coefficients _start[ SECTIONS ];        // at the start of the current block
+        Coefficients _delta[ SECTIONS ];        // per sample increment across the current block
+        Coefficients _coefficients[ SECTIONS ]; // as applied during tick()
+
+        float _state[ MAX_CHANNELS ][ SECTIONS * 2 ];
+
+        void calculateCoefficients();
+        bool isNeutral() const;
+};
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "kernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if KERNELS_X86 && defined( _MSC_VER )
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Igorski {
+namespace Kernels {
+
+namespace {
+    const char* ISA_NAMES[ ISA_COUNT ] = { "scalar", "sse2", "avx2", "avx512", "neon" };
+
+    Table createScalarTable()
+    {
+        Table table;
+        fillScalar( table );
+        return table;
+    }
+
+    // the scalar reference is in place until init() is invoked
+
+    Table table = createScalarTable();
+
+#if KERNELS_X86 && defined( _MSC_VER )
+    // whether the operating system saves the given (AVX) register state upon context switches
+
+    bool hasOSSupport( unsigned long long mask )
+    {
+        int info[ 4 ];
+        __cpuid( info, 1 );
+
+        bool hasXSave = ( info[ 2 ] & ( 1 << 27 )) != 0; // OSXSAVE
+        return hasXSave && ( _xgetbv( 0 ) & mask ) == mask;
+    }
+#endif
+}
+
+void init()
+{
+    ISA isa = ISA::SCALAR;
+
+    // the most capable supported instruction set
+
+    for ( int i = ISA_COUNT - 1; i > 0; --i ) {
+        if ( isSupported(( ISA ) i )) {
+            isa = ( ISA ) i;
+            break;
+        }
+    }
+
+    // apply the override (e.g. to compare the variants), when supported
+
+    const char* override = getenv( "KERNELS_ISA" );
+    if ( override != nullptr ) {
+        for ( int i = 0; i < ISA_COUNT; ++i ) {
+            if ( strcmp( override, ISA_NAMES[ i ] ) == 0 && isSupported(( ISA ) i )) {
+                isa = ( ISA ) i;
+            }
+        }
+    }
+    init( isa );
+}
+
+void init( ISA isa )
+{
+    table = getTable( isa );
+}
+
+const Table& get()
+{
+    return table;
+}
+
+Table getTable( ISA isa )
+{
+    Table result = createScalarTable();
+
+    if ( !isSupported( isa )) {
+        return result;
+    }
+
+    // the x86 instruction sets are supersets of each other, variants that are not
+    // implemented for an instruction set fall back to those of a lesser instruction set
+
+    bool filled = false;
+    switch ( isa ) {
+        case ISA::SCALAR:
+            filled = true;
+            break;
+        case ISA::SSE2:
+            filled = fillSSE2( result );
+            break;
+        case ISA::AVX2:
+            filled = fillSSE2( result ) && fillAVX2( result );
+            break;
+        case ISA::AVX512:
+            filled = fillSSE2( result ) && fillAVX2( result ) && fillAVX512( result );
+            break;
+        case ISA::NEON:
+            filled = fillNEON( result );
+            break;
+    }
+    if ( !filled ) {
+        return createScalarTable();
+    }
+    result.isa = isa;
+
+    return result;
+}
+
+bool isSupported( ISA isa )
+{
+    switch ( isa ) {
+        case ISA::SCALAR:
+            return true;
+#if KERNELS_X86
+#if defined( __GNUC__ ) || defined( __clang__ )
+        case ISA::SSE2:
+            return __builtin_cpu_supports( "sse2" );
+        case ISA::AVX2:
+            return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" );
+        case ISA::AVX512:
+            return __builtin_cpu_supports( "avx512f" ) && isSupported( ISA::AVX2 );
+#else
+        case ISA::SSE2:
+        {
+            int info[ 4 ];
+            __cpuid( info, 1 );
+            return ( info[ 3 ] & ( 1 << 26 )) != 0;
+        }
+        case ISA::AVX2:
+        {
+            int info[ 4 ];
+            __cpuid( info, 1 );
+            bool hasFMA = ( info[ 2 ] & ( 1 << 12 )) != 0;
+            __cpuidex( info, 7, 0 );
+            bool hasAVX2 = ( info[ 1 ] & ( 1 << 5 )) != 0;
+            return hasFMA && hasAVX2 && hasOSSupport( 0x6 ); // XMM and YMM state
+        }
+        case ISA::AVX512:
+        {
+            int info[ 4 ];
+            __cpuidex( info, 7, 0 );
+            bool hasAVX512 = ( info[ 1 ] & ( 1 << 16 )) != 0;
+            return hasAVX512 && isSupported( ISA::AVX2 ) && hasOSSupport( 0xE6 ); // including opmask and ZMM state
+        }
+#endif
+#elif KERNELS_NEON
+        case ISA::NEON:
+            return true; // mandatory on arm64
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* getName( ISA isa )
+{
+    return ISA_NAMES[( int ) isa ];
+}
+
+}
+}
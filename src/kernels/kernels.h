@@ -0,0 +1,135 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __KERNELS_H_INCLUDED__
+#define __KERNELS_H_INCLUDED__
+
+namespace Igorski {
+
+/**
+ * Kernels provides the vectorised inner loops of the DSP processors, selected at runtime for
+ * the instruction set of the CPU the plugin runs on (a single binary supports a wide range of CPUs).
+ *
+ * Each instruction set has its own translation unit (kernels_{isa}.cpp), where its functions are
+ * compiled for that instruction set only (see KERNELS_TARGET), the remainder of the plugin is compiled
+ * for the baseline of the architecture. The dispatch table is filled once upon module initialization
+ * (see vstentry.cpp) with the variants of the most capable supported instruction set. Until then
+ * (e.g. when the processors are used outside of the plugin) the scalar reference variants are used.
+ *
+ * The KERNELS_ISA environment variable overrides the detected instruction set (e.g. "scalar",
+ * "sse2", "avx2", "avx512" or "neon") for testing, an unsupported value is ignored.
+ *
+ * To add a kernel, add its function pointer to Table, provide a scalar reference implementation
+ * and (optionally) vectorised variants, unimplemented variants remain at the scalar reference.
+ * Vectorised variants sum in a different order, their results match the scalar reference within
+ * floating point rounding rather than bit for bit (see test/kernels, which verifies each supported
+ * variant against the scalar reference).
+ */
+namespace Kernels {
+
+    enum class ISA {
+        SCALAR = 0,
+        SSE2,
+        AVX2,   // including FMA
+        AVX512, // AVX-512F
+        NEON
+    };
+
+    static constexpr int ISA_COUNT = 5;
+
+    struct Table {
+        ISA isa;
+
+        // returns the sum of the products of a and b
+
+        float ( *dotProduct )( const float* a, const float* b, int size );
+
+        // accumulates the product of the complex values a and b (stored as separate real and imaginary arrays) into out
+
+        void ( *complexMultiplyAccumulate )(
+            float* outReal, float* outImag, const float* aReal, const float* aImag,
+            const float* bReal, const float* bImag, int size
+        );
+
+        // applies the radix-2 butterflies of a single FFT stage (of given half span) to split complex
+        // data of given size, twiddles holds the half factors of the stage (see FFT::forward())
+
+        void ( *fftButterflies )(
+            float* real, float* imag, const float* twiddleReal, const float* twiddleImag, int half, int size
+        );
+
+        // feeds back the delayed signal in tap into the input (writing the result into tap, to be
+        // written into the delay line) and mixes it into samples (see Delay::process())
+
+        void ( *feedbackMix )( float* samples, float* tap, float feedback, float mix, int size );
+    };
+
+    // detect the instruction set (or apply the KERNELS_ISA override) and fill the dispatch table
+    // should be invoked once prior to processing, e.g. upon module initialization
+
+    void init();
+
+    // fill the dispatch table with the variants of given instruction set (the scalar reference when
+    // it is not supported by the CPU), ignoring the KERNELS_ISA override. Renders that are to be
+    // compared bit for bit (e.g. golden files, see test/golden) use ISA::SCALAR, as the vectorised
+    // variants (using fused multiply-add where available) differ from it in rounding
+
+    void init( ISA isa );
+
+    // the dispatch table in use (valid for the lifetime of the module)
+
+    const Table& get();
+
+    // the variants for given instruction set (the scalar reference when it is not supported by the CPU)
+
+    Table getTable( ISA isa );
+
+    bool isSupported( ISA isa );
+    const char* getName( ISA isa );
+
+    // the variants for each instruction set (see kernels_{isa}.cpp), these return false when the
+    // instruction set is not available for the architecture the plugin is compiled for
+
+    void fillScalar( Table& table );
+    bool fillSSE2( Table& table );
+    bool fillAVX2( Table& table );
+    bool fillAVX512( Table& table );
+    bool fillNEON( Table& table );
+}
+}
+
+// compiles the functions of a translation unit for given instruction set (GCC and Clang), MSVC
+// allows the use of all intrinsics of the architecture without additional compiler flags
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define KERNELS_TARGET( isa ) __attribute__(( target( isa )))
+#else
+#define KERNELS_TARGET( isa )
+#endif
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+#define KERNELS_X86 1
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+#define KERNELS_NEON 1
+#endif
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "kernels.h"
+
+#if KERNELS_X86
+
+#include <immintrin.h>
+
+namespace Igorski {
+namespace Kernels {
+
+namespace {
+    KERNELS_TARGET( "avx2,fma" )
+    float dotProduct( const float* a, const float* b, int size )
+    {
+        // two accumulators hide the latency of the fused multiply-add
+
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        int i = 0;
+
+        for ( ; i + 16 <= size; i += 16 ) {
+            sum1 = _mm256_fmadd_ps( _mm256_loadu_ps( a + i ),     _mm256_loadu_ps( b + i ),     sum1 );
+            sum2 = _mm256_fmadd_ps( _mm256_loadu_ps( a + i + 8 ), _mm256_loadu_ps( b + i + 8 ), sum2 );
+        }
+        for ( ; i + 8 <= size; i += 8 ) {
+            sum1 = _mm256_fmadd_ps( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ), sum1 );
+        }
+        __m256 sum8 = _mm256_add_ps( sum1, sum2 );
+
+        // horizontal sum of the eight lanes
+
+        __m128 sum4 = _mm_add_ps( _mm256_castps256_ps128( sum8 ), _mm256_extractf128_ps( sum8, 1 ));
+        sum4 = _mm_add_ps( sum4, _mm_movehl_ps( sum4, sum4 ));
+        sum4 = _mm_add_ss( sum4, _mm_shuffle_ps( sum4, sum4, 1 ));
+
+        float result = _mm_cvtss_f32( sum4 );
+        for ( ; i < size; ++i ) {
+            result += a[ i ] * b[ i ];
+        }
+        return result;
+    }
+
+    KERNELS_TARGET( "avx2,fma" )
+    void complexMultiplyAccumulate( float* outReal, float* outImag, const float* aReal, const float* aImag,
+                                    const float* bReal, const float* bImag, int size )
+    {
+        int i = 0;
+        for ( ; i + 8 <= size; i += 8 ) {
+            __m256 ar = _mm256_loadu_ps( aReal + i );
+            __m256 ai = _mm256_loadu_ps( aImag + i );
+            __m256 br = _mm256_loadu_ps( bReal + i );
+            __m256 bi = _mm256_loadu_ps( bImag + i );
+
+            __m256 real = _mm256_fmadd_ps( ar, br, _mm256_loadu_ps( outReal + i ));
+            __m256 imag = _mm256_fmadd_ps( ar, bi, _mm256_loadu_ps( outImag + i ));
+
+            _mm256_storeu_ps( outReal + i, _mm256_fnmadd_ps( ai, bi, real ));
+            _mm256_storeu_ps( outImag + i, _mm256_fmadd_ps( ai, br, imag ));
+        }
+        for ( ; i < size; ++i ) {
+            outReal[ i ] += aReal[ i ] * bReal[ i ] - aImag[ i ] * bImag[ i ];
+            outImag[ i ] += aReal[ i ] * bImag[ i ] + aImag[ i ] * bReal[ i ];
+        }
+    }
+
+    KERNELS_TARGET( "avx2,fma" )
+    void fftButterflies( float* real, float* imag, const float* twiddleReal, const float* twiddleImag, int half, int size )
+    {
+        for ( int start = 0; start < size; start += half * 2 ) {
+            float* evenReal = real + start;
+            float* evenImag = imag + start;
+            float* oddReal  = evenReal + half;
+            float* oddImag  = evenImag + half;
+            int j = 0;
+
+            for ( ; j + 8 <= half; j += 8 ) {
+                __m256 oddRe  = _mm256_loadu_ps( oddReal + j );
+                __m256 oddIm  = _mm256_loadu_ps( oddImag + j );
+                __m256 twRe   = _mm256_loadu_ps( twiddleReal + j );
+                __m256 twIm   = _mm256_loadu_ps( twiddleImag + j );
+                __m256 evenRe = _mm256_loadu_ps( evenReal + j );
+                __m256 evenIm = _mm256_loadu_ps( evenImag + j );
+
+                __m256 tr = _mm256_fmsub_ps( oddRe, twRe, _mm256_mul_ps( oddIm, twIm ));
+                __m256 ti = _mm256_fmadd_ps( oddRe, twIm, _mm256_mul_ps( oddIm, twRe ));
+
+                _mm256_storeu_ps( oddReal + j,  _mm256_sub_ps( evenRe, tr ));
+                _mm256_storeu_ps( oddImag + j,  _mm256_sub_ps( evenIm, ti ));
+                _mm256_storeu_ps( evenReal + j, _mm256_add_ps( evenRe, tr ));
+                _mm256_storeu_ps( evenImag + j, _mm256_add_ps( evenIm, ti ));
+            }
+
+            // the remainder, or the whole span in the first stages (of a half span below the vector width)
+
+            for ( ; j < half; ++j ) {
+                float tr = oddReal[ j ] * twiddleReal[ j ] - oddImag[ j ] * twiddleImag[ j ];
+                float ti = oddReal[ j ] * twiddleImag[ j ] + oddImag[ j ] * twiddleReal[ j ];
+
+                oddReal[ j ]   = evenReal[ j ] - tr;
+                oddImag[ j ]   = evenImag[ j ] - ti;
+                evenReal[ j ] += tr;
+                evenImag[ j ] += ti;
+            }
+        }
+    }
+
+    KERNELS_TARGET( "avx2,fma" )
+    void feedbackMix( float* samples, float* tap, float feedback, float mix, int size )
+    {
+        __m256 fb  = _mm256_set1_ps( feedback );
+        __m256 wet = _mm256_set1_ps( mix );
+        int i = 0;
+
+        for ( ; i + 8 <= size; i += 8 ) {
+            __m256 delayed = _mm256_loadu_ps( tap + i );
+            __m256 input   = _mm256_loadu_ps( samples + i );
+
+            _mm256_storeu_ps( tap + i,     _mm256_fmadd_ps( delayed, fb, input ));
+            _mm256_storeu_ps( samples + i, _mm256_fmadd_ps( delayed, wet, input ));
+        }
+        for ( ; i < size; ++i ) {
+            float delayed = tap[ i ];
+            tap[ i ]      = samples[ i ] + delayed * feedback;
+            samples[ i ] += delayed * mix;
+        }
+    }
+}
+
+bool fillAVX2( Table& table )
+{
+    table.dotProduct                = &dotProduct;
+    table.complexMultiplyAccumulate = &complexMultiplyAccumulate;
+    table.fftButterflies            = &fftButterflies;
+    table.feedbackMix               = &feedbackMix;
+
+    return true;
+}
+
+}
+}
+
+#else
+
+namespace Igorski {
+namespace Kernels {
+
+bool fillAVX2( Table& /*table*/ )
+{
+    return false;
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "kernels.h"
+
+#if KERNELS_X86
+
+#include <immintrin.h>
+
+namespace Igorski {
+namespace Kernels {
+
+namespace {
+    KERNELS_TARGET( "avx512f" )
+    float dotProduct( const float* a, const float* b, int size )
+    {
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        int i = 0;
+
+        for ( ; i + 32 <= size; i += 32 ) {
+            sum1 = _mm512_fmadd_ps( _mm512_loadu_ps( a + i ),      _mm512_loadu_ps( b + i ),      sum1 );
+            sum2 = _mm512_fmadd_ps( _mm512_loadu_ps( a + i + 16 ), _mm512_loadu_ps( b + i + 16 ), sum2 );
+        }
+
+        // the remainder is processed using a mask (masked out lanes are not read)
+
+        for ( ; i < size; i += 16 ) {
+            __mmask16 mask = ( size - i ) >= 16 ? ( __mmask16 ) 0xFFFF : ( __mmask16 ) (( 1u << ( size - i )) - 1 );
+            sum1 = _mm512_fmadd_ps( _mm512_maskz_loadu_ps( mask, a + i ), _mm512_maskz_loadu_ps( mask, b + i ), sum1 );
+        }
+        return _mm512_reduce_add_ps( _mm512_add_ps( sum1, sum2 ));
+    }
+
+    KERNELS_TARGET( "avx512f" )
+    void complexMultiplyAccumulate( float* outReal, float* outImag, const float* aReal, const float* aImag,
+                                    const float* bReal, const float* bImag, int size )
+    {
+        for ( int i = 0; i < size; i += 16 ) {
+            __mmask16 mask = ( size - i ) >= 16 ? ( __mmask16 ) 0xFFFF : ( __mmask16 ) (( 1u << ( size - i )) - 1 );
+
+            __m512 ar = _mm512_maskz_loadu_ps( mask, aReal + i );
+            __m512 ai = _mm512_maskz_loadu_ps( mask, aImag + i );
+            __m512 br = _mm512_maskz_loadu_ps( mask, bReal + i );
+            __m512 bi = _mm512_maskz_loadu_ps( mask, bImag + i );
+
+            __m512 real = _mm512_fmadd_ps( ar, br, _mm512_maskz_loadu_ps( mask, outReal + i ));
+            __m512 imag = _mm512_fmadd_ps( ar, bi, _mm512_maskz_loadu_ps( mask, outImag + i ));
+
+            _mm512_mask_storeu_ps( outReal + i, mask, _mm512_fnmadd_ps( ai, bi, real ));
+            _mm512_mask_storeu_ps( outImag + i, mask, _mm512_fmadd_ps( ai, br, imag ));
+        }
+    }
+
+    KERNELS_TARGET( "avx512f" )
+    void fftButterflies( float* real, float* imag, const float* twiddleReal, const float* twiddleImag, int half, int size )
+    {
+        for ( int start = 0; start < size; start += half * 2 ) {
+            float* evenReal = real + start;
+            float* evenImag = imag + start;
+            float* oddReal  = evenReal + half;
+            float* oddImag  = evenImag + half;
+            int j = 0;
+
+            for ( ; j + 16 <= half; j += 16 ) {
+                __m512 oddRe  = _mm512_loadu_ps( oddReal + j );
+                __m512 oddIm  = _mm512_loadu_ps( oddImag + j );
+                __m512 twRe   = _mm512_loadu_ps( twiddleReal + j );
+                __m512 twIm   = _mm512_loadu_ps( twiddleImag + j );
+                __m512 evenRe = _mm512_loadu_ps( evenReal + j );
+                __m512 evenIm = _mm512_loadu_ps( evenImag + j );
+
+                __m512 tr = _mm512_fmsub_ps( oddRe, twRe, _mm512_mul_ps( oddIm, twIm ));
+                __m512 ti = _mm512_fmadd_ps( oddRe, twIm, _mm512_mul_ps( oddIm, twRe ));
+
+                _mm512_storeu_ps( oddReal + j,  _mm512_sub_ps( evenRe, tr ));
+                _mm512_storeu_ps( oddImag + j,  _mm512_sub_ps( evenIm, ti ));
+                _mm512_storeu_ps( evenReal + j, _mm512_add_ps( evenRe, tr ));
+                _mm512_storeu_ps( evenImag + j, _mm512_add_ps( evenIm, ti ));
+            }
+
+            // the remainder, or the whole span in the first stages (of a half span below the vector width)
+
+            for ( ; j < half; ++j ) {
+                float tr = oddReal[ j ] * twiddleReal[ j ] - oddImag[ j ] * twiddleImag[ j ];
+                float ti = oddReal[ j ] * twiddleImag[ j ] + oddImag[ j ] * twiddleReal[ j ];
+
+                oddReal[ j ]   = evenReal[ j ] - tr;
+                oddImag[ j ]   = evenImag[ j ] - ti;
+                evenReal[ j ] += tr;
+                evenImag[ j ] += ti;
+            }
+        }
+    }
+
+    KERNELS_TARGET( "avx512f" )
+    void feedbackMix( float* samples, float* tap, float feedback, float mix, int size )
+    {
+        __m512 fb  = _mm512_set1_ps( feedback );
+        __m512 wet = _mm512_set1_ps( mix );
+        int i = 0;
+
+        for ( ; i + 16 <= size; i += 16 ) {
+            __m512 delayed = _mm512_loadu_ps( tap + i );
+            __m512 input   = _mm512_loadu_ps( samples + i );
+
+            _mm512_storeu_ps( tap + i,     _mm512_fmadd_ps( delayed, fb, input ));
+            _mm512_storeu_ps( samples + i, _mm512_fmadd_ps( delayed, wet, input ));
+        }
+        for ( ; i < size; ++i ) {
+            float delayed = tap[ i ];
+            tap[ i ]      = samples[ i ] + delayed * feedback;
+            samples[ i ] += delayed * mix;
+        }
+    }
+}
+
+bool fillAVX512( Table& table )
+{
+    table.dotProduct                = &dotProduct;
+    table.complexMultiplyAccumulate = &complexMultiplyAccumulate;
+    table.fftButterflies            = &fftButterflies;
+    table.feedbackMix               = &feedbackMix;
+
+    return true;
+}
+
+}
+}
+
+#else
+
+namespace Igorski {
+namespace Kernels {
+
+bool fillAVX512( Table& /*table*/ )
+{
+    return false;
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "kernels.h"
+
+#if KERNELS_NEON
+
+#include <arm_neon.h>
+
+namespace Igorski {
+namespace Kernels {
+
+namespace {
+    float dotProduct( const float* a, const float* b, int size )
+    {
+        float32x4_t sum1 = vdupq_n_f32( 0.f );
+        float32x4_t sum2 = vdupq_n_f32( 0.f );
+        int i = 0;
+
+        for ( ; i + 8 <= size; i += 8 ) {
+            sum1 = vfmaq_f32( sum1, vld1q_f32( a + i ),     vld1q_f32( b + i ));
+            sum2 = vfmaq_f32( sum2, vld1q_f32( a + i + 4 ), vld1q_f32( b + i + 4 ));
+        }
+        for ( ; i + 4 <= size; i += 4 ) {
+            sum1 = vfmaq_f32( sum1, vld1q_f32( a + i ), vld1q_f32( b + i ));
+        }
+        float result = vaddvq_f32( vaddq_f32( sum1, sum2 ));
+
+        for ( ; i < size; ++i ) {
+            result += a[ i ] * b[ i ];
+        }
+        return result;
+    }
+
+    void complexMultiplyAccumulate( float* outReal, float* outImag, const float* aReal, const float* aImag,
+                                    const float* bReal, const float* bImag, int size )
+    {
+        int i = 0;
+        for ( ; i + 4 <= size; i += 4 ) {
+            float32x4_t ar = vld1q_f32( aReal + i );
+            float32x4_t ai = vld1q_f32( aImag + i );
+            float32x4_t br = vld1q_f32( bReal + i );
+            float32x4_t bi = vld1q_f32( bImag + i );
+
+            float32x4_t real = vfmaq_f32( vld1q_f32( outReal + i ), ar, br );
+            float32x4_t imag = vfmaq_f32( vld1q_f32( outImag + i ), ar, bi );
+
+            vst1q_f32( outReal + i, vfmsq_f32( real, ai, bi ));
+            vst1q_f32( outImag + i, vfmaq_f32( imag, ai, br ));
+        }
+        for ( ; i < size; ++i ) {
+            outReal[ i ] += aReal[ i ] * bReal[ i ] - aImag[ i ] * bImag[ i ];
+            outImag[ i ] += aReal[ i ] * bImag[ i ] + aImag[ i ] * bReal[ i ];
+        }
+    }
+
+    void fftButterflies( float* real, float* imag, const float* twiddleReal, const float* twiddleImag, int half, int size )
+    {
+        for ( int start = 0; start < size; start += half * 2 ) {
+            float* evenReal = real + start;
+            float* evenImag = imag + start;
+            float* oddReal  = evenReal + half;
+            float* oddImag  = evenImag + half;
+            int j = 0;
+
+            for ( ; j + 4 <= half; j += 4 ) {
+                float32x4_t oddRe  = vld1q_f32( oddReal + j );
+                float32x4_t oddIm  = vld1q_f32( oddImag + j );
+                float32x4_t twRe   = vld1q_f32( twiddleReal + j );
+                float32x4_t twIm   = vld1q_f32( twiddleImag + j );
+                float32x4_t evenRe = vld1q_f32( evenReal + j );
+                float32x4_t evenIm = vld1q_f32( evenImag + j );
+
+                float32x4_t tr = vfmsq_f32( vmulq_f32( oddRe, twRe ), oddIm, twIm );
+                float32x4_t ti = vfmaq_f32( vmulq_f32( oddRe, twIm ), oddIm, twRe );
+
+                vst1q_f32( oddReal + j,  vsubq_f32( evenRe, tr ));
+                vst1q_f32( oddImag + j,  vsubq_f32( evenIm, ti ));
+                vst1q_f32( evenReal + j, vaddq_f32( evenRe, tr ));
+                vst1q_f32( evenImag + j, vaddq_f32( evenIm, ti ));
+            }
+
+            // the remainder, or the whole span in the first stages (of a half span below the vector width)
+
+            for ( ; j < half; ++j ) {
+                float tr = oddReal[ j ] * twiddleReal[ j ] - oddImag[ j ] * twiddleImag[ j ];
+                float ti = oddReal[ j ] * twiddleImag[ j ] + oddImag[ j ] * twiddleReal[ j ];
+
+                oddReal[ j ]   = evenReal[ j ] - tr;
+                oddImag[ j ]   = evenImag[ j ] - ti;
+                evenReal[ j ] += tr;
+                evenImag[ j ] += ti;
+            }
+        }
+    }
+
+    void feedbackMix( float* samples, float* tap, float feedback, float mix, int size )
+    {
+        float32x4_t fb  = vdupq_n_f32( feedback );
+        float32x4_t wet = vdupq_n_f32( mix );
+        int i = 0;
+
+        for ( ; i + 4 <= size; i += 4 ) {
+            float32x4_t delayed = vld1q_f32( tap + i );
+            float32x4_t input   = vld1q_f32( samples + i );
+
+            vst1q_f32( tap + i,     vfmaq_f32( input, delayed, fb ));
+            vst1q_f32( samples + i, vfmaq_f32( input, delayed, wet ));
+        }
+        for ( ; i < size; ++i ) {
+            float delayed = tap[ i ];
+            tap[ i ]      = samples[ i ] + delayed * feedback;
+            samples[ i ] += delayed * mix;
+        }
+    }
+}
+
+bool fillNEON( Table& table )
+{
+    table.dotProduct                = &dotProduct;
+    table.complexMultiplyAccumulate = &complexMultiplyAccumulate;
+    table.fftButterflies            = &fftButterflies;
+    table.feedbackMix               = &feedbackMix;
+
+    return true;
+}
+
+}
+}
+
+#else
+
+namespace Igorski {
+namespace Kernels {
+
+bool fillNEON( Table& /*table*/ )
+{
+    return false;
+}
+
+}
+}
+
+#endif
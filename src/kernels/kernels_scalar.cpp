@@ -0,0 +1,89 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "kernels.h"
+
+namespace Igorski {
+namespace Kernels {
+
+/* the reference implementations, portable across architectures */
+
+namespace {
+    float dotProduct( const float* a, const float* b, int size )
+    {
+        float sum = 0.f;
+        for ( int i = 0; i < size; ++i ) {
+            sum += a[ i ] * b[ i ];
+        }
+        return sum;
+    }
+
+    void complexMultiplyAccumulate( float* outReal, float* outImag, const float* aReal, const float* aImag,
+                                    const float* bReal, const float* bImag, int size )
+    {
+        for ( int i = 0; i < size; ++i ) {
+            outReal[ i ] += aReal[ i ] * bReal[ i ] - aImag[ i ] * bImag[ i ];
+            outImag[ i ] += aReal[ i ] * bImag[ i ] + aImag[ i ] * bReal[ i ];
+        }
+    }
+
+    void fftButterflies( float* real, float* imag, const float* twiddleReal, const float* twiddleImag, int half, int size )
+    {
+        for ( int start = 0; start < size; start += half * 2 ) {
+            float* evenReal = real + start;
+            float* evenImag = imag + start;
+            float* oddReal  = evenReal + half;
+            float* oddImag  = evenImag + half;
+
+            for ( int j = 0; j < half; ++j ) {
+                float tr = oddReal[ j ] * twiddleReal[ j ] - oddImag[ j ] * twiddleImag[ j ];
+                float ti = oddReal[ j ] * twiddleImag[ j ] + oddImag[ j ] * twiddleReal[ j ];
+
+                oddReal[ j ]   = evenReal[ j ] - tr;
+                oddImag[ j ]   = evenImag[ j ] - ti;
+                evenReal[ j ] += tr;
+                evenImag[ j ] += ti;
+            }
+        }
+    }
+
+    void feedbackMix( float* samples, float* tap, float feedback, float mix, int size )
+    {
+        for ( int i = 0; i < size; ++i ) {
+            float delayed = tap[ i ];
+            tap[ i ]      = samples[ i ] + delayed * feedback;
+            samples[ i ] += delayed * mix;
+        }
+    }
+}
+
+void fillScalar( Table& table )
+{
+    table.isa                       = ISA::SCALAR;
+    table.dotProduct                = &dotProduct;
+    table.complexMultiplyAccumulate = &complexMultiplyAccumulate;
+    table.fftButterflies            = &fftButterflies;
+    table.feedbackMix               = &feedbackMix;
+}
+
+}
+}
@@ -0,0 +1,168 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "kernels.h"
+
+#if KERNELS_X86
+
+#include <immintrin.h>
+
+namespace Igorski {
+namespace Kernels {
+
+namespace {
+    KERNELS_TARGET( "sse2" )
+    float dotProduct( const float* a, const float* b, int size )
+    {
+        __m128 sum = _mm_setzero_ps();
+        int i = 0;
+
+        for ( ; i + 4 <= size; i += 4 ) {
+            sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i )));
+        }
+
+        // horizontal sum of the four lanes
+
+        __m128 shuffled = _mm_shuffle_ps( sum, sum, _MM_SHUFFLE( 2, 3, 0, 1 ));
+        sum = _mm_add_ps( sum, shuffled );
+        sum = _mm_add_ss( sum, _mm_movehl_ps( shuffled, sum ));
+
+        float result = _mm_cvtss_f32( sum );
+        for ( ; i < size; ++i ) {
+            result += a[ i ] * b[ i ];
+        }
+        return result;
+    }
+
+    KERNELS_TARGET( "sse2" )
+    void complexMultiplyAccumulate( float* outReal, float* outImag, const float* aReal, const float* aImag,
+                                    const float* bReal, const float* bImag, int size )
+    {
+        int i = 0;
+        for ( ; i + 4 <= size; i += 4 ) {
+            __m128 ar = _mm_loadu_ps( aReal + i );
+            __m128 ai = _mm_loadu_ps( aImag + i );
+            __m128 br = _mm_loadu_ps( bReal + i );
+            __m128 bi = _mm_loadu_ps( bImag + i );
+
+            __m128 real = _mm_sub_ps( _mm_mul_ps( ar, br ), _mm_mul_ps( ai, bi ));
+            __m128 imag = _mm_add_ps( _mm_mul_ps( ar, bi ), _mm_mul_ps( ai, br ));
+
+            _mm_storeu_ps( outReal + i, _mm_add_ps( _mm_loadu_ps( outReal + i ), real ));
+            _mm_storeu_ps( outImag + i, _mm_add_ps( _mm_loadu_ps( outImag + i ), imag ));
+        }
+        for ( ; i < size; ++i ) {
+            outReal[ i ] += aReal[ i ] * bReal[ i ] - aImag[ i ] * bImag[ i ];
+            outImag[ i ] += aReal[ i ] * bImag[ i ] + aImag[ i ] * bReal[ i ];
+        }
+    }
+
+    KERNELS_TARGET( "sse2" )
+    void fftButterflies( float* real, float* imag, const float* twiddleReal, const float* twiddleImag, int half, int size )
+    {
+        for ( int start = 0; start < size; start += half * 2 ) {
+            float* evenReal = real + start;
+            float* evenImag = imag + start;
+            float* oddReal  = evenReal + half;
+            float* oddImag  = evenImag + half;
+            int j = 0;
+
+            for ( ; j + 4 <= half; j += 4 ) {
+                __m128 oddRe  = _mm_loadu_ps( oddReal + j );
+                __m128 oddIm  = _mm_loadu_ps( oddImag + j );
+                __m128 twRe   = _mm_loadu_ps( twiddleReal + j );
+                __m128 twIm   = _mm_loadu_ps( twiddleImag + j );
+                __m128 evenRe = _mm_loadu_ps( evenReal + j );
+                __m128 evenIm = _mm_loadu_ps( evenImag + j );
+
+                __m128 tr = _mm_sub_ps( _mm_mul_ps( oddRe, twRe ), _mm_mul_ps( oddIm, twIm ));
+                __m128 ti = _mm_add_ps( _mm_mul_ps( oddRe, twIm ), _mm_mul_ps( oddIm, twRe ));
+
+                _mm_storeu_ps( oddReal + j,  _mm_sub_ps( evenRe, tr ));
+                _mm_storeu_ps( oddImag + j,  _mm_sub_ps( evenIm, ti ));
+                _mm_storeu_ps( evenReal + j, _mm_add_ps( evenRe, tr ));
+                _mm_storeu_ps( evenImag + j, _mm_add_ps( evenIm, ti ));
+            }
+
+            // the remainder, or the whole span in the first stages (of a half span below the vector width)
+
+            for ( ; j < half; ++j ) {
+                float tr = oddReal[ j ] * twiddleReal[ j ] - oddImag[ j ] * twiddleImag[ j ];
+                float ti = oddReal[ j ] * twiddleImag[ j ] + oddImag[ j ] * twiddleReal[ j ];
+
+                oddReal[ j ]   = evenReal[ j ] - tr;
+                oddImag[ j ]   = evenImag[ j ] - ti;
+                evenReal[ j ] += tr;
+                evenImag[ j ] += ti;
+            }
+        }
+    }
+
+    KERNELS_TARGET( "sse2" )
+    void feedbackMix( float* samples, float* tap, float feedback, float mix, int size )
+    {
+        __m128 fb  = _mm_set1_ps( feedback );
+        __m128 wet = _mm_set1_ps( mix );
+        int i = 0;
+
+        for ( ; i + 4 <= size; i += 4 ) {
+            __m128 delayed = _mm_loadu_ps( tap + i );
+            __m128 input   = _mm_loadu_ps( samples + i );
+
+            _mm_storeu_ps( tap + i,     _mm_add_ps( input, _mm_mul_ps( delayed, fb )));
+            _mm_storeu_ps( samples + i, _mm_add_ps( input, _mm_mul_ps( delayed, wet )));
+        }
+        for ( ; i < size; ++i ) {
+            float delayed = tap[ i ];
+            tap[ i ]      = samples[ i ] + delayed * feedback;
+            samples[ i ] += delayed * mix;
+        }
+    }
+}
+
+bool fillSSE2( Table& table )
+{
+    table.dotProduct                = &dotProduct;
+    table.complexMultiplyAccumulate = &complexMultiplyAccumulate;
+    table.fftButterflies            = &fftButterflies;
+    table.feedbackMix               = &feedbackMix;
+
+    return true;
+}
+
+}
+}
+
+#else
+
+namespace Igorski {
+namespace Kernels {
+
+bool fillSSE2( Table& /*table*/ )
+{
+    return false;
+}
+
+}
+}
+
+#endif
@@ -27,6 +27,11 @@ namespace Igorski {
 LFO::LFO() {
     _rate        = VST::MIN_LFO_RATE();
     _accumulator = 0.f;
+
+    setSampleRate( 44100.f );
+
+    _resource = ResourceRegistry::getInstance()->acquire( ResourceId::SINE_TABLE );
+    _table    = _resource->getData();
 }
 
 LFO::~LFO() {
@@ -45,6 +50,15 @@ void LFO::setRate( float value )
     _rate = value;
 }
 
+void LFO::setSampleRate( float sampleRate )
+{
+    if ( _accumulator > 0.f ) {
+        _accumulator *= sampleRate / _sampleRate;
+    }
+    _sampleRate   = sampleRate;
+    _lengthOverSr = ( float ) TABLE_SIZE / sampleRate;
+}
+
 void LFO::setAccumulator( float value )
 {
     _accumulator = value;
@@ -55,4 +69,9 @@ float LFO::getAccumulator()
     return _accumulator;
 }
 
+void LFO::reset()
+{
+    _accumulator = 0.f;
+}
+
 }
@@ -24,6 +24,7 @@
 #define __LFO_H_INCLUDED__
 
 #include "global.h"
+#include "resourceregistry.h"
 
 namespace Igorski {
 class LFO {
@@ -35,12 +36,19 @@ class LFO {
         float getRate();
         void setRate( float value );
 
+        // the accumulator spans the sample rate, retains the phase of the oscillator when changed
+
+        void setSampleRate( float sampleRate );
+
         // accumulators are used to retrieve a sample from the wave table
         // in other words: track the progress of the oscillator against its range
 
         float getAccumulator();
         void setAccumulator( float offset );
 
+        // restart the oscillator at the start of its cycle
+        void reset();
+
         /**
          * retrieve a value from the wave table for the current
          * accumulator position, this method also increments
@@ -48,30 +56,37 @@ class LFO {
          */
         inline float peek()
         {
-            // the wave table offset to read from
-            float SR_OVER_LENGTH = VST::SAMPLE_RATE / ( float ) TABLE_SIZE;
-            int readOffset = ( _accumulator == 0.f ) ? 0 : ( int ) ( _accumulator / SR_OVER_LENGTH );
+            // the wave table offset to read from (scaled by the reciprocal, avoiding a division per sample)
+            int readOffset = ( int ) ( _accumulator * _lengthOverSr );
 
             // increment the accumulators read offset
             _accumulator += _rate;
 
             // keep the accumulator within the bounds of the sample frequency
-            if ( _accumulator > VST::SAMPLE_RATE )
-                _accumulator -= VST::SAMPLE_RATE;
+            if ( _accumulator >= _sampleRate )
+                _accumulator -= _sampleRate;
 
             // return the sample present at the calculated offset within the table
-            return VST::TABLE[ readOffset ];
+            // (wrapped as floating point rounding can place the offset at the end of the table)
+            return _table[ readOffset & ( TABLE_SIZE - 1 ) ];
         }
 
     private:
 
-        // see Igorski::VST::LFO_TABLE;
-        static const int TABLE_SIZE = 128;
+        // see ResourceId::SINE_TABLE (must be a power of two)
+        static const int TABLE_SIZE = VST::SINE_TABLE_SIZE;
+
+        // the wave table is shared by all instances (_table points to its contents)
+
+        SharedResource _resource;
+        const float* _table;
 
         // used internally
 
         float _rate;
         float _accumulator;   // is read offset in wave table buffer
+        float _sampleRate;
+        float _lengthOverSr;  // the amount of wave table entries per unit of the accumulator
 };
 }
 
@@ -26,6 +26,7 @@
 #include "limiter.h"
 #include "global.h"
 #include <math.h>
+#include <algorithm>
 
 // constructors / destructor
 
@@ -34,9 +35,9 @@ Limiter::Limiter()
     init( 0.15, 0.50, 0.60 );
 }
 
-Limiter::Limiter( float attackMs, float releaseMs, float thresholdDb )
+Limiter::Limiter( float attack, float release, float threshold )
 {
-    init( attackMs, releaseMs, thresholdDb );
+    init( attack, release, threshold );
 }
 
 Limiter::~Limiter()
@@ -46,40 +47,46 @@ Limiter::~Limiter()
 
 /* public methods */
 
-void Limiter::setAttack( float attackMs )
+void Limiter::setAttack( float attack )
 {
-    pAttack = ( float ) attackMs;
+    pAttack = ( float ) attack;
     recalculate();
 }
 
-void Limiter::setRelease( float releaseMs )
+void Limiter::setRelease( float release )
 {
-    pRelease = ( float ) releaseMs;
+    pRelease = ( float ) release;
     recalculate();
 }
 
-void Limiter::setThreshold( float thresholdDb )
+void Limiter::setThreshold( float threshold )
 {
-    pTresh = ( float ) thresholdDb;
+    pTresh = ( float ) threshold;
     recalculate();
 }
 
 float Limiter::getLinearGR()
 {
-    return gain > 1.f ? 1.f / gain : 1.f;
+    return std::max( 0.f, std::min( 1.f, gain ));
+}
+
+void Limiter::reset()
+{
+    gain = 1.f;
 }
 
 /* protected methods */
 
-void Limiter::init( float attackMs, float releaseMs, float thresholdDb )
+void Limiter::init( float attack, float release, float threshold )
 {
-    pAttack  = ( float ) attackMs;
-    pRelease = ( float ) releaseMs;
-    pTresh   = ( float ) thresholdDb;
-    pTrim    = ( float ) 0.60;
+    pAttack  = ( float ) attack;
+    pRelease = ( float ) release;
+    pTresh   = ( float ) threshold;
+    pTrim    = ( float ) 0.50; // unity gain
     pKnee    = ( float ) 0.40;
 
-    gain = 1.f;
+    gain  = 1.f;
+    keyed = false;
 
     recalculate();
 }
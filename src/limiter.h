@@ -27,34 +27,55 @@
 #define __LIMITER_H_INCLUDED__
 
 #include "audiobuffer.h"
+#include "denormals.h"
+#include <algorithm>
 
 class Limiter
 {
     public:
+        // all arguments are normalized (0 - 1) values, see recalculate() for their mapping
+        // (e.g. a threshold of 1 limits at 0 dBFS)
+
         Limiter();
-        Limiter( float attackMs, float releaseMs, float thresholdDb );
+        Limiter( float attack, float release, float threshold );
         ~Limiter();
 
+        // limit given buffers in place, the gain reduction is linked across all channels
+
         template <typename SampleType>
         void process( SampleType** outputBuffer, int bufferSize, int numOutChannels );
 
-        void setAttack( float attackMs );
-        void setRelease( float releaseMs );
-        void setThreshold( float thresholdDb );
+        // keyed mode: the gain is derived from given (external) detector signal instead of the output
+        // itself (e.g. a sidechain envelope for ducking), where sensitivity scales the detector level
+        // (0 leaves the signal untouched). The same gain is applied to all channels, no trim is applied
+
+        template <typename SampleType>
+        void processKeyed( SampleType** outputBuffer, int offset, int bufferSize, int numOutChannels,
+                           const float* detector, float sensitivity );
+
+        void setAttack( float attack );
+        void setRelease( float release );
+        void setThreshold( float threshold );
+
+        // the gain applied during the last processed sample (1.f meaning no gain reduction)
 
         float getLinearGR();
 
+        // clear the gain reduction state
+        void reset();
+
     protected:
-        void init( float attackMs, float releaseMs, float thresholdDb );
+        void init( float attack, float release, float threshold );
         void recalculate();
 
-        float pTresh;   // in dB, -20 - 20
-        float pTrim;
-        float pAttack;  // in microseconds
-        float pRelease; // in ms
-        float pKnee;
+        float pTresh;   // normalized, hard knee: 0 = -40 dBFS, 1 = 0 dBFS
+        float pTrim;    // normalized, .5 = unity gain
+        float pAttack;  // normalized, 0 = instant (soft knee only, the hard knee limits instantly)
+        float pRelease; // normalized, 0 = fastest
+        float pKnee;    // above .5 selects the soft knee
 
         float thresh, gain, att, rel, trim;
+        bool keyed;
 };
 
 #include "limiter.tcc"
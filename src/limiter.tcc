@@ -26,13 +26,9 @@
 template <typename SampleType>
 void Limiter::process( SampleType** outputBuffer, int bufferSize, int numOutChannels )
 {
-//    if ( gain > 0.9999f && outputBuffer->isSilent )
-//    {
-//        // don't process if input is silent
-//        return;
-//    }
+    SampleType g, at, re, tr, th, lev, peak;
 
-    SampleType g, at, re, tr, th, lev, ol, or_;
+    const SampleType SETTLE_THRESHOLD = ( SampleType ) 1e-7;
 
     th = thresh;
     g = gain;
@@ -40,21 +36,19 @@ void Limiter::process( SampleType** outputBuffer, int bufferSize, int numOutChan
     re = rel;
     tr = trim;
 
-    bool hasRight = ( numOutChannels > 1 );
+    // the gain is linked across all channels, derived from their peak level
 
-    SampleType* leftBuffer  = outputBuffer[ 0 ];
-    SampleType* rightBuffer = hasRight ? outputBuffer[ 1 ] : 0;
+    for ( int i = 0; i < bufferSize; ++i ) {
 
-    if ( pKnee > 0.5 )
-    {
-        // soft knee
-
-        for ( int i = 0; i < bufferSize; ++i ) {
-
-            ol  = leftBuffer[ i ];
-            or_ = hasRight ? rightBuffer[ i ] : 0;
+        peak = 0;
+        for ( int c = 0; c < numOutChannels; ++c ) {
+            peak = std::max( peak, ( SampleType ) fabs( outputBuffer[ c ][ i ] ));
+        }
 
-            lev = ( SampleType ) ( 1.f / ( 1.f + th * fabs( ol + or_ )));
+        if ( pKnee > 0.5 )
+        {
+            // soft knee
+            lev = ( SampleType ) ( 1.f / ( 1.f + th * 2 * peak ));
 
             if ( g > lev ) {
                 g = g - at * ( g - lev );
@@ -62,35 +56,65 @@ void Limiter::process( SampleType** outputBuffer, int bufferSize, int numOutChan
             else {
                 g = g + re * ( lev - g );
             }
-
-            leftBuffer[ i ] = ( ol * tr * g );
-
-            if ( hasRight )
-                rightBuffer[ i ] = ( or_ * tr * g );
+            // settle onto the target once the remaining distance is inaudible so the
+            // recursion reaches a fixed point instead of decaying into subnormal deltas
+            if ( fabs( lev - g ) < SETTLE_THRESHOLD ) {
+                g = lev;
+            }
         }
-    }
-    else
-    {
-        for ( int i = 0; i < bufferSize; ++i ) {
-
-            ol  = leftBuffer[ i ];
-            or_ = hasRight ? rightBuffer[ i ] : 0;
+        else
+        {
+            // hard knee: the gain this sample requires to bring its peak down to the threshold, which
+            // is applied instantly (as such the output never exceeds the threshold) while the release
+            // is gradual (e.g. the gain recovers towards unity gain, but never beyond the required gain)
 
-            lev = ( SampleType ) ( 0.5 * g * fabs( ol + or_ ));
+            lev = peak > th ? th / peak : ( SampleType ) 1;
 
-            if ( lev > th ) {
-                g = g - ( at * ( lev - th ));
+            if ( g > lev ) {
+                g = lev;
             }
             else {
-                // below threshold
-                g = g + ( SampleType )( re * ( 1.f - g ));
+                g = std::min( lev, g + ( SampleType )( re * ( 1.f - g )));
+
+                if ( fabs( lev - g ) < SETTLE_THRESHOLD ) {
+                    g = lev;
+                }
             }
+        }
+        g = std::max(( SampleType ) 0, std::min(( SampleType ) 1, g ));
 
-            leftBuffer[ i ] = ( ol * tr * g );
+        for ( int c = 0; c < numOutChannels; ++c ) {
+            outputBuffer[ c ][ i ] *= tr * g;
+        }
+    }
+    // recover from non-finite input (which would otherwise leave the gain permanently at NaN)
+    if ( !std::isfinite( g )) {
+        g = 1.f;
+    }
+    gain  = Igorski::Denormals::flush(( float ) g );
+    keyed = false;
+}
 
-            if ( hasRight )
-                rightBuffer[ i ] = ( or_ * tr * g );
+template <typename SampleType>
+void Limiter::processKeyed( SampleType** outputBuffer, int offset, int bufferSize, int numOutChannels,
+                            const float* detector, float sensitivity )
+{
+    // soft knee detector (see process()) operating on the detector signal, note the detector
+    // signal is expected to be smoothed already (e.g. by an EnvelopeFollower) as such it is
+    // applied directly (rather than using the attack and release of this limiter)
+
+    float g = 1.f;
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        g = 1.f / ( 1.f + sensitivity * detector[ i ] );
+
+        for ( int c = 0; c < numOutChannels; ++c ) {
+            outputBuffer[ c ][ offset + i ] *= ( SampleType ) g;
         }
     }
-    gain = g;
+
+    if ( bufferSize > 0 ) {
+        gain  = std::isfinite( g ) ? g : 1.f;
+        keyed = true;
+    }
 }
@@ -0,0 +1,226 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "logger.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+namespace Igorski {
+
+std::atomic<bool> Logger::_enabled { false };
+std::atomic<uint32_t> Logger::_dropped { 0 };
+
+// the queue is statically allocated so producers never reference freed memory when the
+// Logger is stopped while an audio thread is still writing into it. As it lives in zero-initialized
+// storage, its memory is not touched until the Logger is started
+
+struct Logger::Queue {
+    Record records[ QUEUE_SIZE ];
+    std::atomic<uint32_t> writeIndex;
+    uint32_t readIndex;
+    bool initialized;
+};
+
+Logger::Queue Logger::_queue;
+
+namespace {
+    const uint32_t QUEUE_MASK = Logger::QUEUE_SIZE - 1;
+
+    FILE* file = nullptr;
+
+    std::thread worker;
+    std::mutex workerMutex;
+    std::condition_variable workerCondition;
+    bool running = false;
+}
+
+/* public methods */
+
+bool Logger::start( const char* filename )
+{
+    if ( isEnabled()) {
+        return true;
+    }
+
+    file = fopen( filename, "a" );
+
+    if ( file == nullptr ) {
+        return false;
+    }
+    if ( !_queue.initialized ) {
+        for ( uint32_t i = 0; i < ( uint32_t ) QUEUE_SIZE; ++i ) {
+            _queue.records[ i ].sequence.store( i, std::memory_order_relaxed );
+        }
+        _queue.writeIndex.store( 0, std::memory_order_relaxed );
+        _queue.readIndex   = 0;
+        _queue.initialized = true;
+    }
+    running = true;
+    worker  = std::thread( &Logger::run );
+
+    _enabled.store( true, std::memory_order_release );
+
+    return true;
+}
+
+void Logger::stop()
+{
+    if ( !isEnabled()) {
+        return;
+    }
+    _enabled.store( false, std::memory_order_release );
+
+    {
+        std::lock_guard<std::mutex> lock( workerMutex );
+        running = false;
+    }
+    workerCondition.notify_one();
+    worker.join();
+
+    fclose( file );
+    file = nullptr;
+}
+
+uint32_t Logger::getDroppedMessageCount()
+{
+    return _dropped.load( std::memory_order_relaxed );
+}
+
+/* private methods */
+
+void Logger::enqueue( RecordType type, const char* message, float floatValue, int intValue )
+{
+    Queue& q     = _queue;
+    uint32_t pos = q.writeIndex.load( std::memory_order_relaxed );
+    Record* record;
+
+    // claim a slot in the ring buffer, multiple producers (e.g. instances running
+    // on different audio threads) can write simultaneously
+
+    while ( true ) {
+        record = &q.records[ pos & QUEUE_MASK ];
+        int32_t diff = ( int32_t ) record->sequence.load( std::memory_order_acquire ) - ( int32_t ) pos;
+
+        if ( diff == 0 ) {
+            if ( q.writeIndex.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed )) {
+                break;
+            }
+        } else if ( diff < 0 ) {
+            // queue is full, drop the message rather than wait for the writer thread
+            _dropped.fetch_add( 1, std::memory_order_relaxed );
+            return;
+        } else {
+            pos = q.writeIndex.load( std::memory_order_relaxed );
+        }
+    }
+
+    record->type       = type;
+    record->timestamp  = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+    record->floatValue = floatValue;
+    record->intValue   = intValue;
+
+    strncpy( record->message, message, MESSAGE_LENGTH - 1 );
+    record->message[ MESSAGE_LENGTH - 1 ] = '\0';
+
+    // publish the record to the writer thread
+    record->sequence.store( pos + 1, std::memory_order_release );
+}
+
+void Logger::run()
+{
+    char timeBuffer[ 20 ];
+    uint32_t reportedDropCount = 0;
+
+    while ( true ) {
+        bool keepRunning;
+        {
+            std::unique_lock<std::mutex> lock( workerMutex );
+            workerCondition.wait_for( lock, std::chrono::milliseconds( FLUSH_INTERVAL_MS ), [] { return !running; });
+            keepRunning = running;
+        }
+
+        // drain all published records in a single batch
+
+        Queue& q     = _queue;
+        bool written = false;
+
+        while ( true ) {
+            Record& record = q.records[ q.readIndex & QUEUE_MASK ];
+
+            if ( record.sequence.load( std::memory_order_acquire ) != q.readIndex + 1 ) {
+                break; // no more published records
+            }
+
+            time_t seconds = ( time_t ) ( record.timestamp / 1000 );
+            struct tm sTm;
+#ifdef _WIN32
+            gmtime_s( &sTm, &seconds );
+#else
+            gmtime_r( &seconds, &sTm );
+#endif
+            strftime( timeBuffer, sizeof( timeBuffer ), "%Y-%m-%d %H:%M:%S", &sTm );
+
+            int milliseconds = ( int ) ( record.timestamp % 1000 );
+
+            switch ( record.type ) {
+                case RecordType::TEXT:
+                    fprintf( file, "%s.%03d %s\n", timeBuffer, milliseconds, record.message );
+                    break;
+                case RecordType::FLOAT:
+                    fprintf( file, "%s.%03d %s %f\n", timeBuffer, milliseconds, record.message, record.floatValue );
+                    break;
+                case RecordType::INT:
+                    fprintf( file, "%s.%03d %s %d\n", timeBuffer, milliseconds, record.message, record.intValue );
+                    break;
+            }
+            // release the slot back to the producers
+            record.sequence.store( q.readIndex + QUEUE_SIZE, std::memory_order_release );
+            ++q.readIndex;
+
+            written = true;
+        }
+
+        uint32_t dropCount = getDroppedMessageCount();
+        if ( dropCount != reportedDropCount ) {
+            fprintf( file, "[Logger] %u message(s) dropped\n", dropCount - reportedDropCount );
+            reportedDropCount = dropCount;
+            written = true;
+        }
+
+        if ( written ) {
+            fflush( file );
+        }
+
+        if ( !keepRunning ) {
+            break;
+        }
+    }
+}
+
+}
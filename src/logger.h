@@ -0,0 +1,112 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __LOGGER_H_INCLUDED__
+#define __LOGGER_H_INCLUDED__
+
+#include <atomic>
+#include <cstdint>
+
+namespace Igorski {
+
+/**
+ * Logger provides a log that is safe to write to from the audio thread.
+ *
+ * Messages are copied into fixed size records inside a lock-free ring buffer
+ * (no allocation, no locks, no system calls). A background thread periodically
+ * drains the buffer, formats the records and appends them to the log file in batches.
+ * When the buffer is full, messages are dropped (and counted) rather than
+ * blocking the calling thread.
+ *
+ * The Logger is disabled until start() has been invoked, in which case calls to
+ * log() cost no more than a single atomic load.
+ */
+class Logger {
+
+    public:
+        static constexpr int MESSAGE_LENGTH    = 96;   // characters per message (including terminator)
+        static constexpr int QUEUE_SIZE        = 1024; // must be a power of two
+        static constexpr int FLUSH_INTERVAL_MS = 50;
+
+        // open given file for appending and start the background writer thread
+        // these should not be invoked from the audio thread
+
+        static bool start( const char* filename );
+        static void stop();
+
+        static inline bool isEnabled()
+        {
+            return _enabled.load( std::memory_order_acquire );
+        }
+
+        // real-time safe logging methods
+
+        static inline void log( const char* message )
+        {
+            if ( isEnabled()) {
+                enqueue( RecordType::TEXT, message, 0.f, 0 );
+            }
+        }
+
+        static inline void log( const char* message, float value )
+        {
+            if ( isEnabled()) {
+                enqueue( RecordType::FLOAT, message, value, 0 );
+            }
+        }
+
+        static inline void log( const char* message, int value )
+        {
+            if ( isEnabled()) {
+                enqueue( RecordType::INT, message, 0.f, value );
+            }
+        }
+
+        // the amount of messages that could not be logged as the queue was full
+
+        static uint32_t getDroppedMessageCount();
+
+    private:
+        enum class RecordType { TEXT, FLOAT, INT };
+
+        struct Record {
+            std::atomic<uint32_t> sequence;
+            RecordType type;
+            int64_t timestamp; // in milliseconds since epoch
+            float floatValue;
+            int intValue;
+            char message[ MESSAGE_LENGTH ];
+        };
+
+        struct Queue;
+
+        static void enqueue( RecordType type, const char* message, float floatValue, int intValue );
+        static void run();
+
+        static Queue _queue;
+        static std::atomic<bool> _enabled;
+        static std::atomic<uint32_t> _dropped;
+};
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "meter.h"
+#include <math.h>
+
+namespace Igorski {
+
+/* constructor */
+
+Meter::Meter()
+{
+    setSampleRate( 44100.f );
+}
+
+/* public methods */
+
+void Meter::setSampleRate( float sampleRate )
+{
+    _windowSize = std::max( 1, ( int ) ( sampleRate / DISPLAY_RATE ));
+    reset();
+}
+
+void Meter::update( float linearGainReduction, int bufferSize )
+{
+    _gainReduction   = std::min( _gainReduction, linearGainReduction );
+    _windowPosition += bufferSize;
+
+    if ( _windowPosition < _windowSize ) {
+        return;
+    }
+
+    MeterFrame frame;
+    float windowLength = ( float ) _windowPosition;
+
+    for ( int c = 0; c < MeterFrame::MAX_CHANNELS; ++c ) {
+        frame.inputPeak[ c ]  = _inputPeak[ c ];
+        frame.inputRms[ c ]   = sqrtf( _inputSquares[ c ] / windowLength );
+        frame.outputPeak[ c ] = _outputPeak[ c ];
+        frame.outputRms[ c ]  = sqrtf( _outputSquares[ c ] / windowLength );
+    }
+    frame.gainReduction = _gainReduction;
+
+    // when the UI isn't reading (e.g. editor is closed) the frame is simply discarded, the frames
+    // queued in the meantime are discarded by the UI once it resumes (see PluginController::discardMeterFrames())
+    _fifo.push( frame );
+
+    reset();
+}
+
+Meter::Fifo* Meter::getFifo()
+{
+    return &_fifo;
+}
+
+/* private methods */
+
+void Meter::reset()
+{
+    for ( int c = 0; c < MeterFrame::MAX_CHANNELS; ++c ) {
+        _inputPeak[ c ]     = 0.f;
+        _inputSquares[ c ]  = 0.f;
+        _outputPeak[ c ]    = 0.f;
+        _outputSquares[ c ] = 0.f;
+    }
+    _gainReduction  = 1.f;
+    _windowPosition = 0;
+}
+
+}
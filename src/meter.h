@@ -0,0 +1,110 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __METER_H_INCLUDED__
+#define __METER_H_INCLUDED__
+
+#include "spscfifo.h"
+
+namespace Igorski {
+
+/**
+ * A snapshot of the signal levels over a single measuring window.
+ * All values are linear (e.g. 1.f equals 0 dBFS)
+ */
+struct MeterFrame {
+    static constexpr int MAX_CHANNELS = 2;
+
+    float inputPeak [ MAX_CHANNELS ];
+    float inputRms  [ MAX_CHANNELS ];
+    float outputPeak[ MAX_CHANNELS ];
+    float outputRms [ MAX_CHANNELS ];
+    float gainReduction; // 1.f means no gain reduction is applied
+};
+
+/**
+ * Meter calculates input/output peak and RMS levels per channel as well as the
+ * gain reduction applied by the limiter. The measurements are accumulated on the
+ * audio thread over a window matching the display rate and published as MeterFrames
+ * into a wait-free queue which can be read by the UI thread.
+ */
+class Meter {
+
+    public:
+        static const int DISPLAY_RATE = 60; // the amount of frames published per second
+        static const int FIFO_SIZE    = 32;
+
+        typedef SPSCFifo<MeterFrame, FIFO_SIZE> Fifo;
+
+        Meter();
+
+        void setSampleRate( float sampleRate );
+
+        // measure the levels of the given buffers, note the input must
+        // be measured before processing as hosts can supply the same
+        // buffers for input and output
+
+        template <typename SampleType>
+        void measureInput( SampleType** buffers, int numChannels, int bufferSize );
+
+        template <typename SampleType>
+        void measureOutput( SampleType** buffers, int numChannels, int bufferSize );
+
+        // to be invoked after each process cycle, publishes a new
+        // MeterFrame once the measuring window has been filled
+
+        void update( float linearGainReduction, int bufferSize );
+
+        // queue from which the MeterFrames can be read (by a single consumer)
+
+        Fifo* getFifo();
+
+        // block reductions (written to be vectorised by the compiler)
+
+        template <typename SampleType>
+        static float getPeak( const SampleType* buffer, int bufferSize );
+
+        template <typename SampleType>
+        static float getSumOfSquares( const SampleType* buffer, int bufferSize );
+
+    private:
+        Fifo _fifo;
+
+        int _windowSize;
+        int _windowPosition;
+
+        // accumulators for the current measuring window
+
+        float _inputPeak      [ MeterFrame::MAX_CHANNELS ];
+        float _inputSquares   [ MeterFrame::MAX_CHANNELS ];
+        float _outputPeak     [ MeterFrame::MAX_CHANNELS ];
+        float _outputSquares  [ MeterFrame::MAX_CHANNELS ];
+        float _gainReduction;
+
+        void reset();
+};
+
+}
+
+#include "meter.tcc"
+
+#endif
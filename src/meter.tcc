@@ -0,0 +1,85 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+
+namespace Igorski {
+
+template <typename SampleType>
+void Meter::measureInput( SampleType** buffers, int numChannels, int bufferSize )
+{
+    for ( int c = 0, l = std::min( numChannels, MeterFrame::MAX_CHANNELS ); c < l; ++c ) {
+        _inputPeak[ c ]     = std::max( _inputPeak[ c ], getPeak( buffers[ c ], bufferSize ));
+        _inputSquares[ c ] += getSumOfSquares( buffers[ c ], bufferSize );
+    }
+}
+
+template <typename SampleType>
+void Meter::measureOutput( SampleType** buffers, int numChannels, int bufferSize )
+{
+    for ( int c = 0, l = std::min( numChannels, MeterFrame::MAX_CHANNELS ); c < l; ++c ) {
+        _outputPeak[ c ]     = std::max( _outputPeak[ c ], getPeak( buffers[ c ], bufferSize ));
+        _outputSquares[ c ] += getSumOfSquares( buffers[ c ], bufferSize );
+    }
+}
+
+template <typename SampleType>
+float Meter::getPeak( const SampleType* buffer, int bufferSize )
+{
+    // four independent accumulators allow the compiler to keep
+    // the loop in vector registers without reordering concerns
+
+    SampleType peak0 = 0, peak1 = 0, peak2 = 0, peak3 = 0;
+    int i = 0;
+
+    for ( ; i + 4 <= bufferSize; i += 4 ) {
+        peak0 = std::max( peak0, std::abs( buffer[ i ]));
+        peak1 = std::max( peak1, std::abs( buffer[ i + 1 ]));
+        peak2 = std::max( peak2, std::abs( buffer[ i + 2 ]));
+        peak3 = std::max( peak3, std::abs( buffer[ i + 3 ]));
+    }
+    for ( ; i < bufferSize; ++i ) {
+        peak0 = std::max( peak0, std::abs( buffer[ i ]));
+    }
+    return ( float ) std::max( std::max( peak0, peak1 ), std::max( peak2, peak3 ));
+}
+
+template <typename SampleType>
+float Meter::getSumOfSquares( const SampleType* buffer, int bufferSize )
+{
+    SampleType sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+    int i = 0;
+
+    for ( ; i + 4 <= bufferSize; i += 4 ) {
+        sum0 += buffer[ i ]     * buffer[ i ];
+        sum1 += buffer[ i + 1 ] * buffer[ i + 1 ];
+        sum2 += buffer[ i + 2 ] * buffer[ i + 2 ];
+        sum3 += buffer[ i + 3 ] * buffer[ i + 3 ];
+    }
+    for ( ; i < bufferSize; ++i ) {
+        sum0 += buffer[ i ] * buffer[ i ];
+    }
+    return ( float ) (( sum0 + sum1 ) + ( sum2 + sum3 ));
+}
+
+}
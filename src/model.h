@@ -0,0 +1,303 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MODEL_H_INCLUDED__
+#define __MODEL_H_INCLUDED__
+
+#include "paramids.h"
+#include "pluginterfaces/base/ftypes.h"
+#include <math.h>
+#include <stdio.h>
+
+using namespace Steinberg;
+
+namespace Igorski {
+
+// the amount of parameters in the model (e.g. all parameters except bypass)
+// model parameter ids are sequential, starting directly after the bypass parameter
+
+static const int MODEL_PARAMETER_COUNT    = kNumParameters - 1;
+static const int FIRST_MODEL_PARAMETER_ID = kBypassId + 1;
+
+enum class ParameterScaling {
+    LINEAR,
+    LOGARITHMIC // min must be larger than 0
+};
+
+// formats given value into a human readable representation (text can hold 32 characters)
+
+typedef void ( *ParameterFormatter )( double valueNormalized, double valuePlain, char* text );
+
+/**
+ * Describes a single parameter of the model. The host and processor
+ * operate on normalized (0 - 1 range) values, the descriptor
+ * maps these onto the parameters plain (min - max range) value.
+ */
+struct ParameterDescriptor {
+    int32 id;
+    const char* title;
+    const char* units;
+    float min;
+    float max;
+    float defaultValue; // normalized
+    int32 stepCount;    // 0 for continuous, 1 for on/off
+    ParameterScaling scaling;
+    bool smooth;        // whether changes should be smoothed by the processor
+    int32 pixels;       // size of the control in the editor, 0 when not displayed
+    ParameterFormatter format;
+
+    inline double toPlain( double valueNormalized ) const
+    {
+        if ( scaling == ParameterScaling::LOGARITHMIC ) {
+            return min * pow( max / min, valueNormalized );
+        }
+        return min + valueNormalized * ( max - min );
+    }
+
+    inline double toNormalized( double valuePlain ) const
+    {
+        if ( max == min ) {
+            return 0.;
+        }
+        if ( scaling == ParameterScaling::LOGARITHMIC ) {
+            return log( valuePlain / min ) / log( max / min );
+        }
+        return ( valuePlain - min ) / ( max - min );
+    }
+};
+
+/**
+ * The values of all model parameters, normalized and in parameter id order.
+ * The struct is packed so it can be addressed as an array of floats (see getModelValues())
+ * and (de)serialized as a whole (see PresetBank::writeState()).
+ */
+#pragma pack(push, 1)
+struct PluginModel {
+
+// --- AUTO-GENERATED MODEL START
+
+    float bitDepth = 1.f;    // Resolution
+    float bitCrushLfo = 0.f;    // Bit crush LFO
+    float bitCrushLfoDepth = 0.f;    // Bit crush LFO depth
+    float wetMix = 1.f;    // Wet mix
+    float dryMix = 0.f;    // Dry mix
+    float sideChainDuck = 0.f;    // Sidechain duck
+    float sideChainCrush = 0.f;    // Sidechain crush
+    float delayTime = 1.f;    // Delay time
+    float delayFeedback = 0.4f;    // Delay feedback
+    float delayMix = 0.f;    // Delay mix
+    float filterHighPass = 0.f;    // High-pass
+    float filterLowPass = 1.f;    // Low-pass
+    float filterTilt = 0.5f;    // Tilt
+    float convolverImpulse = 0.f;    // Impulse response
+    float convolverMix = 1.f;    // Impulse response mix
+    float bitCrushAntiAliasing = 0.f;    // Bit crush anti-aliasing
+    float bitCrushDither = 0.f;    // Bit crush dither
+    float outputLimiter = 0.f;    // Output limiter
+
+// --- AUTO-GENERATED MODEL END
+
+};
+#pragma pack(pop)
+
+static_assert( sizeof( PluginModel ) == sizeof( float ) * MODEL_PARAMETER_COUNT, "PluginModel out of sync with paramids.h" );
+
+inline float* getModelValues( PluginModel& model )
+{
+    return reinterpret_cast<float*>( &model );
+}
+
+inline const float* getModelValues( const PluginModel& model )
+{
+    return reinterpret_cast<const float*>( &model );
+}
+
+inline bool isModelParameter( int32 id )
+{
+    return id >= FIRST_MODEL_PARAMETER_ID && id < kNumParameters;
+}
+
+// descriptors of all model parameters, in parameter id order (e.g. index by: id - FIRST_MODEL_PARAMETER_ID)
+
+inline constexpr ParameterDescriptor PARAMETERS[] = {
+
+// --- AUTO-GENERATED DESCRIPTORS START
+
+    {
+        kBitDepthId, "Resolution", "%",
+        0.f, 1.f, 1.f, 0,
+        ParameterScaling::LINEAR, false, 104,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.d Bits", ( int ) ( 15 * valueNormalized ) + 1 );
+        }
+    },
+    {
+        kBitCrushLfoId, "Bit crush LFO", "Hz",
+        0.f, 10.f, 0.f, 0,
+        ParameterScaling::LINEAR, false, 134,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2f Hz", valuePlain );
+        }
+    },
+    {
+        kBitCrushLfoDepthId, "Bit crush LFO depth", "%",
+        0.f, 1.f, 0.f, 0,
+        ParameterScaling::LINEAR, false, 134,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
+        }
+    },
+    {
+        kWetMixId, "Wet mix", "%",
+        0.f, 1.f, 1.f, 0,
+        ParameterScaling::LINEAR, true, 134,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
+        }
+    },
+    {
+        kDryMixId, "Dry mix", "%",
+        0.f, 1.f, 0.f, 0,
+        ParameterScaling::LINEAR, true, 134,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
+        }
+    },
+    {
+        kSideChainDuckId, "Sidechain duck", "%",
+        0.f, 1.f, 0.f, 0,
+        ParameterScaling::LINEAR, false, 104,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
+        }
+    },
+    {
+        kSideChainCrushId, "Sidechain crush", "%",
+        0.f, 1.f, 0.f, 0,
+        ParameterScaling::LINEAR, false, 104,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
+        }
+    },
+    {
+        kDelayTimeId, "Delay time", "note",
+        0.f, 1.f, 1.f, 3,
+        ParameterScaling::LINEAR, false, 134,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            static const char* NOTES[] = { "1/16", "1/8", "1/4", "1/2" }; sprintf( text, "%s", NOTES[ ( int ) round( valueNormalized * 3 ) ] );
+        }
+    },
+    {
+        kDelayFeedbackId, "Delay feedback", "%",
+        0.f, 1.f, 0.4f, 0,
+        ParameterScaling::LINEAR, false, 104,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
+        }
+    },
+    {
+        kDelayMixId, "Delay mix", "%",
+        0.f, 1.f, 0.f, 0,
+        ParameterScaling::LINEAR, true, 104,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
+        }
+    },
+    {
+        kFilterHighPassId, "High-pass", "Hz",
+        20.f, 2000.f, 0.f, 0,
+        ParameterScaling::LOGARITHMIC, false, 134,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2f Hz", valuePlain );
+        }
+    },
+    {
+        kFilterLowPassId, "Low-pass", "Hz",
+        500.f, 20000.f, 1.f, 0,
+        ParameterScaling::LOGARITHMIC, false, 104,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2f Hz", valuePlain );
+        }
+    },
+    {
+        kFilterTiltId, "Tilt", "dB",
+        -6.f, 6.f, 0.5f, 0,
+        ParameterScaling::LINEAR, false, 80,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2f dB", valuePlain );
+        }
+    },
+    {
+        kConvolverImpulseId, "Impulse response", "",
+        0.f, 1.f, 0.f, 3,
+        ParameterScaling::LINEAR, false, 60,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            static const char* IMPULSES[] = { "Off", "Cabinet", "Room", "Hall" }; sprintf( text, "%s", IMPULSES[ ( int ) round( valueNormalized * 3 ) ] );
+        }
+    },
+    {
+        kConvolverMixId, "Impulse response mix", "%",
+        0.f, 1.f, 1.f, 0,
+        ParameterScaling::LINEAR, true, 60,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
+        }
+    },
+    {
+        kBitCrushAntiAliasingId, "Bit crush anti-aliasing", "",
+        0.f, 1.f, 0.f, 2,
+        ParameterScaling::LINEAR, false, 60,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            static const char* MODES[] = { "Off", "ADAA 1st", "ADAA 2nd" }; sprintf( text, "%s", MODES[ ( int ) round( valueNormalized * 2 ) ] );
+        }
+    },
+    {
+        kBitCrushDitherId, "Bit crush dither", "",
+        0.f, 1.f, 0.f, 2,
+        ParameterScaling::LINEAR, false, 60,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            static const char* MODES[] = { "Off", "TPDF", "Shaped" }; sprintf( text, "%s", MODES[ ( int ) round( valueNormalized * 2 ) ] );
+        }
+    },
+    {
+        kOutputLimiterId, "Output limiter", "",
+        0.f, 1.f, 0.f, 1,
+        ParameterScaling::LINEAR, false, 60,
+        []( double valueNormalized, double valuePlain, char* text ) {
+            sprintf( text, "%s", ( valueNormalized == 0 ) ? "Off" : "On" );
+        }
+    },
+
+// --- AUTO-GENERATED DESCRIPTORS END
+
+};
+
+static_assert( sizeof( PARAMETERS ) / sizeof( ParameterDescriptor ) == MODEL_PARAMETER_COUNT, "PARAMETERS out of sync with paramids.h" );
+
+inline const ParameterDescriptor& getParameterDescriptor( int32 id )
+{
+    return PARAMETERS[ id - FIRST_MODEL_PARAMETER_ID ];
+}
+
+}
+
+#endif
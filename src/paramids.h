@@ -38,8 +38,32 @@ enum
     kBitCrushLfoDepthId = 3,    // Bit crush LFO depth
     kWetMixId = 4,    // Wet mix
     kDryMixId = 5,    // Dry mix
+    kSideChainDuckId = 6,    // Sidechain duck
+    kSideChainCrushId = 7,    // Sidechain crush
+    kDelayTimeId = 8,    // Delay time
+    kDelayFeedbackId = 9,    // Delay feedback
+    kDelayMixId = 10,    // Delay mix
+    kFilterHighPassId = 11,    // High-pass
+    kFilterLowPassId = 12,    // Low-pass
+    kFilterTiltId = 13,    // Tilt
+    kConvolverImpulseId = 14,    // Impulse response
+    kConvolverMixId = 15,    // Impulse response mix
+    kBitCrushAntiAliasingId = 16,    // Bit crush anti-aliasing
+    kBitCrushDitherId = 17,    // Bit crush dither
+    kOutputLimiterId = 18,    // Output limiter
 
 // --- AUTO-GENERATED END
+
+    kNumParameters, // the amount of model parameters (including bypass), keep directly after the auto-generated ids
+
+    // program change parameter, recalls presets from the factory bank (see presetbank.h)
+
+    kPresetId = 99,
+
+    // read-only parameters used to report values back to the host
+
+    kOutputGainReductionId = 100, // linear gain reduction of the limiter (0 = none)
+    kLatencyId             = 101, // hidden, signals the controller the latency has changed (see PluginController::setParamNormalized())
 };
 
 #endif
@@ -26,27 +26,213 @@
 
 namespace Igorski {
 
-PluginProcess::PluginProcess( int amountOfChannels ) {
-    _amountOfChannels = amountOfChannels;
+PluginProcess::PluginProcess( const ProcessingContext& context ) : _context( context ) {
+    _amountOfChannels = context.amountOfChannels;
+    _sampleRate       = context.sampleRate;
+    _delayRingSize    = Delay::getRingSize( MAX_DELAY_SECONDS, _sampleRate );
 
     setDryMix( .5f );
     setWetMix( .5f );
 
-    // create the child processors
+    _sideChainDuck        = 0.f;
+    _sideChainCrush       = 0.f;
+    _numSideChainChannels = 0;
+    _isDucking            = false;
+    _isLimiting           = false;
+    _blockAdapter         = nullptr;
 
-    bitCrusher = new BitCrusher( 8, .5f, .5f );
-    limiter    = new Limiter( 10.f, 500.f, .6f );
+    memset( _dryHistory, 0, sizeof( _dryHistory ));
 
-    // will be lazily created in the process function
-    _preMixBuffer  = nullptr;
-    _postMixBuffer = nullptr;
+    convolver = new Convolver( _amountOfChannels );
+    convolver->setSampleRate( _sampleRate );
+
+    // create the child processors and buffers
+
+    _arena         = nullptr;
+    _maxBufferSize = 0;
+
+    setMaxBufferSize( std::max( 1, context.maxBufferSize ));
+    updateDeferredTail();
+
+    envelopeFollower->setSampleRate( _sampleRate );
+    filterBank->setSampleRate( _sampleRate );
+    bitCrusher->setSampleRate( _sampleRate );
+
+    // until the host provides its tempo (see setTempo())
+    setTempo( 120.0, 4, 4 );
 }
 
 PluginProcess::~PluginProcess() {
-    delete bitCrusher;
-    delete limiter;
-    delete _postMixBuffer;
-    delete _preMixBuffer;
+    delete _blockAdapter;
+    delete _arena; // destroys the child processors
+    delete convolver;
+}
+
+void PluginProcess::setProcessingContext( const ProcessingContext& context )
+{
+    _context = context;
+
+    setMaxBufferSize( std::max( context.maxBufferSize, _blockAdapter != nullptr ? _blockAdapter->getBlockSize() : 0 ));
+    setSampleRate( context.sampleRate );
+    updateDeferredTail();
+}
+
+void PluginProcess::updateDeferredTail()
+{
+    // offline renders convolve on the processing thread, keeping their cost (and completion) independent of the worker
+
+    convolver->setDeferredTail( _context.isOffline() ? 0 : _maxBufferSize );
+}
+
+void PluginProcess::setMaxBufferSize( int maxBufferSize )
+{
+    if ( maxBufferSize <= 0 || maxBufferSize == _maxBufferSize ) {
+        return;
+    }
+    _maxBufferSize = maxBufferSize;
+
+    createGraph();
+}
+
+void PluginProcess::setSampleRate( float sampleRate )
+{
+    if ( sampleRate == _sampleRate ) {
+        return;
+    }
+    _sampleRate = sampleRate;
+    envelopeFollower->setSampleRate( sampleRate );
+    filterBank->setSampleRate( sampleRate );
+    bitCrusher->setSampleRate( sampleRate );
+    convolver->setSampleRate( sampleRate );
+
+    int ringSize = Delay::getRingSize( MAX_DELAY_SECONDS, sampleRate );
+    if ( ringSize != _delayRingSize ) {
+        _delayRingSize = ringSize;
+        createGraph();
+    }
+
+    // recalculate the tempo grid for the new sample rate
+
+    double tempo = _tempo;
+    _tempo = 0.0;
+    setTempo( tempo, _timeSigNumerator, _timeSigDenominator );
+}
+
+void PluginProcess::setInternalBlockSize( int blockSize, BlockAdapter::Mode mode )
+{
+    delete _blockAdapter;
+    _blockAdapter = nullptr;
+
+    if ( blockSize <= 0 ) {
+        return;
+    }
+    _blockAdapter = new BlockAdapter( mode, blockSize, _amountOfChannels + MAX_SIDECHAIN_CHANNELS );
+
+    // the mix buffers must be able to hold an internal block
+
+    if ( _maxBufferSize < _blockAdapter->getBlockSize()) {
+        setMaxBufferSize( _blockAdapter->getBlockSize());
+    }
+}
+
+void PluginProcess::createGraph()
+{
+    Arena* arena = new Arena( getArenaSize( _amountOfChannels, _maxBufferSize ));
+
+    // the processors first (their state spans a few cache lines) followed by
+    // the buffers, in the order in which these are accessed during processing
+
+    EnvelopeFollower* newEnvelopeFollower = arena->create<EnvelopeFollower>( 5.f, 150.f );
+    BitCrusher* newBitCrusher = arena->create<BitCrusher>( 8, .5f, .5f );
+    FilterBank* newFilterBank = arena->create<FilterBank>( _amountOfChannels );
+    Limiter* newLimiter       = arena->create<Limiter>( .15f, .5f, 1.f ); // limits at 0 dBFS
+    Limiter* newDucker        = arena->create<Limiter>();
+    Delay* newDelay           = nullptr;
+
+    float** delayRings = arena->allocateArray<float*>( _amountOfChannels );
+    float** delayTaps  = arena->allocateArray<float*>( 2 );
+
+    float* envelope = arena->allocateArray<float>( _maxBufferSize );
+
+    float** preMixBuffer = nullptr;
+    if ( !EffectChain::IS_FUSED ) {
+        preMixBuffer = arena->allocateArray<float*>( _amountOfChannels );
+        for ( int c = 0; c < _amountOfChannels; ++c ) {
+            preMixBuffer[ c ] = arena->allocateArray<float>( _maxBufferSize );
+        }
+    }
+
+    // the delay lines are the largest (and least frequently accessed as a whole) and come last
+
+    for ( int i = 0; i < 2; ++i ) {
+        delayTaps[ i ] = arena->allocateArray<float>( _maxBufferSize );
+    }
+    for ( int c = 0; c < _amountOfChannels; ++c ) {
+        delayRings[ c ] = arena->allocateArray<float>( _delayRingSize );
+    }
+    newDelay = arena->create<Delay>( delayRings, _amountOfChannels, _delayRingSize, delayTaps, _maxBufferSize );
+
+    EffectChain* chain = arena->create<EffectChain>( *newBitCrusher, *newFilterBank, *convolver, *newDelay );
+
+    // when resizing, the processors retain their settings and state
+
+    if ( _arena != nullptr ) {
+        *newEnvelopeFollower = *envelopeFollower;
+        *newBitCrusher       = *bitCrusher;
+        *newFilterBank       = *filterBank;
+        *newLimiter          = *limiter;
+        *newDucker           = *ducker;
+        newDelay->copySettings( *delay );
+
+        delete _arena;
+    }
+    _arena           = arena;
+    envelopeFollower = newEnvelopeFollower;
+    bitCrusher       = newBitCrusher;
+    filterBank       = newFilterBank;
+    limiter          = newLimiter;
+    ducker           = newDucker;
+    delay            = newDelay;
+    _chain           = chain;
+    _preMixBuffer    = preMixBuffer;
+    _envelope        = envelope;
+}
+
+size_t PluginProcess::getArenaSize( int amountOfChannels, int maxBufferSize ) const
+{
+    size_t size = Arena::alignSize( sizeof( EnvelopeFollower )) +
+                  Arena::alignSize( sizeof( BitCrusher )) +
+                  Arena::alignSize( sizeof( FilterBank )) +
+                  Arena::alignSize( sizeof( Limiter )) * 2 +
+                  Arena::alignSize( sizeof( EffectChain )) +
+                  Arena::alignSize( sizeof( float ) * maxBufferSize ) +
+                  // delay
+                  Arena::alignSize( sizeof( Delay )) +
+                  Arena::alignSize( sizeof( float* ) * amountOfChannels ) +
+                  Arena::alignSize( sizeof( float* ) * 2 ) +
+                  Arena::alignSize( sizeof( float ) * maxBufferSize ) * 2 +
+                  Arena::alignSize( sizeof( float ) * _delayRingSize ) * amountOfChannels;
+
+    if ( !EffectChain::IS_FUSED ) {
+        size += Arena::alignSize( sizeof( float* ) * amountOfChannels ) +
+                Arena::alignSize( sizeof( float ) * maxBufferSize ) * amountOfChannels;
+    }
+    return size;
+}
+
+float PluginProcess::getGainReduction() const
+{
+    return ( _isLimiting ? limiter->getLinearGR() : 1.f ) * ducker->getLinearGR();
+}
+
+int PluginProcess::getLatencySamples() const
+{
+    return ( _blockAdapter != nullptr ? _blockAdapter->getLatencySamples() : 0 ) + bitCrusher->getLatencySamples();
+}
+
+int PluginProcess::getMaxLatencySamples() const
+{
+    return ( _blockAdapter != nullptr ? _blockAdapter->getLatencySamples() : 0 ) + BitCrusher::MAX_LATENCY_SAMPLES;
 }
 
 /* setters */
@@ -59,23 +245,93 @@ void PluginProcess::setWetMix( float value ) {
     _wetMix = value;
 }
 
+void PluginProcess::setSideChainDuck( float value ) {
+    _sideChainDuck = value;
+}
+
+void PluginProcess::setSideChainCrush( float value ) {
+    _sideChainCrush = value;
+}
+
+void PluginProcess::setLimiterEnabled( bool enabled ) {
+    if ( enabled && !_isLimiting ) {
+        limiter->reset(); // do not resume from the gain reduction of a previous run
+    }
+    _isLimiting = enabled;
+}
+
+void PluginProcess::setDelayTime( float value ) {
+    int note = std::min( DELAY_NOTE_COUNT - 1, ( int ) round( value * ( DELAY_NOTE_COUNT - 1 )));
+
+    if ( note != _delayNote ) {
+        _delayNote = note;
+        updateDelayTime();
+    }
+}
+
+void PluginProcess::setDelayFeedback( float value ) {
+    delay->setFeedback( value );
+}
+
+void PluginProcess::setDelayMix( float value ) {
+    delay->setMix( value );
+}
+
+void PluginProcess::reset()
+{
+    bitCrusher->reset();
+    filterBank->reset();
+    convolver->reset();
+    limiter->reset();
+    ducker->reset();
+    envelopeFollower->reset();
+    delay->reset();
+
+    if ( _blockAdapter != nullptr ) {
+        _blockAdapter->reset();
+    }
+
+    for ( int c = 0; _preMixBuffer != nullptr && c < _amountOfChannels; ++c ) {
+        memset( _preMixBuffer[ c ], 0, _maxBufferSize * sizeof( float ));
+    }
+    memset( _envelope, 0, _maxBufferSize * sizeof( float ));
+    memset( _dryHistory, 0, sizeof( _dryHistory ));
+}
+
 bool PluginProcess::setTempo( double tempo, int32 timeSigNumerator, int32 timeSigDenominator )
 {
     if ( _tempo == tempo && _timeSigNumerator == timeSigNumerator && _timeSigDenominator == timeSigDenominator ) {
         return false; // no change
     }
+    if ( tempo <= 0.0 || timeSigNumerator <= 0 || timeSigDenominator <= 0 ) {
+        return false; // invalid (e.g. not provided by the host)
+    }
 
     _timeSigNumerator   = timeSigNumerator;
     _timeSigDenominator = timeSigDenominator;
     _tempo              = tempo;
 
-    _fullMeasureDuration = ( 60.f / _tempo ) * _timeSigDenominator; // seconds per measure
-    _fullMeasureSamples  = Calc::secondsToBuffer( _fullMeasureDuration ); // samples per measure
-    _beatSamples         = ceil( _fullMeasureSamples / _timeSigDenominator ); // samples per beat
-    _halfMeasureSamples  = ceil( _fullMeasureSamples / 2 ); // samples per half measure
-    _sixteenthSamples    = ceil( _fullMeasureSamples / 16 ); // samples per 16th note
+    // the tempo is expressed in quarter notes per minute, all note values are derived from the
+    // duration of a quarter note (e.g. a 1/4 is a quarter note regardless of the time signature)
+
+    double quarterDuration = 60.0 / _tempo;
+
+    _quarterSamples = quarterDuration * _sampleRate; // samples per quarter note (fractional)
+
+    updateDelayTime();
 
     return true;
 }
 
+void PluginProcess::updateDelayTime()
+{
+    // note this doesn't allocate, changes crossfade between the previous and new delay time
+    // the duration of each note value (1/16, 1/8, 1/4 and 1/2) in quarter notes
+
+    static const double NOTE_QUARTERS[ DELAY_NOTE_COUNT ] = { .25, .5, 1.0, 2.0 };
+
+    int note = std::max( 0, std::min( DELAY_NOTE_COUNT - 1, _delayNote ));
+    delay->setDelayTime(( int ) ceil( _quarterSamples * NOTE_QUARTERS[ note ] ));
+}
+
 }
@@ -24,9 +24,23 @@
 #define __PluginProcess__H_INCLUDED__
 
 #include "global.h"
-#include "audiobuffer.h"
+#include "arena.h"
 #include "bitcrusher.h"
+#include "chain.h"
+#include "convolver.h"
+#include "delay.h"
+#include "filterbank.h"
 #include "limiter.h"
+#include "blockadapter.h"
+#include "envelopefollower.h"
+#include "denormals.h"
+#include "logger.h"
+#include "processingcontext.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+#include <vector>
 
 using namespace Steinberg;
 
@@ -34,14 +48,59 @@ namespace Igorski {
 class PluginProcess {
 
     public:
-        PluginProcess( int amountOfChannels );
+        static constexpr int MAX_SIDECHAIN_CHANNELS = 2;
+        static constexpr float DUCK_SENSITIVITY     = 8.f; // at full duck, a 0 dBFS key yields ~19 dB of gain reduction
+
+        // the supported range of the tempo synchronized delay, its memory is sized for the longest
+        // note value (a half note) at MIN_TEMPO, longer delay times are capped
+
+        static constexpr double MIN_TEMPO        = 40.0;
+        static constexpr float MAX_DELAY_SECONDS = ( float ) ( 60.0 / MIN_TEMPO ) * 2.f;
+        static constexpr int DELAY_NOTE_COUNT    = 4; // 1/16, 1/8, 1/4, 1/2 (see setDelayTime())
+
+        // all processors and buffers are allocated up front in a single arena (see arena.h)
+        // sized for the amount of channels, maximum block size and sample rate of given context
+
+        PluginProcess( const ProcessingContext& context );
         ~PluginProcess();
 
+        int getAmountOfChannels() const { return _amountOfChannels; }
+        const ProcessingContext& getProcessingContext() const { return _context; }
+
+        // update the processors for the maximum block size and sample rate of given context, retaining
+        // their settings. Should not be invoked from the audio thread (reallocates the processors and buffers
+        // when their required size changes). Larger blocks than context.maxBufferSize are processed in chunks
+        // NOTE: the amount of channels is fixed for the lifetime of the instance
+
+        void setProcessingContext( const ProcessingContext& context );
+
+        // optional: process audio in fixed size internal blocks (see blockadapter.h), where blockSize
+        // is rounded up to the next power of two. In FIXED_LATENCY mode this delays the output by the block size
+        // (see getLatencySamples()). A blockSize of 0 disables the block adapter. should not be invoked from the audio thread
+
+        void setInternalBlockSize( int blockSize, BlockAdapter::Mode mode );
+
+        // the latency (in samples) introduced by the processing (e.g. the block adapter and the bit crushers
+        // anti-aliasing), this can change while processing (see __PLUGIN_NAME__::reportLatency())
+
+        int getLatencySamples() const;
+
+        // the largest latency the processing can introduce at the current internal block size (e.g. with all
+        // settings affecting the latency enabled), to size latency compensating delay lines up front
+
+        int getMaxLatencySamples() const;
+
+        // the linear gain reduction applied to the output during the last processed block, combining
+        // that of the output limiter (when enabled) and the sidechain ducking (1.f meaning no gain reduction)
+
+        float getGainReduction() const;
+
         // apply effect to incoming sampleBuffer contents
+        // sideChainBuffer optionally provides the (host owned) sidechain signal used to key the effect
 
         template <typename SampleType>
         void process( SampleType** inBuffer, SampleType** outBuffer, int numInChannels, int numOutChannels,
-            int bufferSize, uint32 sampleFramesSize
+            int bufferSize, uint32 sampleFramesSize, SampleType** sideChainBuffer = nullptr, int numSideChainChannels = 0
         );
 
         // setters
@@ -49,42 +108,127 @@ class PluginProcess {
         void setDryMix( float value );
         void setWetMix( float value );
 
+        // the amount by which the sidechain signal ducks the output and reduces the bit crushers resolution
+
+        void setSideChainDuck( float value );
+        void setSideChainCrush( float value );
+
+        // whether the output is limited at 0 dBFS (disabled by default)
+
+        void setLimiterEnabled( bool enabled );
+
+        // the tempo synchronized delay, value is normalized and selects one of DELAY_NOTE_COUNT note values
+
+        void setDelayTime( float value );
+        void setDelayFeedback( float value );
+        void setDelayMix( float value );
+
         // synchronize the effects tempo with the host - when desired -
         // tempo is in BPM, time signature provided as: timeSigNumerator / timeSigDenominator (e.g. 3/4)
         // returns true when tempo has updated, false to indicate no change was made
 
         bool setTempo( double tempo, int32 timeSigNumerator, int32 timeSigDenominator );
 
-        // child processors
+        // clears all processing state (while retaining the settings) so that rendering
+        // the same input with the same settings produces identical output, invoked on activation
+        // and when resuming from bypass. This is safe to invoke from the audio thread as the
+        // largest state (the delay lines and the convolution history) is invalidated rather than cleared
+
+        void reset();
+
+        // child processors (owned by the arena)
 
         BitCrusher* bitCrusher;
-        Limiter* limiter;
+        Limiter* limiter; // prevents the output from exceeding 0 dBFS (when enabled, see setLimiterEnabled())
+        Limiter* ducker;  // keyed by the sidechain signal (see setSideChainDuck())
+        EnvelopeFollower* envelopeFollower; // tracks the sidechain signal
+        FilterBank* filterBank; // tone shaping applied after the bit crusher
+        Delay* delay;
+
+        // the convolver is not owned by the arena as it loads its impulse responses in the background
+        // (and is not recreated when the arena is)
+
+        Convolver* convolver;
+
+#if DEVELOPMENT
+        // diagnostic: total amount of subnormal values written to the output
+        uint64 getSubnormalCount() const { return _subnormalCount; }
+#endif
 
     private:
-        AudioBuffer* _preMixBuffer;  // buffer used for the pre effect mixing
-        AudioBuffer* _postMixBuffer; // buffer used for the post effect mixing
+        // the effect chain applied to each channel (see chain.h), to add an effect, add its processor
+        // as a stage (e.g. providing a per sample tick() function) and create it in createGraph()
+
+        typedef Chain<BitCrusher, FilterBank, Convolver, Delay> EffectChain;
+
+        Arena* _arena;           // holds the child processors and the buffers below
+        EffectChain* _chain;
+        float** _preMixBuffer;   // buffer used for the pre effect mixing (one for each channel, only
+                                 // allocated when the effect chain contains block stages)
+        BlockAdapter* _blockAdapter;
+        ProcessingContext _context;
 
         float _dryMix;
         float _wetMix;
+        double _dryHistory[ BlockAdapter::MAX_CHANNELS ][ 2 ]; // aligns the dry signal with the latency of the effect chain
+        BitCrusher::AntiAliasing _dryAntiAliasing = BitCrusher::AntiAliasing::NONE; // the alignment of the dry history
         int _amountOfChannels;
+        int _maxBufferSize;
+        float _sampleRate;
+        int _delayRingSize;
+
+        // sidechain related
+
+        float _sideChainDuck;
+        float _sideChainCrush;
+        int _numSideChainChannels;     // for the current process cycle (0 when there is no sidechain)
+        bool _isDucking;
+        bool _isLimiting;
+        float* _envelope;              // envelope of the sidechain signal for the current block
 
         // tempo related
 
         double _tempo              = 0.0;
         int32 _timeSigNumerator    = 0;
         int32 _timeSigDenominator  = 0;
-        float _fullMeasureDuration = 1.f;
-        int _fullMeasureSamples    = 1;
-        int _halfMeasureSamples    = 1;
-        int _beatSamples           = 1;
-        int _sixteenthSamples      = 1;
+        double _quarterSamples     = 1.0;
+        int _delayNote             = 0;
+
+        // apply the delay time for the current note value and tempo grid
+        void updateDelayTime();
+
+#if DEVELOPMENT
+        uint64 _subnormalCount = 0;
+#endif
 
-        // ensures the pre- and post mix buffers match the appropriate amount of channels
-        // and buffer size. this also clones the contents of given in buffer into the pre-mix buffer
-        // the buffers are pooled so this can be called upon each process cycle without allocation overhead
+        // processes a block of at most _maxBufferSize samples, starting at given offset in the in- and output buffers
+        // inBuffer is followed by _numSideChainChannels sidechain channels
 
         template <typename SampleType>
-        void prepareMixBuffers( SampleType** inBuffer, int numInChannels, int bufferSize );
+        void processBlock( SampleType** inBuffer, SampleType** outBuffer, int numChannels, int offset, int bufferSize );
+
+        // clones the contents of given in buffer into the pre-mix buffer
+        // the buffers are pooled (see setMaxBufferSize()) so this can be called upon each process cycle without allocation overhead
+
+        template <typename SampleType>
+        void prepareMixBuffers( SampleType** inBuffer, int numChannels, int offset, int bufferSize );
+
+        // reallocate the processors and buffers for given maximum block size, retaining their settings
+
+        void setMaxBufferSize( int maxBufferSize );
+
+        // update the processors for given sample rate (reallocates the delay lines when their required size changes)
+
+        void setSampleRate( float sampleRate );
+
+        // defer the convolvers tail to its background thread when processing in realtime (see Convolver::setDeferredTail())
+
+        void updateDeferredTail();
+
+        // (re)creates the arena holding the child processors and buffers for the current _maxBufferSize
+
+        void createGraph();
+        size_t getArenaSize( int amountOfChannels, int maxBufferSize ) const;
 };
 }
 
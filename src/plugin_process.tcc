@@ -24,93 +24,205 @@ namespace Igorski
 {
 template <typename SampleType>
 void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int numInChannels, int numOutChannels,
-                             int bufferSize, uint32 sampleFramesSize ) {
+                             int bufferSize, uint32 sampleFramesSize, SampleType** sideChainBuffer, int numSideChainChannels ) {
+
+    TRACE_ZONE( "PluginProcess::process" );
+
+    // prevent subnormal values (e.g. on decaying tails) from degrading performance
+    ScopedNoDenormals noDenormals;
+
+    if ( bufferSize <= 0 ) {
+        return;
+    }
+
+    // only process the channels present in both the in- and output as well as the mix buffers
+    // output channels without corresponding input are silenced
+
+    int numChannels = std::min( _amountOfChannels, std::min( numInChannels, numOutChannels ));
+
+    // the sidechain channels directly follow the input channels (no copy of the sidechain
+    // signal is made, it is read directly from the host buffers)
+
+    SampleType* inputs[ BlockAdapter::MAX_CHANNELS ];
+
+    _numSideChainChannels = sideChainBuffer != nullptr ? std::min( numSideChainChannels, MAX_SIDECHAIN_CHANNELS ) : 0;
+    numChannels = std::min( numChannels, BlockAdapter::MAX_CHANNELS - _numSideChainChannels );
+
+    for ( int32 c = 0; c < numChannels; ++c ) {
+        inputs[ c ] = inBuffer[ c ];
+    }
+    for ( int32 c = 0; c < _numSideChainChannels; ++c ) {
+        inputs[ numChannels + c ] = sideChainBuffer[ c ];
+    }
+
+    for ( int32 c = numChannels; c < numOutChannels; ++c ) {
+        memset( outBuffer[ c ], 0, bufferSize * sizeof( SampleType ));
+    }
+
+    auto processor = [ this ]( auto** in, auto** out, int channels, int offset, int size )
+    {
+        // blocks larger than the mix buffers are processed in consecutive chunks
+        for ( int end = offset + size; offset < end; offset += _maxBufferSize ) {
+            processBlock( in, out, channels, offset, std::min( _maxBufferSize, end - offset ));
+        }
+    };
+
+    if ( _blockAdapter != nullptr ) {
+        _blockAdapter->process( inputs, outBuffer, numChannels, _numSideChainChannels, bufferSize, processor );
+    } else {
+        processor( inputs, outBuffer, numChannels, 0, bufferSize );
+    }
+
+    // the keyed limiter (see processBlock()) reports no gain reduction once ducking has stopped
+
+    bool isDucking = _numSideChainChannels > 0 && _sideChainDuck > 0.f;
+    if ( _isDucking && !isDucking ) {
+        ducker->reset();
+    }
+    _isDucking = isDucking;
+
+    // limit the output signal in case its gets hot
+
+    if ( _isLimiting ) {
+        TRACE_ZONE( "Limiter::process" );
+        limiter->process<SampleType>( outBuffer, bufferSize, numChannels );
+    }
+
+#if DEVELOPMENT
+    int subnormals = 0;
+    for ( int32 c = 0; c < numOutChannels; ++c ) {
+        subnormals += Denormals::countSubnormals( outBuffer[ c ], bufferSize );
+    }
+    if ( subnormals > 0 ) {
+        _subnormalCount += subnormals;
+        Logger::log( "PluginProcess::process() subnormal output values", subnormals );
+    }
+#endif
+}
+
+template <typename SampleType>
+void PluginProcess::processBlock( SampleType** inBuffer, SampleType** outBuffer, int numChannels, int offset, int bufferSize ) {
+
+    TRACE_ZONE( "PluginProcess::processBlock" );
 
     // input and output buffers can be float or double as defined
     // by the templates SampleType value. Internally we process
     // audio as floats
 
-    SampleType inSample;
-    int i, readIndex;
-
     bool mixDry = _dryMix != 0.f;
 
+    // the dry signal is aligned with the latency of the effect chain (half a sample or a single sample, see
+    // BitCrusher::alignWithAntiAliasing()), as a whole sample delay would comb filter against a half sample
+
+    BitCrusher::AntiAliasing antiAliasing = bitCrusher->getAntiAliasing();
+    if ( antiAliasing != _dryAntiAliasing ) {
+        // like the BitCrushers history, the dry history is seeded with silence when the anti-aliasing changes
+        memset( _dryHistory, 0, sizeof( _dryHistory ));
+        _dryAntiAliasing = antiAliasing;
+    }
+
     SampleType dryMix = ( SampleType ) _dryMix;
     SampleType wetMix = ( SampleType ) _wetMix;
 
-    prepareMixBuffers( inBuffer, numInChannels, bufferSize );
+    // track the sidechain signal
+
+    bool isKeyed = _numSideChainChannels > 0;
+    if ( isKeyed ) {
+        TRACE_ZONE( "EnvelopeFollower::process" );
+        envelopeFollower->process( inBuffer + numChannels, _numSideChainChannels, offset, bufferSize, _envelope );
+    }
+    const float* envelope = _envelope;
+
+    // interpolate changed filter coefficients across this block and swap in a newly loaded impulse response
 
-    for ( int32 c = 0; c < numInChannels; ++c )
     {
-        SampleType* channelInBuffer  = inBuffer[ c ];
-        SampleType* channelOutBuffer = outBuffer[ c ];
-        float* channelPreMixBuffer   = _preMixBuffer->getBufferForChannel( c );
-        float* channelPostMixBuffer  = _postMixBuffer->getBufferForChannel( c );
+        TRACE_ZONE( "PluginProcess::prepareStages" );
+        filterBank->prepare( bufferSize );
+        convolver->prepare();
+    }
 
-        // example processing: apply some bit crushing onto the premix buffer
-        bitCrusher->process( channelPreMixBuffer, bufferSize );
+    // when the effect chain has block stages, the input is materialized into the pre mix buffers
 
-        // POST MIX processing
-        // apply the post mix effect processing
+    if constexpr ( !EffectChain::IS_FUSED ) {
+        prepareMixBuffers( inBuffer, numChannels, offset, bufferSize );
+    }
+
+    for ( int32 c = 0; c < numChannels; ++c )
+    {
+        TRACE_ZONE( "PluginProcess::processChannel" );
 
-        // this is just cloning the pre mix buffer so we can hear output in this example
-        for ( i = 0; i < bufferSize; ++i ) {
-            channelPostMixBuffer[ i ] = ( float ) channelPreMixBuffer[ i ];
+        SampleType* channelInBuffer  = inBuffer[ c ] + offset;
+        SampleType* channelOutBuffer = outBuffer[ c ] + offset;
+
+        // prepare the stages of the effect chain for this block
+        // (where the sidechain signal can further reduce the bit crushers resolution)
+
+        if ( isKeyed ) {
+            bitCrusher->begin( envelope, _sideChainCrush, c );
+        } else {
+            bitCrusher->begin( nullptr, 0.f, c );
         }
+        filterBank->begin( c );
+        convolver->begin( c );
+        delay->begin( c );
 
-        // mix the input and processed post mix buffers into the output buffer
+        if constexpr ( !EffectChain::IS_FUSED ) {
+            _chain->process( _preMixBuffer[ c ], bufferSize );
+        }
 
-        for ( i = 0; i < bufferSize; ++i ) {
+        for ( int i = 0; i < bufferSize; ++i ) {
 
             // before writing to the out buffer we take a snapshot of the current in sample
             // value as VST2 in Ableton Live supplies the same buffer for inBuffer and outBuffer!
-            inSample = channelInBuffer[ i ];
+            SampleType inSample = channelInBuffer[ i ];
 
-            // wet mix (e.g. the effected signal)
-            channelOutBuffer[ i ] = ( SampleType ) channelPostMixBuffer[ i ] * wetMix;
+            // wet mix (e.g. the effected signal), when the chain only consists of per sample stages
+            // it is processed here, without intermediate buffers (non-finite input is replaced by silence)
 
-            // dry mix (e.g. mix in the input signal)
-            if ( mixDry ) {
-                channelOutBuffer[ i ] += ( inSample * dryMix );
+            float wetSample;
+            if constexpr ( EffectChain::IS_FUSED ) {
+                float sample = ( float ) inSample;
+                wetSample = _chain->tick( std::isfinite( sample ) ? sample : 0.f, i );
+            } else {
+                wetSample = _preMixBuffer[ c ][ i ];
+            }
+            channelOutBuffer[ i ] = ( SampleType ) wetSample * wetMix;
+
+            // dry mix (e.g. mix in the input signal), non-finite input is not passed through
+            SampleType drySample = ( SampleType ) BitCrusher::alignWithAntiAliasing<double>( antiAliasing, ( double ) inSample, _dryHistory[ c ] );
+            if ( mixDry && std::isfinite( drySample )) {
+                channelOutBuffer[ i ] += ( drySample * dryMix );
             }
         }
     }
 
-    // limit the output signal in case its gets hot
-    //limiter->process<SampleType>( outBuffer, bufferSize, numOutChannels );
+    // duck the output by the sidechain signal
+
+    if ( isKeyed && _sideChainDuck > 0.f ) {
+        TRACE_ZONE( "Limiter::processKeyed" );
+        ducker->processKeyed( outBuffer, offset, bufferSize, numChannels, envelope, _sideChainDuck * DUCK_SENSITIVITY );
+    }
 }
 
 template <typename SampleType>
-void PluginProcess::prepareMixBuffers( SampleType** inBuffer, int numInChannels, int bufferSize )
+void PluginProcess::prepareMixBuffers( SampleType** inBuffer, int numChannels, int offset, int bufferSize )
 {
-    // if the pre mix buffer wasn't created yet or the buffer size has changed
-    // delete existing buffer and create new one to match properties
-
-    if ( _preMixBuffer == nullptr || _preMixBuffer->bufferSize != bufferSize ) {
-        delete _preMixBuffer;
-        _preMixBuffer = new AudioBuffer( numInChannels, bufferSize );
-    }
+    TRACE_ZONE( "PluginProcess::prepareMixBuffers" );
 
     // clone the in buffer contents
     // note the clone is always cast to float as it is
     // used for internal processing (see PluginProcess::process)
+    // non-finite values (NaN, Inf) and values outside of the float range are replaced by silence
 
-    for ( int c = 0; c < numInChannels; ++c ) {
-        SampleType* inChannelBuffer = ( SampleType* ) inBuffer[ c ];
-        float* outChannelBuffer     =  _preMixBuffer->getBufferForChannel( c );
+    for ( int c = 0; c < numChannels; ++c ) {
+        SampleType* inChannelBuffer = inBuffer[ c ] + offset;
+        float* outChannelBuffer     = _preMixBuffer[ c ];
 
         for ( int i = 0; i < bufferSize; ++i ) {
-            outChannelBuffer[ i ] = ( float ) inChannelBuffer[ i ];
+            float sample = ( float ) inChannelBuffer[ i ];
+            outChannelBuffer[ i ] = std::isfinite( sample ) ? sample : 0.f;
         }
     }
-
-    // if the post mix buffer wasn't created yet or the buffer size has changed
-    // delete existing buffer and create new one to match properties
-
-    if ( _postMixBuffer == nullptr || _postMixBuffer->bufferSize != bufferSize ) {
-        delete _postMixBuffer;
-        _postMixBuffer = new AudioBuffer( numInChannels, bufferSize );
-    }
 }
 
 }
@@ -0,0 +1,277 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "presetbank.h"
+#include <algorithm>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+PresetBank::PresetBank()
+: _data( nullptr )
+, _size( 0 )
+, _header( nullptr )
+, _index( nullptr )
+, _records( nullptr )
+#ifdef _WIN32
+, _fileHandle( nullptr )
+, _mappingHandle( nullptr )
+#endif
+{
+
+}
+
+PresetBank::~PresetBank()
+{
+    close();
+}
+
+/* public methods */
+
+PresetBank* PresetBank::getInstance()
+{
+    static PresetBank instance;
+    return &instance;
+}
+
+bool PresetBank::open( const char* path )
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( file == INVALID_HANDLE_VALUE ) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    if ( GetFileSizeEx( file, &fileSize ) && fileSize.QuadPart > 0 ) {
+        mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    }
+    if ( mapping == nullptr ) {
+        CloseHandle( file );
+        return false;
+    }
+    _data          = ( const char* ) MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    _size          = ( size_t ) fileSize.QuadPart;
+    _fileHandle    = file;
+    _mappingHandle = mapping;
+#else
+    int file = ::open( path, O_RDONLY );
+    if ( file < 0 ) {
+        return false;
+    }
+    struct stat fileInfo;
+    if ( fstat( file, &fileInfo ) != 0 || fileInfo.st_size <= 0 ) {
+        ::close( file );
+        return false;
+    }
+    void* data = mmap( nullptr, ( size_t ) fileInfo.st_size, PROT_READ, MAP_PRIVATE, file, 0 );
+    ::close( file ); // the mapping remains valid after closing the descriptor
+
+    if ( data == MAP_FAILED ) {
+        return false;
+    }
+    _data = ( const char* ) data;
+    _size = ( size_t ) fileInfo.st_size;
+#endif
+
+    if ( _data == nullptr || _size < sizeof( PresetBankHeader )) {
+        close();
+        return false;
+    }
+
+    // validate the header against the current model
+
+    const PresetBankHeader* header = ( const PresetBankHeader* ) _data;
+
+    size_t indexEnd  = ( size_t ) header->indexOffset  + ( size_t ) header->presetCount * sizeof( PresetIndexEntry );
+    size_t recordEnd = ( size_t ) header->recordOffset + ( size_t ) header->presetCount * sizeof( PresetRecord );
+
+    if ( header->magic != BANK_MAGIC || header->version > BANK_VERSION ||
+         header->recordSize != sizeof( PresetRecord ) ||
+         ( header->indexOffset % alignof( PresetIndexEntry )) != 0 ||
+         ( header->recordOffset % alignof( PresetRecord )) != 0 ||
+         indexEnd > _size || recordEnd > _size )
+    {
+        close();
+        return false;
+    }
+
+    _header  = header;
+    _index   = ( const PresetIndexEntry* ) ( _data + header->indexOffset );
+    _records = ( const PresetRecord* ) ( _data + header->recordOffset );
+
+    return true;
+}
+
+void PresetBank::close()
+{
+    if ( _data != nullptr ) {
+#ifdef _WIN32
+        UnmapViewOfFile( _data );
+#else
+        munmap(( void* ) _data, _size );
+#endif
+    }
+#ifdef _WIN32
+    if ( _mappingHandle != nullptr ) {
+        CloseHandle(( HANDLE ) _mappingHandle );
+        _mappingHandle = nullptr;
+    }
+    if ( _fileHandle != nullptr ) {
+        CloseHandle(( HANDLE ) _fileHandle );
+        _fileHandle = nullptr;
+    }
+#endif
+    _data    = nullptr;
+    _size    = 0;
+    _header  = nullptr;
+    _index   = nullptr;
+    _records = nullptr;
+}
+
+int PresetBank::getPresetCount() const
+{
+    return _header != nullptr ? ( int ) _header->presetCount : 0;
+}
+
+const char* PresetBank::getPresetName( int index ) const
+{
+    if ( index < 0 || index >= getPresetCount()) {
+        return nullptr;
+    }
+    return _index[ index ].name;
+}
+
+const PresetRecord* PresetBank::getPreset( int index ) const
+{
+    if ( index < 0 || index >= getPresetCount()) {
+        return nullptr;
+    }
+    uint32 recordIndex = _index[ index ].recordIndex;
+    return recordIndex < _header->presetCount ? &_records[ recordIndex ] : nullptr;
+}
+
+const PresetRecord* PresetBank::findPreset( const char* name ) const
+{
+    uint32 nameHash = hash( name );
+
+    for ( int i = 0, l = getPresetCount(); i < l; ++i ) {
+        if ( _index[ i ].hash == nameHash && strncmp( _index[ i ].name, name, PresetIndexEntry::NAME_LENGTH ) == 0 ) {
+            return getPreset( i );
+        }
+    }
+    return nullptr;
+}
+
+const PresetRecord* PresetBank::findPreset( uint32 nameHash ) const
+{
+    for ( int i = 0, l = getPresetCount(); i < l; ++i ) {
+        if ( _index[ i ].hash == nameHash ) {
+            return getPreset( i );
+        }
+    }
+    return nullptr;
+}
+
+uint32 PresetBank::hash( const char* name )
+{
+    uint32 value = 2166136261u;
+
+    for ( int i = 0; name[ i ] != '\0' && i < PresetIndexEntry::NAME_LENGTH; ++i ) {
+        value ^= ( uint8 ) name[ i ];
+        value *= 16777619u;
+    }
+    return value;
+}
+
+bool PresetBank::writeState( IBStreamer& streamer, const PresetRecord& record )
+{
+    if ( !streamer.writeInt32u( STATE_MAGIC ) ||
+         !streamer.writeInt32u( STATE_VERSION ) ||
+         !streamer.writeInt32u( sizeof( PresetRecord )))
+    {
+        return false;
+    }
+
+    if ( !streamer.writeInt32( record.bypass )) {
+        return false;
+    }
+
+    // the model is written as a whole (all supported platforms are little endian)
+
+    return streamer.writeRaw( &record.model, sizeof( PluginModel )) == sizeof( PluginModel );
+}
+
+bool PresetBank::readState( IBStreamer& streamer, PresetRecord& record )
+{
+    int32 firstValue = 0;
+    if ( streamer.readInt32( firstValue ) == false ) {
+        return false;
+    }
+
+    int32 modelSize = sizeof( PluginModel );
+
+    if (( uint32 ) firstValue == STATE_MAGIC ) {
+        // versioned state
+        uint32 version    = 0;
+        uint32 recordSize = 0;
+        if ( !streamer.readInt32u( version ) || !streamer.readInt32u( recordSize ) || recordSize < sizeof( int32 )) {
+            return false;
+        }
+        if ( !streamer.readInt32( record.bypass )) {
+            return false;
+        }
+        // values for parameters unknown to this version are not read
+        modelSize = std::min( modelSize, ( int32 ) ( recordSize - sizeof( int32 )));
+    }
+    else {
+        // legacy state, which started directly with the bypass value
+        // (and always contained the full set of values for its model)
+        record.bypass = firstValue;
+    }
+
+    // read the model as a whole, when the stream was saved by a version with less
+    // parameters, only the values present are applied (the remaining values are kept as-is)
+
+    PluginModel model = record.model;
+    int32 bytesRead   = ( int32 ) streamer.readRaw( &model, modelSize );
+    int32 valuesRead  = std::max( 0, bytesRead ) / ( int32 ) sizeof( float );
+
+    memcpy( getModelValues( record.model ), getModelValues( model ), valuesRead * sizeof( float ));
+
+    return true;
+}
+
+}
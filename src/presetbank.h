@@ -0,0 +1,132 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __PRESETBANK_H_INCLUDED__
+#define __PRESETBANK_H_INCLUDED__
+
+#include "global.h"
+#include "model.h"
+#include "base/source/fstreamer.h"
+#include <cstddef>
+
+using namespace Steinberg;
+
+namespace Igorski {
+
+/**
+ * Fixed layout representation of the plugin state, holding the bypass state and
+ * the normalized model values (see model.h). The same layout is used for the component
+ * state (see __PLUGIN_NAME__::getState()) and the records of a preset bank.
+ */
+struct PresetRecord {
+    int32 bypass;
+    PluginModel model;
+};
+
+static_assert( sizeof( PresetRecord ) == sizeof( int32 ) + sizeof( PluginModel ), "PresetRecord must not contain padding" );
+
+/**
+ * A PresetBank is a read-only, versioned binary file containing factory presets
+ * (generated by generateModel.js). Its layout is:
+ *
+ * PresetBankHeader
+ * PresetIndexEntry * presetCount (to look up presets by name or hash)
+ * PresetRecord     * presetCount
+ *
+ * All values are stored little endian. The bank is memory mapped so recalling a
+ * preset is merely retrieving a pointer to its record, which is safe to do from the
+ * audio thread.
+ */
+struct PresetBankHeader {
+    uint32 magic;
+    uint32 version;
+    uint32 presetCount;
+    uint32 recordSize;   // should equal sizeof( PresetRecord ) or the bank was generated for a different model
+    uint32 indexOffset;  // in bytes, relative to start of file
+    uint32 recordOffset; // in bytes, relative to start of file
+};
+
+struct PresetIndexEntry {
+    static const int NAME_LENGTH = 32;
+
+    char name[ NAME_LENGTH ];
+    uint32 hash; // see PresetBank::hash()
+    uint32 recordIndex;
+};
+
+class PresetBank {
+
+    public:
+        static const uint32 BANK_MAGIC    = 0x4B4E4247; // "GBNK"
+        static const uint32 BANK_VERSION  = 1;
+        static const uint32 STATE_MAGIC   = 0x54534749; // "IGST"
+        static const uint32 STATE_VERSION = 1;
+
+        PresetBank();
+        ~PresetBank();
+
+        // the bank shared by all instances within the module (see vstentry.cpp)
+
+        static PresetBank* getInstance();
+
+        // map given file into memory (read-only), returns false when the file
+        // could not be opened or doesn't describe a valid bank for the current model
+
+        bool open( const char* path );
+        void close();
+
+        int getPresetCount() const;
+        const char* getPresetName( int index ) const;
+
+        // retrieve presets, these return nullptr when given index or name is unknown
+
+        const PresetRecord* getPreset( int index ) const;
+        const PresetRecord* findPreset( const char* name ) const;
+        const PresetRecord* findPreset( uint32 hash ) const;
+
+        // FNV-1a hash of given preset name
+
+        static uint32 hash( const char* name );
+
+        // (de)serialization of the component state. readState() accepts both the current,
+        // versioned format as well as the unversioned streams written prior to its introduction.
+        // Values missing from the stream (e.g. saved by an older version) retain the values present in record.
+
+        static bool writeState( IBStreamer& streamer, const PresetRecord& record );
+        static bool readState( IBStreamer& streamer, PresetRecord& record );
+
+    private:
+        const char* _data;
+        size_t _size;
+        const PresetBankHeader* _header;
+        const PresetIndexEntry* _index;
+        const PresetRecord* _records;
+
+#ifdef _WIN32
+        void* _fileHandle;
+        void* _mappingHandle;
+#endif
+};
+
+}
+
+#endif
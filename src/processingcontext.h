@@ -0,0 +1,71 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __PROCESSINGCONTEXT_H_INCLUDED__
+#define __PROCESSINGCONTEXT_H_INCLUDED__
+
+#include "calc.h"
+
+namespace Igorski {
+
+/**
+ * ProcessingContext describes the configuration a plugin instance processes audio in, as
+ * negotiated with the host (see setupProcessing() and setBusArrangements()). Each instance
+ * holds its own context (instances can run at different sample rates, e.g. an offline render
+ * alongside a realtime instance) and passes it into its processors, which precompute their
+ * sample rate dependent values from it. A context is not modified once created, changes in
+ * configuration are applied by providing a new context (see PluginProcess::setProcessingContext()).
+ */
+struct ProcessingContext {
+
+    enum class Mode {
+        REALTIME = 0,
+        PREFETCH,
+        OFFLINE
+    };
+
+    ProcessingContext( float sampleRate = 44100.f, int maxBufferSize = 1024, int amountOfChannels = 2, Mode mode = Mode::REALTIME )
+        : sampleRate( sampleRate ), maxBufferSize( maxBufferSize ), amountOfChannels( amountOfChannels ), mode( mode ) {}
+
+    float sampleRate;
+    int maxBufferSize;    // the maximum amount of samples provided in a single process cycle
+    int amountOfChannels; // of the main in- and output busses
+    Mode mode;
+
+    bool isOffline() const { return mode == Mode::OFFLINE; }
+
+    // convert given value in seconds to the appropriate value in samples
+
+    int secondsToBuffer( float seconds ) const
+    {
+        return Calc::secondsToBuffer( seconds, sampleRate );
+    }
+
+    int millisecondsToBuffer( float milliseconds ) const
+    {
+        return Calc::millisecondsToBuffer( milliseconds, sampleRate );
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "resourceregistry.h"
+#include "global.h"
+#include <algorithm>
+#include <cstdint>
+#include <math.h>
+
+namespace Igorski {
+
+/* ResourceTable */
+
+ResourceTable::ResourceTable( const std::vector<float>& contents )
+: _storage( contents.size() + ALIGNMENT / sizeof( float ))
+, _size( ( int ) contents.size())
+{
+    uintptr_t address = ( uintptr_t ) _storage.data();
+    size_t offset     = (( ALIGNMENT - ( address % ALIGNMENT )) % ALIGNMENT ) / sizeof( float );
+
+    std::copy( contents.begin(), contents.end(), _storage.begin() + offset );
+    _data = _storage.data() + offset;
+}
+
+/* ResourceRegistry */
+
+ResourceRegistry* ResourceRegistry::getInstance()
+{
+    static ResourceRegistry instance;
+    return &instance;
+}
+
+SharedResource ResourceRegistry::acquire( ResourceId id, float sampleRate )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    ResourceKey key( id, sampleRate );
+    SharedResource resource = _resources[ key ].lock();
+
+    if ( !resource ) {
+        resource = std::make_shared<const ResourceTable>( build( id, sampleRate ));
+        _resources[ key ] = resource;
+    }
+    return resource;
+}
+
+void ResourceRegistry::preload( ResourceId id, float sampleRate )
+{
+    SharedResource resource = acquire( id, sampleRate );
+
+    std::lock_guard<std::mutex> lock( _mutex );
+    _preloaded.push_back( resource );
+}
+
+void ResourceRegistry::clear()
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    _preloaded.clear();
+    _resources.clear();
+}
+
+/* private methods */
+
+// synthesizes an impulse response of exponentially decaying noise (reaching -60 dB after decayTime
+// seconds) shaped by one-pole high- and low-pass filters, normalized to unit energy
+
+static std::vector<float> createImpulse( float sampleRate, float duration, float decayTime, float preDelay,
+                                         float highPass, float lowPass )
+{
+    int length  = std::max( 1, ( int ) ( duration * sampleRate ));
+    int delayed = std::min( length - 1, ( int ) ( preDelay * sampleRate ));
+    std::vector<float> impulse( length, 0.f );
+
+    float decay     = expf( -6.908f / ( decayTime * sampleRate )); // ln( 1000 )
+    float highCoeff = expf( -VST::TWO_PI * highPass / sampleRate );
+    float lowCoeff  = expf( -VST::TWO_PI * lowPass / sampleRate );
+
+    uint32_t seed = 0x1234567; // fixed, so all instances build identical responses
+    float envelope = 1.f, low = 0.f, rumble = 0.f, energy = 0.f;
+
+    for ( int i = delayed; i < length; ++i ) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = (( float ) ( seed >> 8 ) / 8388608.f - 1.f ) * envelope;
+        envelope *= decay;
+
+        low  = noise + lowCoeff * ( low - noise );
+        rumble = low + highCoeff * ( rumble - low ); // the content below the high-pass frequency
+        float sample = low - rumble;
+
+        impulse[ i ] = sample;
+        energy      += sample * sample;
+    }
+
+    float scale = energy > 0.f ? 1.f / sqrtf( energy ) : 0.f;
+    for ( float& sample : impulse ) {
+        sample *= scale;
+    }
+    return impulse;
+}
+
+std::vector<float> ResourceRegistry::build( ResourceId id, float sampleRate )
+{
+    std::vector<float> table;
+
+    switch ( id )
+    {
+        case ResourceId::SINE_TABLE:
+            table.resize( VST::SINE_TABLE_SIZE );
+            for ( int i = 0; i < VST::SINE_TABLE_SIZE; ++i ) {
+                table[ i ] = sinf( VST::TWO_PI * i / VST::SINE_TABLE_SIZE );
+            }
+            break;
+
+        case ResourceId::CABINET_IMPULSE:
+            table = createImpulse( sampleRate, .03f, .015f, 0.f, 90.f, 4500.f );
+            break;
+
+        case ResourceId::ROOM_IMPULSE:
+            table = createImpulse( sampleRate, .6f, .5f, .005f, 60.f, 7000.f );
+            break;
+
+        case ResourceId::HALL_IMPULSE:
+            table = createImpulse( sampleRate, 2.5f, 2.2f, .02f, 40.f, 5000.f );
+            break;
+    }
+    return table;
+}
+
+}
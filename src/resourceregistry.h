@@ -0,0 +1,105 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __RESOURCEREGISTRY_H_INCLUDED__
+#define __RESOURCEREGISTRY_H_INCLUDED__
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Igorski {
+
+/**
+ * An immutable table of samples or coefficients (e.g. a wave table, filter
+ * coefficients or an impulse response), its contents are aligned to a cache line
+ */
+class ResourceTable {
+
+    public:
+        static const int ALIGNMENT = 64; // in bytes
+
+        ResourceTable( const std::vector<float>& contents );
+
+        inline const float* getData() const { return _data; }
+        inline int getSize() const { return _size; }
+
+    private:
+        std::vector<float> _storage; // over allocated to allow alignment of _data
+        const float* _data;
+        int _size;
+};
+
+typedef std::shared_ptr<const ResourceTable> SharedResource;
+
+// all resources known to the registry, see ResourceRegistry::build()
+
+enum class ResourceId {
+    SINE_TABLE,      // single cycle sine wave (for the LFO), independent of the sample rate
+    CABINET_IMPULSE, // impulse responses (for the convolver) at the requested sample rate
+    ROOM_IMPULSE,
+    HALL_IMPULSE,
+};
+
+/**
+ * The ResourceRegistry provides read-only DSP resources shared by all instances within
+ * the module. Resources are built on first request (for a given sample rate) and are
+ * reference counted: these are released once no instance holds them, unless they were
+ * preloaded when initializing the module (see vstentry.cpp).
+ *
+ * Acquiring a resource can allocate and locks the registry, as such it should not be
+ * invoked from the audio thread (e.g. acquire resources when preparing the processors).
+ */
+class ResourceRegistry {
+
+    public:
+        // the registry shared by all instances within the module
+
+        static ResourceRegistry* getInstance();
+
+        // retrieve the resource for given sample rate (use 0 for sample rate independent resources)
+
+        SharedResource acquire( ResourceId id, float sampleRate = 0.f );
+
+        // build and retain given resource for the lifetime of the module (or until clear() is invoked)
+
+        void preload( ResourceId id, float sampleRate = 0.f );
+
+        // release all preloaded resources (resources still held by instances remain valid)
+
+        void clear();
+
+    private:
+        typedef std::pair<ResourceId, float> ResourceKey;
+
+        std::mutex _mutex;
+        std::map<ResourceKey, std::weak_ptr<const ResourceTable>> _resources;
+        std::vector<SharedResource> _preloaded;
+
+        static std::vector<float> build( ResourceId id, float sampleRate );
+};
+
+}
+
+#endif
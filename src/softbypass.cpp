@@ -0,0 +1,79 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "softbypass.h"
+
+namespace Igorski {
+
+/* constructor */
+
+SoftBypass::SoftBypass()
+{
+    _amountOfChannels = 0;
+    _maxBufferSize    = 0;
+    _fadeLength       = 1;
+    _latency          = 0;
+    _maxLatency       = 0;
+    _resumeMode       = Resume::RESET;
+    _bypass           = false;
+    _isMixing         = false;
+    _position         = _fadeLength;
+    _delayIndex       = 0;
+}
+
+/* public methods */
+
+void SoftBypass::prepare( int amountOfChannels, int maxBufferSize, int fadeLength, int latency, int maxLatency )
+{
+    _amountOfChannels = std::min( std::max( 1, amountOfChannels ), MAX_CHANNELS );
+    _maxBufferSize    = std::max( 1, maxBufferSize );
+    _fadeLength       = std::max( 1, fadeLength );
+    _maxLatency       = std::max( 0, std::max( latency, maxLatency ));
+    _latency          = std::max( 0, latency );
+
+    _dry.assign( _amountOfChannels, std::vector<double>( _maxBufferSize, 0.0 ));
+    _delayLines.assign( _amountOfChannels, std::vector<double>( _maxLatency > 0 ? _maxLatency + 1 : 0, 0.0 ));
+
+    reset( _bypass );
+}
+
+bool SoftBypass::setBypass( bool bypass )
+{
+    bool resume = !bypass && isBypassed();
+    _bypass = bypass;
+
+    return resume;
+}
+
+void SoftBypass::reset( bool bypass )
+{
+    _bypass     = bypass;
+    _position   = bypass ? 0 : _fadeLength;
+    _isMixing   = false;
+    _delayIndex = 0;
+
+    for ( auto& line : _delayLines ) {
+        std::fill( line.begin(), line.end(), 0.0 );
+    }
+}
+
+}
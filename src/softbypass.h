@@ -0,0 +1,234 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __SOFTBYPASS_H_INCLUDED__
+#define __SOFTBYPASS_H_INCLUDED__
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+namespace Igorski {
+
+/**
+ * SoftBypass crossfades between the processed and the unprocessed (dry) signal when toggling
+ * the bypass, preventing clicks. The dry signal is delayed by the latency of the processing, so
+ * both signals are aligned during the crossfade as well as while bypassed.
+ *
+ * Once fully bypassed (see isBypassed()) the processing can be skipped altogether. Upon resuming,
+ * the processing state is either reset (e.g. no stale delay tails are heard) or - in KEEP_WARM
+ * mode - the processing continues while bypassed (its output is discarded), at the expense
+ * of its CPU usage.
+ *
+ * usage within a process cycle:
+ *
+ *     if ( softBypass.setBypass( bypass )) -> reset the processing state
+ *     if ( softBypass.isBypassed()) {
+ *         softBypass.bypass( in, out, ... );
+ *     } else {
+ *         softBypass.storeInput( in, ... );
+ *         process( in, out, ... );
+ *         softBypass.mix( out, ... );
+ *     }
+ */
+class SoftBypass {
+
+    public:
+        static constexpr int MAX_CHANNELS = 8;
+
+        enum class Resume {
+            RESET = 0,
+            KEEP_WARM
+        };
+
+        SoftBypass();
+
+        // allocate the buffers for given configuration (all in samples), the delay lines are sized for
+        // maxLatency (defaulting to latency), should not be invoked from the audio thread
+
+        void prepare( int amountOfChannels, int maxBufferSize, int fadeLength, int latency, int maxLatency = 0 );
+
+        // update the latency the dry signal is delayed by (e.g. when it changes during playback), capped to the
+        // maxLatency given to prepare(). This does not allocate (the delays read position moves) and is safe
+        // to invoke from the audio thread
+
+        inline void setLatency( int latency )
+        {
+            _latency = std::max( 0, std::min( latency, _maxLatency ));
+        }
+
+        void setResumeMode( Resume mode ) { _resumeMode = mode; }
+
+        // set the requested bypass state, returns true when resuming from bypass requires the
+        // processing state to be reset prior to processing the current block
+
+        bool setBypass( bool bypass );
+
+        // jump to given bypass state without crossfading (e.g. when the processing is (re)activated)
+
+        void reset( bool bypass );
+
+        // whether the processing can be skipped for the current block
+
+        inline bool isBypassed() const
+        {
+            return _position == 0 && _bypass && _resumeMode == Resume::RESET;
+        }
+
+        // invoke prior to processing, retains the (latency compensated) dry signal for mix()
+        // note this is required as the host can provide the same buffers for in- and output
+        // bufferSize should not exceed the maxBufferSize given to prepare(), larger blocks must be split into chunks
+
+        template <typename SampleType>
+        void storeInput( SampleType** inBuffer, int numChannels, int bufferSize )
+        {
+            _isMixing = ( _bypass || _position < _fadeLength ) && bufferSize <= _maxBufferSize;
+
+            // without delay lines, the dry signal is only required while crossfading (when present, these are
+            // written continuously so the latency can change without the dry signal losing its history)
+
+            if ( !_isMixing && _maxLatency == 0 ) {
+                return;
+            }
+            numChannels = std::min( numChannels, _amountOfChannels );
+
+            for ( int c = 0; c < numChannels; ++c ) {
+                SampleType* input = inBuffer[ c ];
+                double* dry       = _dry[ c ].data();
+
+                if ( _maxLatency == 0 ) {
+                    std::copy( input, input + bufferSize, dry );
+                } else {
+                    delay( input, dry, c, bufferSize, _isMixing );
+                }
+            }
+            _delayIndex = ( _delayIndex + bufferSize ) % ( _maxLatency + 1 );
+        }
+
+        // invoke after processing, crossfades the output with the dry signal retained in storeInput()
+
+        template <typename SampleType>
+        void mix( SampleType** outBuffer, int numChannels, int bufferSize )
+        {
+            if ( !_isMixing ) {
+                return;
+            }
+            numChannels = std::min( numChannels, _amountOfChannels );
+
+            int target = _bypass ? 0 : _fadeLength;
+            int position = _position;
+
+            for ( int c = 0; c < numChannels; ++c ) {
+                SampleType* output = outBuffer[ c ];
+                const double* dry  = _dry[ c ].data();
+                position = _position;
+
+                for ( int i = 0; i < bufferSize; ++i ) {
+                    double gain = ( double ) position / _fadeLength;
+                    output[ i ] = ( SampleType ) ( dry[ i ] + ( output[ i ] - dry[ i ] ) * gain );
+
+                    if ( position != target ) {
+                        position += ( target > position ) ? 1 : -1;
+                    }
+                }
+            }
+            _position = position;
+        }
+
+        // invoke instead of processing while fully bypassed, writes the (latency compensated) input into the output
+
+        template <typename SampleType>
+        void bypass( SampleType** inBuffer, SampleType** outBuffer, int numChannels, int bufferSize )
+        {
+            numChannels = std::min( numChannels, _amountOfChannels );
+
+            for ( int c = 0; c < numChannels; ++c ) {
+                if ( _maxLatency > 0 ) {
+                    // the delay line is processed in place (each sample is read before it is overwritten)
+                    if ( inBuffer[ c ] != outBuffer[ c ] ) {
+                        memcpy( outBuffer[ c ], inBuffer[ c ], bufferSize * sizeof( SampleType ));
+                    }
+                    delay( outBuffer[ c ], outBuffer[ c ], c, bufferSize, true );
+                } else if ( inBuffer[ c ] != outBuffer[ c ] ) {
+                    memcpy( outBuffer[ c ], inBuffer[ c ], bufferSize * sizeof( SampleType ));
+                }
+            }
+            if ( _maxLatency > 0 ) {
+                _delayIndex = ( _delayIndex + bufferSize ) % ( _maxLatency + 1 );
+            }
+        }
+
+        // whether the output equals the input (e.g. to pass the silence flags through)
+
+        bool isTransparent() const { return isBypassed() && _latency == 0; }
+
+    private:
+        int _amountOfChannels;
+        int _maxBufferSize;
+        int _fadeLength;
+        int _latency;
+        int _maxLatency; // the delay lines hold one sample more (see delay())
+        Resume _resumeMode;
+
+        bool _bypass;
+        bool _isMixing;  // whether the current block is crossfaded
+        int _position;   // within the crossfade, 0 being fully bypassed and _fadeLength fully processed
+        int _delayIndex; // write position within the delay lines
+
+        std::vector<std::vector<double>> _dry;        // for each channel (holding a block)
+        std::vector<std::vector<double>> _delayLines; // for each channel (holding _maxLatency + 1 samples)
+
+        // delays given input by the latency, writing it into output
+        // (when store is false, the input is only written into the delay line)
+        // each sample is written before reading the delayed one, which for a latency of 0 is the sample itself
+
+        template <typename InputType, typename OutputType>
+        void delay( const InputType* input, OutputType* output, int channel, int bufferSize, bool store )
+        {
+            double* line = _delayLines[ channel ].data();
+            int size     = _maxLatency + 1;
+            int index    = _delayIndex;
+            int read     = index - _latency;
+
+            if ( read < 0 ) {
+                read += size;
+            }
+
+            for ( int i = 0; i < bufferSize; ++i ) {
+                line[ index ] = input[ i ];
+
+                if ( store ) {
+                    output[ i ] = ( OutputType ) line[ read ];
+                }
+                if ( ++index == size ) {
+                    index = 0;
+                }
+                if ( ++read == size ) {
+                    read = 0;
+                }
+            }
+        }
+};
+
+}
+
+#endif
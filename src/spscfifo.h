@@ -0,0 +1,102 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __SPSCFIFO_H_INCLUDED__
+#define __SPSCFIFO_H_INCLUDED__
+
+#include <atomic>
+#include <cstdint>
+
+namespace Igorski {
+
+/**
+ * A wait-free, fixed capacity first-in-first-out queue for exactly one
+ * producing and one consuming thread (e.g. the audio thread writing values
+ * that are read by the UI thread). Neither push() nor pop() allocate or lock,
+ * when the queue is full push() returns false and the value is discarded. For
+ * display data, the consumer can discard() the values it no longer needs (e.g.
+ * those queued while it wasn't reading) so it resumes with the newest values.
+ *
+ * SIZE must be a power of two.
+ */
+template <typename T, uint32_t SIZE>
+class SPSCFifo {
+
+    static_assert(( SIZE & ( SIZE - 1 )) == 0, "SPSCFifo SIZE must be a power of two" );
+
+    public:
+        // invoked by the producing thread only
+
+        bool push( const T& item )
+        {
+            uint32_t write = _writeIndex.load( std::memory_order_relaxed );
+
+            if ( write - _readIndex.load( std::memory_order_acquire ) == SIZE ) {
+                return false; // full
+            }
+            _items[ write & MASK ] = item;
+            _writeIndex.store( write + 1, std::memory_order_release );
+
+            return true;
+        }
+
+        // invoked by the consuming thread only
+
+        bool pop( T& item )
+        {
+            uint32_t read = _readIndex.load( std::memory_order_relaxed );
+
+            if ( read == _writeIndex.load( std::memory_order_acquire )) {
+                return false; // empty
+            }
+            item = _items[ read & MASK ];
+            _readIndex.store( read + 1, std::memory_order_release );
+
+            return true;
+        }
+
+        // invoked by the consuming thread only, drops all queued items
+
+        void discard()
+        {
+            _readIndex.store( _writeIndex.load( std::memory_order_acquire ), std::memory_order_release );
+        }
+
+        bool isEmpty() const
+        {
+            return _readIndex.load( std::memory_order_acquire ) == _writeIndex.load( std::memory_order_acquire );
+        }
+
+    private:
+        static const uint32_t MASK = SIZE - 1;
+
+        // indices live on separate cache lines to prevent false sharing between both threads
+
+        alignas( 64 ) std::atomic<uint32_t> _writeIndex { 0 };
+        alignas( 64 ) std::atomic<uint32_t> _readIndex { 0 };
+
+        T _items[ SIZE ];
+};
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "trace.h"
+
+#if TRACE_ZONES
+
+#include <stdio.h>
+
+namespace Igorski {
+
+Trace::ThreadBuffer Trace::_buffers[ Trace::MAX_THREADS ];
+std::atomic<bool> Trace::_enabled { false };
+std::atomic<uint32_t> Trace::_generation { 0 };
+std::atomic<uint32_t> Trace::_dropped { 0 };
+int64_t Trace::_startTime = 0;
+
+namespace {
+    // the buffer claimed by the current thread, valid for the recording generation it was claimed in
+
+    thread_local int threadBufferIndex     = -1;
+    thread_local uint32_t threadGeneration = 0;
+}
+
+/* public methods */
+
+bool Trace::start()
+{
+    if ( isEnabled()) {
+        return true;
+    }
+
+    for ( int i = 0; i < MAX_THREADS; ++i ) {
+        ThreadBuffer& buffer = _buffers[ i ];
+        if ( buffer.events == nullptr ) {
+            buffer.events = new Event[ EVENTS_PER_THREAD ];
+        }
+        buffer.count.store( 0, std::memory_order_relaxed );
+        buffer.claimed.store( false, std::memory_order_relaxed );
+    }
+    _dropped.store( 0, std::memory_order_relaxed );
+    _startTime = now();
+
+    // invalidates the buffers claimed by the threads during a previous recording
+
+    _generation.fetch_add( 1, std::memory_order_relaxed );
+    _enabled.store( true, std::memory_order_release );
+
+    return true;
+}
+
+void Trace::stop()
+{
+    _enabled.store( false, std::memory_order_release );
+}
+
+bool Trace::exportChromeTrace( const char* filename )
+{
+    FILE* file = fopen( filename, "w" );
+
+    if ( file == nullptr ) {
+        return false;
+    }
+    fprintf( file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" );
+
+    bool first = true;
+    for ( int i = 0; i < MAX_THREADS; ++i ) {
+        ThreadBuffer& buffer = _buffers[ i ];
+        if ( buffer.events == nullptr ) {
+            continue;
+        }
+        uint32_t count = buffer.count.load( std::memory_order_acquire );
+
+        // complete events ("X"), timestamps and durations are in microseconds
+
+        for ( uint32_t j = 0; j < count; ++j ) {
+            const Event& event = buffer.events[ j ];
+            fprintf( file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",\n", event.name, i,
+                ( event.begin - _startTime ) / 1000.0, ( event.end - event.begin ) / 1000.0
+            );
+            first = false;
+        }
+    }
+    fprintf( file, "\n],\"otherData\":{\"droppedZones\":%u}}\n", getDroppedZoneCount());
+    fclose( file );
+
+    return true;
+}
+
+void Trace::release()
+{
+    stop();
+
+    for ( int i = 0; i < MAX_THREADS; ++i ) {
+        delete[] _buffers[ i ].events;
+        _buffers[ i ].events = nullptr;
+        _buffers[ i ].count.store( 0, std::memory_order_relaxed );
+    }
+}
+
+uint32_t Trace::getDroppedZoneCount()
+{
+    return _dropped.load( std::memory_order_relaxed );
+}
+
+void Trace::record( const char* name, int64_t begin, int64_t end )
+{
+    ThreadBuffer* buffer = claimBuffer();
+
+    if ( buffer == nullptr ) {
+        _dropped.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+
+    // only the owning thread writes into the buffer, publishing the event by incrementing the count
+
+    uint32_t count = buffer->count.load( std::memory_order_relaxed );
+    if ( count >= ( uint32_t ) EVENTS_PER_THREAD ) {
+        _dropped.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+    buffer->events[ count ] = { name, begin, end };
+    buffer->count.store( count + 1, std::memory_order_release );
+}
+
+/* private methods */
+
+Trace::ThreadBuffer* Trace::claimBuffer()
+{
+    uint32_t generation = _generation.load( std::memory_order_relaxed );
+
+    if ( threadBufferIndex >= 0 && threadGeneration == generation ) {
+        return &_buffers[ threadBufferIndex ];
+    }
+
+    for ( int i = 0; i < MAX_THREADS; ++i ) {
+        if ( !_buffers[ i ].claimed.exchange( true, std::memory_order_acq_rel )) {
+            threadBufferIndex = i;
+            threadGeneration  = generation;
+            return &_buffers[ i ];
+        }
+    }
+    return nullptr;
+}
+
+}
+
+#endif
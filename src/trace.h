@@ -0,0 +1,153 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __TRACE_H_INCLUDED__
+#define __TRACE_H_INCLUDED__
+
+/**
+ * Trace zones record the duration of scoped blocks of code, for instance:
+ *
+ *     void PluginProcess::processBlock( ... )
+ *     {
+ *         TRACE_ZONE( "PluginProcess::processBlock" );
+ *         ...
+ *     }
+ *
+ * The recorded zones of all threads are exported as a Chrome trace (JSON) which can be
+ * opened in a timeline viewer such as Perfetto (ui.perfetto.dev) or chrome://tracing.
+ *
+ * Zones are only compiled in when TRACE_ZONES is defined (see -DSMTG_ENABLE_TRACE_ZONES=ON in
+ * CMakeLists.txt), otherwise the macro expands to nothing. When compiled in, the plugin records
+ * zones while loaded when the TRACE_OUTPUT environment variable provides the path to export the
+ * trace to upon unloading (see vstentry.cpp), e.g. during a run of the benchmark host.
+ *
+ * Each thread writes into its own preallocated buffer (no allocation, no locks), zone names
+ * must be string literals (only their pointer is stored). Once a threads buffer is full,
+ * further zones are dropped (and counted).
+ */
+#if TRACE_ZONES
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Igorski {
+
+class Trace {
+
+    public:
+        static constexpr int MAX_THREADS       = 8;
+        static constexpr int EVENTS_PER_THREAD = 1 << 18;
+
+        // allocate the buffers and start recording, should not be invoked from the audio thread
+
+        static bool start();
+
+        // stop recording, recorded zones remain available for export
+
+        static void stop();
+
+        // write all recorded zones as Chrome trace JSON into given file, should only be invoked
+        // after recording has stopped and no thread is inside a zone
+
+        static bool exportChromeTrace( const char* filename );
+
+        // free the buffers (e.g. when unloading the module), no thread should be recording
+
+        static void release();
+
+        static inline bool isEnabled()
+        {
+            return _enabled.load( std::memory_order_acquire );
+        }
+
+        static inline int64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()
+            ).count();
+        }
+
+        static void record( const char* name, int64_t begin, int64_t end );
+
+        // the amount of zones that could not be recorded as a threads buffer was full (or all buffers were claimed)
+
+        static uint32_t getDroppedZoneCount();
+
+    private:
+        struct Event {
+            const char* name;
+            int64_t begin; // in nanoseconds
+            int64_t end;
+        };
+
+        struct ThreadBuffer {
+            Event* events;
+            std::atomic<uint32_t> count;
+            std::atomic<bool> claimed;
+        };
+
+        static ThreadBuffer _buffers[ MAX_THREADS ];
+        static std::atomic<bool> _enabled;
+        static std::atomic<uint32_t> _generation;
+        static std::atomic<uint32_t> _dropped;
+        static int64_t _startTime;
+
+        static ThreadBuffer* claimBuffer();
+};
+
+/**
+ * records the lifetime of its scope as a zone (use the TRACE_ZONE macro)
+ */
+class TraceZone {
+
+    public:
+        explicit TraceZone( const char* name ) : _name( name ), _begin( Trace::isEnabled() ? Trace::now() : 0 ) {}
+
+        ~TraceZone()
+        {
+            if ( _begin != 0 && Trace::isEnabled()) {
+                Trace::record( _name, _begin, Trace::now());
+            }
+        }
+
+        TraceZone( const TraceZone& ) = delete;
+        TraceZone& operator=( const TraceZone& ) = delete;
+
+    private:
+        const char* _name;
+        int64_t _begin;
+};
+
+}
+
+#define TRACE_CONCAT_IMPL( a, b ) a##b
+#define TRACE_CONCAT( a, b ) TRACE_CONCAT_IMPL( a, b )
+#define TRACE_ZONE( name ) Igorski::TraceZone TRACE_CONCAT( traceZone, __LINE__ )( name )
+
+#else
+
+#define TRACE_ZONE( name )
+
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "analyser.h"
+#include <algorithm>
+#include <math.h>
+
+namespace Igorski {
+
+static const float MIN_FREQUENCY = 20.f;
+static const float MAX_FREQUENCY = 22000.f;
+static const float MIN_DB        = -90.f;
+static const float FALL_OFF      = .85f; // decay of the displayed spectrum per update
+
+Analyser::Analyser( int amountOfBins )
+: _fft( FFT_SIZE )
+, _samples( FFT_SIZE )
+, _window( FFT_SIZE )
+, _windowed( FFT_SIZE )
+, _magnitudes( FFT_SIZE / 2 + 1 )
+, _bins( std::max( 1, amountOfBins ), 0.f )
+, _waveform( SCOPE_SIZE, 0.f )
+, _windowGain( 0.f )
+, _sampleRate( 0.f )
+, _binStart( _bins.size() + 1 )
+{
+    const float TWO_PI = 6.283185307179586f;
+
+    for ( int i = 0; i < FFT_SIZE; ++i ) {
+        _window[ i ] = .5f - .5f * cosf( TWO_PI * i / ( FFT_SIZE - 1 ));
+        _windowGain += _window[ i ];
+    }
+}
+
+bool Analyser::update( OutputAnalysisRing& ring )
+{
+    if ( !ring.readLatest( _samples.data(), FFT_SIZE )) {
+        return false;
+    }
+
+    if ( ring.getSampleRate() != _sampleRate ) {
+        calculateBinRanges( ring.getSampleRate());
+    }
+
+    // oscilloscope: find a rising zero crossing so the waveform doesn't drift between updates
+
+    int start = FFT_SIZE - SCOPE_SIZE;
+    for ( int i = FFT_SIZE - SCOPE_SIZE - 1; i > FFT_SIZE - SCOPE_SIZE * 2; --i ) {
+        if ( _samples[ i - 1 ] < 0.f && _samples[ i ] >= 0.f ) {
+            start = i;
+            break;
+        }
+    }
+    std::copy( _samples.begin() + start, _samples.begin() + start + SCOPE_SIZE, _waveform.begin());
+
+    // spectrum
+
+    for ( int i = 0; i < FFT_SIZE; ++i ) {
+        _windowed[ i ] = _samples[ i ] * _window[ i ];
+    }
+    _fft.magnitudes( _windowed.data(), _magnitudes.data());
+
+    float scale = 2.f / _windowGain; // magnitudes to amplitude (0 dBFS sine equals 1)
+
+    for ( size_t b = 0; b < _bins.size(); ++b ) {
+        float magnitude = 0.f;
+        for ( int i = _binStart[ b ]; i < std::max( _binStart[ b + 1 ], _binStart[ b ] + 1 ); ++i ) {
+            magnitude = std::max( magnitude, _magnitudes[ i ] );
+        }
+        float db    = 20.f * log10f( std::max( 1e-9f, magnitude * scale ));
+        float value = std::min( 1.f, std::max( 0.f, 1.f - db / MIN_DB ));
+
+        _bins[ b ] = std::max( value, _bins[ b ] * FALL_OFF );
+    }
+    return true;
+}
+
+void Analyser::calculateBinRanges( float sampleRate )
+{
+    _sampleRate = sampleRate;
+
+    float maxFrequency  = std::min( MAX_FREQUENCY, sampleRate / 2.f );
+    float binsPerHz     = FFT_SIZE / sampleRate;
+    int maxBin          = FFT_SIZE / 2;
+    int amountOfBins    = ( int ) _bins.size();
+
+    for ( int b = 0; b <= amountOfBins; ++b ) {
+        float frequency = MIN_FREQUENCY * powf( maxFrequency / MIN_FREQUENCY, ( float ) b / amountOfBins );
+        _binStart[ b ]  = std::min( maxBin, ( int ) roundf( frequency * binsPerHz ));
+    }
+}
+
+}
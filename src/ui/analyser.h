@@ -0,0 +1,79 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __ANALYSER_HEADER__
+#define __ANALYSER_HEADER__
+
+#include "../analysisring.h"
+#include "../fft.h"
+#include <vector>
+
+namespace Igorski {
+
+/**
+ * Analyser runs on the UI thread and turns the most recent output of the
+ * processor (see AnalysisRing) into a log-frequency spectrum and a
+ * triggered oscilloscope waveform, ready for display.
+ */
+class Analyser {
+
+    public:
+        static const int FFT_SIZE   = 2048;
+        static const int SCOPE_SIZE = 512;
+
+        Analyser( int amountOfBins );
+
+        // read the latest window from given ring, returns false when no new data was available
+
+        bool update( OutputAnalysisRing& ring );
+
+        // spectrum, log spaced from MIN_FREQUENCY to the Nyquist frequency (or MAX_FREQUENCY), with
+        // values on a 0 - 1 range decibel scale
+
+        const float* getSpectrum() const { return _bins.data(); }
+        int getBinCount() const { return ( int ) _bins.size(); }
+
+        // waveform, aligned to a rising zero crossing
+
+        const float* getWaveform() const { return _waveform.data(); }
+        int getWaveformSize() const { return SCOPE_SIZE; }
+
+    private:
+        FFT _fft;
+
+        std::vector<float> _samples;
+        std::vector<float> _window;     // Hann
+        std::vector<float> _windowed;
+        std::vector<float> _magnitudes;
+        std::vector<float> _bins;
+        std::vector<float> _waveform;
+
+        float _windowGain;
+        float _sampleRate;
+        std::vector<int> _binStart; // first FFT bin for each display bin (cached for _sampleRate)
+
+        void calculateBinRanges( float sampleRate );
+};
+
+}
+
+#endif
@@ -23,7 +23,9 @@
 #include "../global.h"
 #include "controller.h"
 #include "uimessagecontroller.h"
+#include "modelparameter.h"
 #include "../paramids.h"
+#include "../presetbank.h"
 
 #include "pluginterfaces/base/ibstream.h"
 #include "pluginterfaces/base/ustring.h"
@@ -32,8 +34,11 @@
 #include "base/source/fstring.h"
 #include "base/source/fstreamer.h"
 
+#include "vstgui/lib/cframe.h"
 #include "vstgui/uidescription/delegationcontroller.h"
+#include "vstgui/uidescription/uiattributes.h"
 
+#include <algorithm>
 #include <stdio.h>
 #include <math.h>
 
@@ -81,45 +86,37 @@ tresult PLUGIN_API PluginController::initialize( FUnknown* context )
         STR16( "Bypass" ), nullptr, 1, 0, ParameterInfo::kCanAutomate | ParameterInfo::kIsBypass, kBypassId
     );
 
-// --- AUTO-GENERATED START
+    // factory presets (when a preset bank was found, see vstentry.cpp)
 
-    RangeParameter* bitDepthParam = new RangeParameter(
-        USTRING( "Resolution" ), kBitDepthId, USTRING( "%" ),
-        0.f, 1.f, 1.f,
-        0, ParameterInfo::kCanAutomate, unitId
-    );
-    parameters.addParameter( bitDepthParam );
-
-    RangeParameter* bitCrushLfoParam = new RangeParameter(
-        USTRING( "Bit crush LFO" ), kBitCrushLfoId, USTRING( "Hz" ),
-        0.f, 10.f, 0.f,
-        0, ParameterInfo::kCanAutomate, unitId
-    );
-    parameters.addParameter( bitCrushLfoParam );
+    Igorski::PresetBank* bank = Igorski::PresetBank::getInstance();
+    if ( bank->getPresetCount() > 0 )
+    {
+        StringListParameter* presetParam = new StringListParameter(
+            STR16( "Preset" ), kPresetId, nullptr,
+            ParameterInfo::kIsProgramChange | ParameterInfo::kIsList
+        );
+        for ( int i = 0, l = bank->getPresetCount(); i < l; ++i )
+        {
+            String128 presetName;
+            Steinberg::UString( presetName, 128 ).fromAscii( bank->getPresetName( i ));
+            presetParam->appendString( presetName );
+        }
+        parameters.addParameter( presetParam );
+    }
 
-    RangeParameter* bitCrushLfoDepthParam = new RangeParameter(
-        USTRING( "Bit crush LFO depth" ), kBitCrushLfoDepthId, USTRING( "%" ),
-        0.f, 1.f, 0.f,
-        0, ParameterInfo::kCanAutomate, unitId
-    );
-    parameters.addParameter( bitCrushLfoDepthParam );
+    // read-only parameters written by the processor (for host metering)
 
-    RangeParameter* wetMixParam = new RangeParameter(
-        USTRING( "Wet mix" ), kWetMixId, USTRING( "%" ),
-        0.f, 1.f, 1.f,
-        0, ParameterInfo::kCanAutomate, unitId
+    parameters.addParameter(
+        STR16( "Gain reduction" ), STR16( "dB" ), 0, 0, ParameterInfo::kIsReadOnly, kOutputGainReductionId
     );
-    parameters.addParameter( wetMixParam );
-
-    RangeParameter* dryMixParam = new RangeParameter(
-        USTRING( "Dry mix" ), kDryMixId, USTRING( "%" ),
-        0.f, 1.f, 0.f,
-        0, ParameterInfo::kCanAutomate, unitId
+    parameters.addParameter(
+        STR16( "Latency" ), STR16( "samples" ), 0, 0, ParameterInfo::kIsReadOnly | ParameterInfo::kIsHidden, kLatencyId
     );
-    parameters.addParameter( dryMixParam );
 
+    // the model parameters (see model.h)
 
-// --- AUTO-GENERATED END
+    for ( const Igorski::ParameterDescriptor& descriptor : Igorski::PARAMETERS )
+        parameters.addParameter( new Igorski::ModelParameter( descriptor, unitId ));
 
     // initialization
 
@@ -144,40 +141,19 @@ tresult PLUGIN_API PluginController::setComponentState( IBStream* state )
 
     IBStreamer streamer( state, kLittleEndian );
 
-    int32 savedBypass = 0;
-    if ( streamer.readInt32( savedBypass ) == false )
-        return kResultFalse;
-    setParamNormalized( kBypassId, savedBypass ? 1 : 0 );
-
-// --- AUTO-GENERATED SETCOMPONENTSTATE START
+    // values not present in the stream retain their current value
 
-    float savedBitDepth = 1.f;
-    if ( streamer.readFloat( savedBitDepth ) == false )
-        return kResultFalse;
-    setParamNormalized( kBitDepthId, savedBitDepth );
+    Igorski::PresetRecord record;
+    record.bypass = getParamNormalized( kBypassId ) > 0.5 ? 1 : 0;
 
-    float savedBitCrushLfo = 0.f;
-    if ( streamer.readFloat( savedBitCrushLfo ) == false )
-        return kResultFalse;
-    setParamNormalized( kBitCrushLfoId, savedBitCrushLfo );
+    float* values = Igorski::getModelValues( record.model );
+    for ( int32 i = 0; i < Igorski::MODEL_PARAMETER_COUNT; ++i )
+        values[ i ] = ( float ) getParamNormalized( Igorski::FIRST_MODEL_PARAMETER_ID + i );
 
-    float savedBitCrushLfoDepth = 0.f;
-    if ( streamer.readFloat( savedBitCrushLfoDepth ) == false )
+    if ( !Igorski::PresetBank::readState( streamer, record ))
         return kResultFalse;
-    setParamNormalized( kBitCrushLfoDepthId, savedBitCrushLfoDepth );
 
-    float savedWetMix = 1.f;
-    if ( streamer.readFloat( savedWetMix ) == false )
-        return kResultFalse;
-    setParamNormalized( kWetMixId, savedWetMix );
-
-    float savedDryMix = 0.f;
-    if ( streamer.readFloat( savedDryMix ) == false )
-        return kResultFalse;
-    setParamNormalized( kDryMixId, savedDryMix );
-
-
-// --- AUTO-GENERATED SETCOMPONENTSTATE END
+    applyRecord( record );
 
     return kResultOk;
 }
@@ -208,6 +184,232 @@ IController* PluginController::createSubController( UTF8StringPtr name,
     return nullptr;
 }
 
+//------------------------------------------------------------------------
+CView* PluginController::createCustomView( UTF8StringPtr name, const UIAttributes& attributes,
+                                           const IUIDescription* /*description*/, VST3Editor* /*editor*/ )
+{
+    UTF8StringView viewName( name );
+
+    CPoint origin;
+    CPoint size;
+    attributes.getPointAttribute( "origin", origin );
+    attributes.getPointAttribute( "size",   size );
+    CRect rect( origin, size );
+
+    if ( viewName == "InputMeter" ) {
+        inputMeter = new Igorski::MeterView( rect, Igorski::MeterFrame::MAX_CHANNELS );
+        return inputMeter;
+    }
+    if ( viewName == "OutputMeter" ) {
+        outputMeter = new Igorski::MeterView( rect, Igorski::MeterFrame::MAX_CHANNELS );
+        return outputMeter;
+    }
+    if ( viewName == "GainReductionMeter" ) {
+        gainReductionMeter = new Igorski::MeterView( rect, 1, true );
+        return gainReductionMeter;
+    }
+    if ( viewName == "Spectrum" ) {
+        spectrumView = new Igorski::SpectrumView( rect );
+        return spectrumView;
+    }
+    if ( viewName == "Oscilloscope" ) {
+        oscilloscopeView = new Igorski::OscilloscopeView( rect );
+        return oscilloscopeView;
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------
+void PluginController::didOpen( VST3Editor* editor )
+{
+    activeEditor = editor;
+
+    // the controls have been created with the current parameter values
+
+    for ( ParamID id : dirtyParameters )
+        isParameterDirty[ id - Igorski::FIRST_MODEL_PARAMETER_ID ] = false;
+
+    dirtyParameters.clear();
+    dirtyParameters.reserve( Igorski::MODEL_PARAMETER_COUNT );
+
+    for ( int32 i = 0; i < Igorski::MODEL_PARAMETER_COUNT; ++i ) {
+        if ( Igorski::ModelParameter* parameter = getModelParameter( Igorski::FIRST_MODEL_PARAMETER_ID + i )) {
+            displayedPosition[ i ] = parameter->getDisplayPosition( parameter->getNormalized());
+            parameter->setRedrawDeferred( true );
+        }
+    }
+
+    // the parameter updates, meters and analysis are only handled while the editor is open
+
+    if ( spectrumView || oscilloscopeView ) {
+        analyser.reset( new Igorski::Analyser( spectrumView ? spectrumView->getBinCount() : 1 ));
+        setAnalysisEnabled( true );
+    }
+    discardMeterFrames();
+
+    displayTimer = makeOwned<CVSTGUITimer>( [ this ]( CVSTGUITimer* ) {
+        onDisplayTimer();
+    }, 1000 / Igorski::Meter::DISPLAY_RATE );
+}
+
+//------------------------------------------------------------------------
+void PluginController::willClose( VST3Editor* /*editor*/ )
+{
+    if ( displayTimer ) {
+        displayTimer->stop();
+        displayTimer = nullptr;
+    }
+    activeEditor = nullptr;
+
+    // notify the dependents of the changes that were awaiting the display timer, from now
+    // on the dependents are notified immediately again (there are no controls to redraw)
+
+    for ( ParamID id : dirtyParameters ) {
+        isParameterDirty[ id - Igorski::FIRST_MODEL_PARAMETER_ID ] = false;
+        getModelParameter( id )->changed();
+    }
+    dirtyParameters.clear();
+
+    for ( int32 i = 0; i < Igorski::MODEL_PARAMETER_COUNT; ++i ) {
+        if ( Igorski::ModelParameter* parameter = getModelParameter( Igorski::FIRST_MODEL_PARAMETER_ID + i ))
+            parameter->setRedrawDeferred( false );
+    }
+
+    setAnalysisEnabled( false );
+
+    inputMeter  = nullptr;
+    outputMeter = nullptr;
+    gainReductionMeter = nullptr;
+    spectrumView       = nullptr;
+    oscilloscopeView   = nullptr;
+
+    analyser.reset();
+}
+
+//------------------------------------------------------------------------
+void PluginController::onDisplayTimer()
+{
+    // nothing to draw while the editor is hidden (though the meter frames are dropped
+    // so the meters show the current levels once the editor becomes visible again)
+
+    CFrame* editorFrame = activeEditor ? activeEditor->getFrame() : nullptr;
+    if ( editorFrame == nullptr || !editorFrame->isVisible()) {
+        discardMeterFrames();
+        return;
+    }
+
+    flushParameterUpdates();
+
+    bool hasQueues = Igorski::DisplayQueueRegistry::getInstance()->access( displayQueuesToken,
+        [ this ]( const Igorski::DisplayQueues& queues ) {
+            updateMeters( *queues.meter );
+            updateAnalysis( *queues.analysis );
+        }
+    );
+
+    // the processor is not sharing its queues with this module, only the gain reduction
+    // can be displayed (as received through its read-only parameter)
+
+    if ( !hasQueues && gainReductionMeter )
+        gainReductionMeter->setGainReduction( 1.f - ( float ) getParamNormalized( kOutputGainReductionId ));
+}
+
+//------------------------------------------------------------------------
+void PluginController::updateMeters( Igorski::Meter::Fifo& meterFifo )
+{
+    // drain all frames published since the last update, combining
+    // them into a single frame holding the highest levels
+
+    Igorski::MeterFrame frame;
+    Igorski::MeterFrame combined;
+    bool hasFrame = false;
+
+    while ( meterFifo.pop( frame )) {
+        if ( !hasFrame ) {
+            combined = frame;
+            hasFrame = true;
+            continue;
+        }
+        for ( int c = 0; c < Igorski::MeterFrame::MAX_CHANNELS; ++c ) {
+            combined.inputPeak[ c ]  = std::max( combined.inputPeak[ c ],  frame.inputPeak[ c ] );
+            combined.inputRms[ c ]   = std::max( combined.inputRms[ c ],   frame.inputRms[ c ] );
+            combined.outputPeak[ c ] = std::max( combined.outputPeak[ c ], frame.outputPeak[ c ] );
+            combined.outputRms[ c ]  = std::max( combined.outputRms[ c ],  frame.outputRms[ c ] );
+        }
+        combined.gainReduction = std::min( combined.gainReduction, frame.gainReduction );
+    }
+
+    if ( !hasFrame )
+        return;
+
+    if ( inputMeter )
+        inputMeter->setLevels( combined.inputPeak, combined.inputRms );
+
+    if ( outputMeter )
+        outputMeter->setLevels( combined.outputPeak, combined.outputRms );
+
+    if ( gainReductionMeter )
+        gainReductionMeter->setGainReduction( combined.gainReduction );
+}
+
+//------------------------------------------------------------------------
+void PluginController::flushParameterUpdates()
+{
+    for ( ParamID id : dirtyParameters )
+    {
+        int32 index = id - Igorski::FIRST_MODEL_PARAMETER_ID;
+        isParameterDirty[ index ] = false;
+
+        Igorski::ModelParameter* parameter = getModelParameter( id );
+        int32 position = parameter->getDisplayPosition( parameter->getNormalized());
+
+        // drop updates that don't move the control by at least a pixel
+
+        if ( position == displayedPosition[ index ] )
+            continue;
+
+        displayedPosition[ index ] = position;
+        parameter->changed();
+    }
+    dirtyParameters.clear();
+}
+
+//------------------------------------------------------------------------
+void PluginController::updateAnalysis( Igorski::OutputAnalysisRing& analysisRing )
+{
+    if ( !analyser || !analyser->update( analysisRing ))
+        return;
+
+    if ( spectrumView )
+        spectrumView->setBins( analyser->getSpectrum(), analyser->getBinCount() );
+
+    if ( oscilloscopeView )
+        oscilloscopeView->setWaveform( analyser->getWaveform(), analyser->getWaveformSize() );
+}
+
+//------------------------------------------------------------------------
+void PluginController::setAnalysisEnabled( bool enabled )
+{
+    Igorski::DisplayQueueRegistry::getInstance()->access( displayQueuesToken,
+        [ enabled ]( const Igorski::DisplayQueues& queues ) {
+            queues.analysis->setEnabled( enabled );
+        }
+    );
+}
+
+//------------------------------------------------------------------------
+void PluginController::discardMeterFrames()
+{
+    // the meter queue fills up while the editor is closed, the frames it holds are stale
+    // once the editor opens (and would show old levels in the peak hold), start from the newest
+
+    Igorski::DisplayQueueRegistry::getInstance()->access( displayQueuesToken,
+        []( const Igorski::DisplayQueues& queues ) {
+            queues.meter->discard();
+        }
+    );
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API PluginController::setState( IBStream* state )
 {
@@ -264,52 +466,121 @@ tresult PluginController::receiveText( const char* text )
     return kResultOk;
 }
 
+//------------------------------------------------------------------------
+tresult PLUGIN_API PluginController::notify( IMessage* message )
+{
+    if ( !message )
+        return kInvalidArgument;
+
+    if ( !strcmp( message->getMessageID(), "DisplayQueues" ))
+    {
+        // the processor shares the token its display queues are registered under (0 when deactivated)
+
+        int64 token = 0;
+        if ( message->getAttributes()->getInt( "token", token ) == kResultOk ) {
+            displayQueuesToken = token;
+
+            // resume writing into the ring when the editor is already open
+            if ( analyser )
+                setAnalysisEnabled( true );
+
+            if ( activeEditor )
+                discardMeterFrames();
+        }
+        return kResultOk;
+    }
+    return EditControllerEx1::notify( message );
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API PluginController::setParamNormalized( ParamID tag, ParamValue value )
 {
-    // called from host to update our parameters state
+    // called from host to update our parameters state (for automated parameters this
+    // happens at the rate of the hosts audio blocks). The value is always updated immediately,
+    // while the editor is open the model parameters are not redrawn immediately, but are
+    // collected in a dirty set flushed on the display timer (see ModelParameter::setNormalized())
+
+    Igorski::ModelParameter* parameter = Igorski::isModelParameter( tag ) ? getModelParameter( tag ) : nullptr;
+    ParamValue previousValue = parameter != nullptr ? parameter->getNormalized() : 0.;
+
     tresult result = EditControllerEx1::setParamNormalized( tag, value );
+
+    if ( parameter != nullptr )
+    {
+        int32 index = tag - Igorski::FIRST_MODEL_PARAMETER_ID;
+
+        if ( result == kResultOk && displayTimer && parameter->getNormalized() != previousValue && !isParameterDirty[ index ] )
+        {
+            isParameterDirty[ index ] = true;
+            dirtyParameters.push_back( tag );
+        }
+        return result;
+    }
+
+    // the processor signals a change of its latency, the host will query it
+    // upon restarting the component (e.g. reactivating the processor)
+
+    if ( tag == kLatencyId && result == kResultOk && componentHandler )
+        componentHandler->restartComponent( kLatencyChanged );
+
+    if ( tag == kPresetId && result == kResultOk )
+    {
+        // recalling a factory preset updates all model parameters (note the processor
+        // receives the same parameter change and applies the preset on its own)
+        Igorski::PresetBank* bank = Igorski::PresetBank::getInstance();
+        int amountOfPresets = bank->getPresetCount();
+
+        const Igorski::PresetRecord* preset = amountOfPresets > 0 ?
+            bank->getPreset(( int ) round( value * ( amountOfPresets - 1 ))) : nullptr;
+
+        if ( preset != nullptr )
+        {
+            applyRecord( *preset );
+
+            if ( componentHandler )
+                componentHandler->restartComponent( kParamValuesChanged );
+        }
+    }
     return result;
 }
 
 //------------------------------------------------------------------------
-tresult PLUGIN_API PluginController::getParamStringByValue( ParamID tag, ParamValue valueNormalized, String128 string )
+void PluginController::applyRecord( const Igorski::PresetRecord& record )
 {
-    char text[32];
-    // these controls are floating point values in 0 - 1 range, we can
-    // simply read the normalized value which is in the same range
-    switch ( tag )
-    {
-// --- AUTO-GENERATED GETPARAM START
+    EditControllerEx1::setParamNormalized( kBypassId, record.bypass ? 1 : 0 );
 
-        case kBitDepthId:
-            sprintf( text, "%.d Bits", ( int ) ( 15 * valueNormalized ) + 1 );
-            Steinberg::UString( string, 128 ).fromAscii( text );
-            return kResultTrue;
-
-        case kBitCrushLfoId:
-            sprintf( text, "%.2f Hz", normalizedParamToPlain( tag, valueNormalized ));
-            Steinberg::UString( string, 128 ).fromAscii( text );
-            return kResultTrue;
+    // records are applied immediately (e.g. not through the dirty set, see setParamNormalized())
 
-        case kBitCrushLfoDepthId:
-            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
-            Steinberg::UString( string, 128 ).fromAscii( text );
-            return kResultTrue;
+    const float* values = Igorski::getModelValues( record.model );
+    for ( int32 i = 0; i < Igorski::MODEL_PARAMETER_COUNT; ++i )
+    {
+        if ( Igorski::ModelParameter* parameter = getModelParameter( Igorski::FIRST_MODEL_PARAMETER_ID + i ))
+        {
+            parameter->setNormalizedDeferred( values[ i ] );
+            parameter->changed();
+            displayedPosition[ i ] = parameter->getDisplayPosition( parameter->getNormalized());
+        }
+    }
+}
 
-        case kWetMixId:
-            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
-            Steinberg::UString( string, 128 ).fromAscii( text );
-            return kResultTrue;
+//------------------------------------------------------------------------
+Igorski::ModelParameter* PluginController::getModelParameter( ParamID id )
+{
+    return static_cast<Igorski::ModelParameter*>( getParameterObject( id ));
+}
 
-        case kDryMixId:
-            sprintf( text, "%.2d %%", ( int ) ( valueNormalized * 100.f ));
+//------------------------------------------------------------------------
+tresult PLUGIN_API PluginController::getParamStringByValue( ParamID tag, ParamValue valueNormalized, String128 string )
+{
+    char text[32];
+    // model parameters are formatted by their descriptor (see ModelParameter::toString())
+    switch ( tag )
+    {
+        case kOutputGainReductionId:
+            sprintf( text, "%.1f dB", 20.f * log10f( std::max( 1e-6f, 1.f - ( float ) valueNormalized )));
             Steinberg::UString( string, 128 ).fromAscii( text );
             return kResultTrue;
 
-
-// --- AUTO-GENERATED GETPARAM END
-
         // everything else
         default:
             return EditControllerEx1::getParamStringByValue( tag, valueNormalized, string );
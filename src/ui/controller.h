@@ -24,7 +24,18 @@
 #define __CONTROLLER_HEADER__
 
 #include "vstgui/plugin-bindings/vst3editor.h"
+#include "vstgui/lib/cvstguitimer.h"
 #include "public.sdk/source/vst/vsteditcontroller.h"
+#include "../meter.h"
+#include "../displayqueues.h"
+#include "../presetbank.h"
+#include "meterview.h"
+#include "modelparameter.h"
+#include "analyser.h"
+#include "spectrumview.h"
+#include "oscilloscopeview.h"
+
+#include <memory>
 
 #include <vector>
 
@@ -66,6 +77,7 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
 
         //---from ComponentBase-----
         tresult receiveText( const char* text ) SMTG_OVERRIDE;
+        tresult PLUGIN_API notify( IMessage* message ) SMTG_OVERRIDE;
 
         //---from IMidiMapping-----------------
         tresult PLUGIN_API getMidiControllerAssignment (int32 busIndex, int16 channel,
@@ -75,6 +87,10 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
         //---from VST3EditorDelegate-----------
         IController* createSubController( UTF8StringPtr name, const IUIDescription* description,
                                           VST3Editor* editor ) SMTG_OVERRIDE;
+        CView* createCustomView( UTF8StringPtr name, const UIAttributes& attributes,
+                                 const IUIDescription* description, VST3Editor* editor ) SMTG_OVERRIDE;
+        void didOpen( VST3Editor* editor ) SMTG_OVERRIDE;
+        void willClose( VST3Editor* editor ) SMTG_OVERRIDE;
 
         DELEGATE_REFCOUNT ( EditController )
         tresult PLUGIN_API queryInterface( const char* iid, void** obj ) SMTG_OVERRIDE;
@@ -91,6 +107,46 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
         UIMessageControllerList uiMessageControllers;
 
         String128 defaultMessageText;
+
+        // metering and analysis, the queues are owned by the processor and are accessed through the
+        // token it registered them under (see __PLUGIN_NAME__::sendDisplayQueues()). When the token
+        // does not resolve (e.g. the processor runs in another process) only the gain reduction is
+        // displayed, using the value of its read-only parameter
+
+        int64 displayQueuesToken = 0;
+
+        Igorski::MeterView* inputMeter  = nullptr;
+        Igorski::MeterView* outputMeter = nullptr;
+        Igorski::MeterView* gainReductionMeter = nullptr;
+
+        // analysis, the ring is only written to while enabled (e.g. while the
+        // editor is open), the analysis runs on the display timer
+
+        std::unique_ptr<Igorski::Analyser> analyser;
+        Igorski::SpectrumView* spectrumView         = nullptr;
+        Igorski::OscilloscopeView* oscilloscopeView = nullptr;
+
+        // model parameter changes are not redrawn immediately but collected and flushed on the
+        // display timer (only when their display position has changed), see setParamNormalized()
+
+        std::vector<ParamID> dirtyParameters;
+        bool isParameterDirty[ Igorski::MODEL_PARAMETER_COUNT ] = {};
+        int32 displayedPosition[ Igorski::MODEL_PARAMETER_COUNT ] = {};
+
+        VST3Editor* activeEditor = nullptr;
+        SharedPointer<CVSTGUITimer> displayTimer;
+
+        void onDisplayTimer();
+        void updateMeters( Igorski::Meter::Fifo& meterFifo );
+        void updateAnalysis( Igorski::OutputAnalysisRing& analysisRing );
+        void setAnalysisEnabled( bool enabled );
+        void discardMeterFrames();
+        void flushParameterUpdates();
+
+        // update all parameters to reflect given state
+        void applyRecord( const Igorski::PresetRecord& record );
+
+        Igorski::ModelParameter* getModelParameter( ParamID id );
 };
 
 //------------------------------------------------------------------------
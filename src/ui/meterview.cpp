@@ -0,0 +1,136 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "meterview.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace VSTGUI;
+
+namespace Igorski {
+
+static const float MIN_DB        = -60.f;
+static const float MAX_GR_DB     = 24.f;
+static const float PEAK_DECAY    = .9f; // decay of the peak line per update
+static const float CHANNEL_SPACE = 2.f;
+
+MeterView::MeterView( const CRect& size, int amountOfChannels, bool inverted )
+: CView( size )
+, _amountOfChannels( std::min( amountOfChannels, MAX_CHANNELS ))
+, _inverted( inverted )
+{
+    for ( int c = 0; c < MAX_CHANNELS; ++c ) {
+        _peak[ c ] = 0.f;
+        _rms[ c ]  = 0.f;
+    }
+}
+
+void MeterView::setLevels( const float* peak, const float* rms )
+{
+    float peakRange[ MAX_CHANNELS ];
+    float rmsRange [ MAX_CHANNELS ];
+
+    for ( int c = 0; c < _amountOfChannels; ++c ) {
+        peakRange[ c ] = toDisplayRange( peak[ c ] );
+        rmsRange [ c ] = toDisplayRange( rms[ c ] );
+    }
+    applyLevels( peakRange, rmsRange );
+}
+
+void MeterView::setGainReduction( float linearGainReduction )
+{
+    float reduction = 0.f;
+
+    if ( linearGainReduction < 1.f ) {
+        float db  = -20.f * log10f( std::max( linearGainReduction, 1e-6f ));
+        reduction = std::min( 1.f, db / MAX_GR_DB );
+    }
+    applyLevels( &reduction, &reduction );
+}
+
+void MeterView::applyLevels( const float* peak, const float* rms )
+{
+    bool changed = false;
+
+    for ( int c = 0; c < _amountOfChannels; ++c ) {
+        float newPeak = std::max( peak[ c ], _peak[ c ] * PEAK_DECAY );
+        float newRms  = rms[ c ];
+
+        // only redraw when the change is visible (e.g. at least a pixel)
+        float pixelSize = 1.f / ( float ) getViewSize().getHeight();
+
+        if ( fabs( newPeak - _peak[ c ] ) >= pixelSize || fabs( newRms - _rms[ c ] ) >= pixelSize ) {
+            changed = true;
+        }
+        _peak[ c ] = newPeak;
+        _rms[ c ]  = newRms;
+    }
+
+    if ( changed ) {
+        invalid();
+    }
+}
+
+void MeterView::draw( CDrawContext* context )
+{
+    const CRect& bounds = getViewSize();
+
+    context->setDrawMode( kAliasing );
+    context->setFillColor( CColor( 0, 0, 0, 160 ));
+    context->drawRect( bounds, kDrawFilled );
+
+    double channelWidth = ( bounds.getWidth() - CHANNEL_SPACE * ( _amountOfChannels - 1 )) / _amountOfChannels;
+    double height       = bounds.getHeight();
+
+    for ( int c = 0; c < _amountOfChannels; ++c ) {
+        double left  = bounds.left + c * ( channelWidth + CHANNEL_SPACE );
+        double right = left + channelWidth;
+
+        double rmsHeight  = height * _rms[ c ];
+        double peakOffset = height * _peak[ c ];
+
+        CRect rmsRect = _inverted ?
+            CRect( left, bounds.top, right, bounds.top + rmsHeight ) :
+            CRect( left, bounds.bottom - rmsHeight, right, bounds.bottom );
+
+        context->setFillColor( _inverted ? CColor( 255, 128, 0, 255 ) : CColor( 39, 155, 255, 255 ));
+        context->drawRect( rmsRect, kDrawFilled );
+
+        double peakY = _inverted ? bounds.top + peakOffset : bounds.bottom - peakOffset;
+
+        context->setFillColor( CColor( 255, 255, 255, 255 ));
+        context->drawRect( CRect( left, peakY - 1, right, peakY ), kDrawFilled );
+    }
+    setDirty( false );
+}
+
+float MeterView::toDisplayRange( float linear )
+{
+    if ( linear <= 0.f ) {
+        return 0.f;
+    }
+    float db = 20.f * log10f( linear );
+    return std::min( 1.f, std::max( 0.f, 1.f - ( db / MIN_DB )));
+}
+
+}
@@ -0,0 +1,67 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __METERVIEW_HEADER__
+#define __METERVIEW_HEADER__
+
+#include "vstgui/lib/cview.h"
+
+namespace Igorski {
+
+/**
+ * MeterView renders vertical level meters for one or more channels,
+ * drawing the RMS level as a solid bar and the peak level as a line.
+ * Levels are linear and displayed on a decibel scale.
+ */
+class MeterView : public VSTGUI::CView
+{
+    public:
+        static constexpr int MAX_CHANNELS = 2;
+
+        MeterView( const VSTGUI::CRect& size, int amountOfChannels, bool inverted = false );
+
+        // update the levels (only invalidates the view when the displayed values have changed)
+
+        void setLevels( const float* peak, const float* rms );
+
+        // update the displayed gain reduction, for use with single channel, inverted meters
+
+        void setGainReduction( float linearGainReduction );
+
+        void draw( VSTGUI::CDrawContext* context ) override;
+
+    private:
+        int _amountOfChannels;
+        bool _inverted; // when true, meter grows down from the top (e.g. gain reduction)
+
+        float _peak[ MAX_CHANNELS ];
+        float _rms [ MAX_CHANNELS ];
+
+        void applyLevels( const float* peak, const float* rms );
+
+        // convert a linear level to a normalized 0 - 1 range on the displayed decibel scale
+        static float toDisplayRange( float linear );
+};
+
+}
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MODELPARAMETER_H_INCLUDED__
+#define __MODELPARAMETER_H_INCLUDED__
+
+#include "../model.h"
+#include "public.sdk/source/vst/vstparameters.h"
+#include "pluginterfaces/base/ustring.h"
+#include <algorithm>
+#include <math.h>
+
+namespace Igorski {
+
+/**
+ * A parameter exposing a model parameter to the host, where conversion
+ * and formatting of its value are provided by its ParameterDescriptor
+ */
+class ModelParameter : public Steinberg::Vst::Parameter
+{
+    public:
+        ModelParameter( const ParameterDescriptor& descriptor, Steinberg::Vst::UnitID unitId )
+        : _descriptor( descriptor )
+        {
+            Steinberg::UString( info.title, USTRINGSIZE( info.title )).fromAscii( descriptor.title );
+            Steinberg::UString( info.units, USTRINGSIZE( info.units )).fromAscii( descriptor.units );
+
+            info.id = descriptor.id;
+            info.stepCount = descriptor.stepCount;
+            info.defaultNormalizedValue = descriptor.defaultValue;
+            info.flags  = Steinberg::Vst::ParameterInfo::kCanAutomate;
+            info.unitId = unitId;
+
+            setNormalized( descriptor.defaultValue );
+        }
+
+        void toString( Steinberg::Vst::ParamValue valueNormalized, Steinberg::Vst::String128 string ) const SMTG_OVERRIDE
+        {
+            char text[ 32 ];
+            _descriptor.format( valueNormalized, _descriptor.toPlain( valueNormalized ), text );
+            Steinberg::UString( string, 128 ).fromAscii( text );
+        }
+
+        Steinberg::Vst::ParamValue toPlain( Steinberg::Vst::ParamValue valueNormalized ) const SMTG_OVERRIDE
+        {
+            return _descriptor.toPlain( valueNormalized );
+        }
+
+        Steinberg::Vst::ParamValue toNormalized( Steinberg::Vst::ParamValue plainValue ) const SMTG_OVERRIDE
+        {
+            return _descriptor.toNormalized( plainValue );
+        }
+
+        // while redraws are deferred (e.g. while the editor is open, see PluginController::flushParameterUpdates())
+        // the value is updated without notifying the dependents (e.g. the editors controls), which are notified on
+        // the display timer instead. Otherwise the dependents are notified immediately
+
+        bool setNormalized( Steinberg::Vst::ParamValue value ) SMTG_OVERRIDE
+        {
+            if ( !_isRedrawDeferred )
+                return Parameter::setNormalized( value );
+
+            return setNormalizedDeferred( value );
+        }
+
+        void setRedrawDeferred( bool deferred )
+        {
+            _isRedrawDeferred = deferred;
+        }
+
+        // store given value without notifying the dependents (e.g. the editors controls), returns
+        // whether the value has changed (see PluginController::flushParameterUpdates())
+
+        bool setNormalizedDeferred( Steinberg::Vst::ParamValue value )
+        {
+            value = std::min( 1., std::max( 0., value ));
+
+            if ( value == valueNormalized )
+                return false;
+
+            valueNormalized = value;
+            return true;
+        }
+
+        // position of given value at the resolution at which it is displayed, changes
+        // that don't alter the position do not need to be redrawn
+
+        Steinberg::int32 getDisplayPosition( Steinberg::Vst::ParamValue valueNormalized ) const
+        {
+            Steinberg::int32 resolution = _descriptor.stepCount > 0 ? _descriptor.stepCount :
+                                          _descriptor.pixels    > 0 ? _descriptor.pixels : DEFAULT_RESOLUTION;
+
+            return ( Steinberg::int32 ) round( valueNormalized * resolution );
+        }
+
+    private:
+        static const Steinberg::int32 DEFAULT_RESOLUTION = 128; // for parameters without generated control
+
+        const ParameterDescriptor& _descriptor;
+        bool _isRedrawDeferred = false;
+};
+
+}
+
+#endif
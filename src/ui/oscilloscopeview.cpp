@@ -0,0 +1,75 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "oscilloscopeview.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include <algorithm>
+
+using namespace VSTGUI;
+
+namespace Igorski {
+
+OscilloscopeView::OscilloscopeView( const CRect& size )
+: CView( size )
+, _points( std::max( 2, ( int ) size.getWidth()), 0.f )
+{
+
+}
+
+void OscilloscopeView::setWaveform( const float* samples, int amountOfSamples )
+{
+    if ( amountOfSamples < 1 ) {
+        return;
+    }
+    float step = ( float ) amountOfSamples / ( float ) _points.size();
+
+    for ( size_t i = 0; i < _points.size(); ++i ) {
+        _points[ i ] = std::min( 1.f, std::max( -1.f, samples[ std::min( amountOfSamples - 1, ( int ) ( i * step )) ] ));
+    }
+    invalid();
+}
+
+void OscilloscopeView::draw( CDrawContext* context )
+{
+    const CRect& bounds = getViewSize();
+
+    context->setDrawMode( kAntiAliasing );
+    context->setFillColor( CColor( 0, 0, 0, 160 ));
+    context->drawRect( bounds, kDrawFilled );
+
+    double centerY = bounds.top + bounds.getHeight() / 2;
+    double scale   = bounds.getHeight() / 2;
+    double step    = bounds.getWidth() / ( _points.size() - 1 );
+
+    context->setFrameColor( CColor( 39, 155, 255, 255 ));
+    context->setLineWidth( 1 );
+
+    CPoint previous( bounds.left, centerY - _points[ 0 ] * scale );
+    for ( size_t i = 1; i < _points.size(); ++i ) {
+        CPoint current( bounds.left + i * step, centerY - _points[ i ] * scale );
+        context->drawLine( previous, current );
+        previous = current;
+    }
+    setDirty( false );
+}
+
+}
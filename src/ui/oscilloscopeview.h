@@ -0,0 +1,52 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __OSCILLOSCOPEVIEW_HEADER__
+#define __OSCILLOSCOPEVIEW_HEADER__
+
+#include "vstgui/lib/cview.h"
+#include <vector>
+
+namespace Igorski {
+
+/**
+ * OscilloscopeView renders a waveform (in the -1 to +1 range)
+ * as a line across the width of the view.
+ */
+class OscilloscopeView : public VSTGUI::CView
+{
+    public:
+        OscilloscopeView( const VSTGUI::CRect& size );
+
+        // update the waveform, the samples are resampled to the view width
+
+        void setWaveform( const float* samples, int amountOfSamples );
+
+        void draw( VSTGUI::CDrawContext* context ) override;
+
+    private:
+        std::vector<float> _points; // one for each horizontal pixel
+};
+
+}
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "spectrumview.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace VSTGUI;
+
+namespace Igorski {
+
+static const float BAR_SPACE = 1.f;
+
+SpectrumView::SpectrumView( const CRect& size )
+: CView( size )
+, _bins( std::max( 1, ( int ) size.getWidth() / BAR_WIDTH ), 0.f )
+{
+
+}
+
+void SpectrumView::setBins( const float* bins, int amountOfBins )
+{
+    bool changed = false;
+    float pixelSize = 1.f / ( float ) getViewSize().getHeight();
+
+    for ( int i = 0, l = std::min( amountOfBins, getBinCount()); i < l; ++i ) {
+        if ( fabs( bins[ i ] - _bins[ i ] ) >= pixelSize ) {
+            changed = true;
+        }
+        _bins[ i ] = bins[ i ];
+    }
+
+    if ( changed ) {
+        invalid();
+    }
+}
+
+void SpectrumView::draw( CDrawContext* context )
+{
+    const CRect& bounds = getViewSize();
+
+    context->setDrawMode( kAliasing );
+    context->setFillColor( CColor( 0, 0, 0, 160 ));
+    context->drawRect( bounds, kDrawFilled );
+
+    double barWidth = bounds.getWidth() / getBinCount();
+    double height   = bounds.getHeight();
+
+    context->setFillColor( CColor( 39, 155, 255, 255 ));
+
+    for ( int i = 0; i < getBinCount(); ++i ) {
+        double left = bounds.left + i * barWidth;
+        context->drawRect( CRect( left, bounds.bottom - height * _bins[ i ], left + barWidth - BAR_SPACE, bounds.bottom ), kDrawFilled );
+    }
+    setDirty( false );
+}
+
+}
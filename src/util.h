@@ -23,51 +23,38 @@
 #ifndef __UTIL_HEADER__
 #define __UTIL_HEADER__
 
-#include <fstream>
 #include <string>
-#include <time.h>
+#include "logger.h"
 
 namespace Igorski {
 namespace Util {
 
     /**
-     * Convenience method to log a message to a file
-     * multiple messages can be written to the same file (are
-     * separated by a new line)
+     * Convenience methods to log a message to the log file opened
+     * using Logger::start(), each message is written on a new line
+     * prefixed by its timestamp.
      *
-     * This should be used for debugging purposes only
+     * These are safe to call from the audio thread and are
+     * no-ops while the Logger hasn't been started
      */
-    void log( const char* message, const char* filename )
+    inline void log( const char* message )
     {
-        std::ofstream out;
-
-        char buff[20];
-        struct tm *sTm;
-
-        time_t now = time( 0 );
-        sTm        = gmtime( &now );
-
-        strftime( buff, sizeof( buff ), "%Y-%m-%d %H:%M:%S", sTm );
-
-        out.open( filename, std::ios_base::app );
-        out << buff << " " << message << "\n";
-
-        out.close();
+        Logger::log( message );
     }
 
-    void log( std::string message, const char* filename )
+    inline void log( const std::string& message )
     {
-        log( message.c_str(), filename );
+        Logger::log( message.c_str());
     }
 
-    void log( float value, const char* filename )
+    inline void log( const char* message, float value )
     {
-        log( std::to_string( value ), filename );
+        Logger::log( message, value );
     }
 
-    void log( int value, const char* filename )
+    inline void log( const char* message, int value )
     {
-        log( std::to_string( value ), filename );
+        Logger::log( message, value );
     }
 
 }
@@ -35,24 +35,24 @@
 
 #include "base/source/fstreamer.h"
 
+#include <math.h>
 #include <stdio.h>
 
 namespace Igorski {
 
-float VST::SAMPLE_RATE = 44100.f; // updated in setupProcessing()
-
 //------------------------------------------------------------------------
 // Plugin Implementation
 //------------------------------------------------------------------------
-__PLUGIN_NAME__::__PLUGIN_NAME__()
+__PLUGIN_NAME__::__PLUGIN_NAME__( bool hasSideChain )
 : pluginProcess( nullptr )
 , currentProcessMode( -1 ) // -1 means not initialized
+, _hasSideChain( hasSideChain )
 {
     // register its editor class (the same as used in vstentry.cpp)
     setControllerClass( VST::PluginControllerUID );
 
-    // should be created on setupProcessing, this however doesn't fire for Audio Unit using auval?
-    pluginProcess = new PluginProcess( 2 );
+    // NOTE: the processors are not allocated until processing is set up (see preparePluginProcess()),
+    // keeping instantiation cheap for hosts scanning or validating the plugin
 }
 
 //------------------------------------------------------------------------
@@ -75,6 +75,9 @@ tresult PLUGIN_API __PLUGIN_NAME__::initialize( FUnknown* context )
     addAudioInput ( STR16( "Stereo In" ),  SpeakerArr::kStereo );
     addAudioOutput( STR16( "Stereo Out" ), SpeakerArr::kStereo );
 
+    // optional sidechain input (not active until enabled by the host/user)
+    updateSideChainBus( SpeakerArr::kStereo );
+
     //---create Event In/Out buses (1 bus with only 1 channel)------
     addEventInput( STR16( "Event In" ), 1 );
 
@@ -84,7 +87,12 @@ tresult PLUGIN_API __PLUGIN_NAME__::initialize( FUnknown* context )
 //------------------------------------------------------------------------
 tresult PLUGIN_API __PLUGIN_NAME__::terminate()
 {
-    // nothing to do here yet...except calling our parent terminate
+    // unregister the display queues in case the host never deactivated the processor
+
+    if ( _displayQueuesToken != 0 ) {
+        DisplayQueueRegistry::getInstance()->remove( _displayQueuesToken );
+        _displayQueuesToken = 0;
+    }
     return AudioEffect::terminate();
 }
 
@@ -96,6 +104,33 @@ tresult PLUGIN_API __PLUGIN_NAME__::setActive (TBool state)
     else
         sendTextMessage( "__PLUGIN_NAME__::setActive (false)" );
 
+    if ( state )
+    {
+        // start from a clean state, skipping any smoothing towards the current model values
+
+        _smoothedModel = _model;
+        _isSmoothing   = false;
+
+        // processing should have been set up by now, though not all hosts do (e.g. auval)
+
+        if ( pluginProcess == nullptr )
+            preparePluginProcess( processSetup );
+
+        syncModel();
+        pluginProcess->reset();
+
+        // the latency can have changed while inactive (e.g. after the host has been notified of its change)
+
+        _reportedLatency  = pluginProcess->getLatencySamples();
+        _signalledLatency = _reportedLatency;
+        _softBypass.setLatency( _reportedLatency );
+
+        _softBypass.reset( _bypass );
+        _lastGainReduction = 1.f;
+    }
+
+    sendDisplayQueues( state );
+
     // call our parent setActive
     return AudioEffect::setActive( state );
 }
@@ -103,6 +138,12 @@ tresult PLUGIN_API __PLUGIN_NAME__::setActive (TBool state)
 //------------------------------------------------------------------------
 tresult PLUGIN_API __PLUGIN_NAME__::process( ProcessData& data )
 {
+    TRACE_ZONE( "Plugin::process" );
+
+    // prevent subnormal values from degrading performance throughout the process cycle
+    // (e.g. the metering, note PluginProcess::process() is guarded on its own)
+    ScopedNoDenormals noDenormals;
+
     // In this example there are 4 steps:
     // 1) Read inputs parameters coming from host (in order to adapt our model values)
     // 2) Read inputs events coming from host (note on/off events)
@@ -127,55 +168,70 @@ tresult PLUGIN_API __PLUGIN_NAME__::process( ProcessData& data )
                     continue;
                 }
 
-                switch ( paramQueue->getParameterId())
-                {
-// --- AUTO-GENERATED PROCESS START
-
+                ParamID id = paramQueue->getParameterId();
 
-                    case kBitDepthId:
-                        fBitDepth = ( float ) value;
-                        break;
+                if ( isModelParameter( id )) {
+                    getModelValues( _model )[ id - FIRST_MODEL_PARAMETER_ID ] = ( float ) value;
+                    continue;
+                }
 
-                    case kBitCrushLfoId:
-                        fBitCrushLfo = ( float ) value;
+                switch ( id )
+                {
+                    case kBypassId:
+                        _bypass = ( value > 0.5f );
                         break;
 
-                    case kBitCrushLfoDepthId:
-                        fBitCrushLfoDepth = ( float ) value;
+                    case kPresetId:
+                        loadPreset( value );
                         break;
+                }
+            }
+        }
+    }
 
-                    case kWetMixId:
-                        fWetMix = ( float ) value;
-                        break;
+    // apply pending preset (this is merely a pointer into the memory mapped preset bank)
 
-                    case kDryMixId:
-                        fDryMix = ( float ) value;
-                        break;
+    const PresetRecord* preset = _pendingPreset.exchange( nullptr );
+    if ( preset != nullptr ) {
+        applyRecord( *preset );
+    }
 
-// --- AUTO-GENERATED PROCESS END
+    // when resuming from a full bypass, the processors start from a clean state (as if just activated)
 
-                    case kBypassId:
-                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
-                            _bypass = ( value > 0.5f );
-                        break;
-                }
-                syncModel();
-            }
-        }
+    if ( _softBypass.setBypass( _bypass ) && pluginProcess != nullptr ) {
+        _smoothedModel = _model;
+        _isSmoothing   = false;
+        syncModel();
+        pluginProcess->reset();
     }
 
+    // when fully bypassed, there is nothing to update until the bypass is released
+
+    bool isBypassed = _softBypass.isBypassed();
+
+    // synchronize the processors with the model changes (once per process cycle)
+
+    if ( !isBypassed )
+        smoothModel( data.numSamples );
+
     // according to docs: processing context (optional, but most welcome)
 
-    if ( data.processContext != nullptr ) {
-        // in case you want to do tempo synchronization with the host
-        /*
-        pluginProcess->setTempo(
-            data.processContext->tempo, data.processContext->timeSigNumerator, data.processContext->timeSigDenominator
-        );
-        */
-        // also run synchronization on properties that are tempo dependant here...
+    if ( data.processContext != nullptr && pluginProcess != nullptr && !isBypassed ) {
+        // synchronize the tempo dependent processors (e.g. the delay) with the host
+        if (( data.processContext->state & ProcessContext::kTempoValid ) != 0 &&
+            ( data.processContext->state & ProcessContext::kTimeSigValid ) != 0 ) {
+            pluginProcess->setTempo(
+                data.processContext->tempo, data.processContext->timeSigNumerator, data.processContext->timeSigDenominator
+            );
+        }
     }
 
+    // the unprocessed signal follows latency changes of the processing (e.g. when the model toggles the bit
+    // crushers anti-aliasing) immediately, as the processed signal does. This does not allocate (see prepareSoftBypass())
+
+    if ( pluginProcess != nullptr )
+        _softBypass.setLatency( pluginProcess->getLatencySamples() );
+
     //---2) Read input events-------------
 //    IEventList* eventList = data.inputEvents;
 
@@ -184,9 +240,9 @@ tresult PLUGIN_API __PLUGIN_NAME__::process( ProcessData& data )
     //---3) Process Audio---------------------
     //-------------------------------------
 
-    if ( data.numInputs == 0 || data.numOutputs == 0 )
+    if ( data.numInputs == 0 || data.numOutputs == 0 || data.numSamples <= 0 )
     {
-        // nothing to do
+        // nothing to do (e.g. parameter flush)
         return kResultOk;
     }
 
@@ -194,42 +250,66 @@ tresult PLUGIN_API __PLUGIN_NAME__::process( ProcessData& data )
     int32 numOutChannels = data.outputs[ 0 ].numChannels;
 
     // --- get audio buffers----------------
-    uint32 sampleFramesSize = getSampleFramesSizeInBytes( processSetup, data.numSamples );
     void** in  = getChannelBuffersPointer( processSetup, data.inputs [ 0 ] );
     void** out = getChannelBuffersPointer( processSetup, data.outputs[ 0 ] );
 
+    if ( in == nullptr || out == nullptr || pluginProcess == nullptr )
+        return kResultOk;
+
+    bool isDoublePrecision = data.symbolicSampleSize == kSample64;
+
+    // the sidechain is read directly from the host buffers (when its bus is active, the host provides its channels)
+
+    int32 numSideChainChannels = 0;
+    void** sideChain = nullptr;
+
+    if ( _hasSideChain && data.numInputs > 1 && data.inputs[ 1 ].numChannels > 0 )
+    {
+        sideChain = getChannelBuffersPointer( processSetup, data.inputs[ 1 ] );
+        numSideChainChannels = sideChain != nullptr ? data.inputs[ 1 ].numChannels : 0;
+    }
+
+    // measure the input levels before processing (as in- and output buffers can be the same)
+
+    if ( isDoublePrecision )
+        _meter.measureInput<double>(( double** ) in, numInChannels, data.numSamples );
+    else
+        _meter.measureInput<float>(( float** ) in, numInChannels, data.numSamples );
+
     // process the incoming sound!
 
     bool isSilentInput  = data.inputs[ 0 ].silenceFlags != 0;
     bool isSilentOutput = false;
 
-    if ( _bypass )
+    int32 numBypassChannels = std::min( numInChannels, numOutChannels );
+
+    if ( isBypassed )
     {
-        // bypass mode, write the input unchanged into the output
-        for ( int32 i = 0, l = std::min( numInChannels, numOutChannels ); i < l; i++ )
-        {
-            if ( in[ i ] != out[ i ] ) {
-                memcpy( out[ i ], in[ i ], sampleFramesSize );
-            }
-            isSilentOutput = isSilentInput;
-        }
+        // bypass mode, write the input (delayed by the processing latency) into the output
+        // (no copy is made when the host provides the same buffers for in- and output)
+
+        if ( isDoublePrecision )
+            _softBypass.bypass<double>(( double** ) in, ( double** ) out, numBypassChannels, data.numSamples );
+        else
+            _softBypass.bypass<float>(( float** ) in, ( float** ) out, numBypassChannels, data.numSamples );
+
+        isSilentOutput = isSilentInput && _softBypass.isTransparent();
     }
     else {
-        // apply processing
-        bool isDoublePrecision = data.symbolicSampleSize == kSample64;
+        // apply processing, crossfading with the input while the bypass is toggled
 
         if ( isDoublePrecision ) {
             // 64-bit samples, e.g. Reaper64
-            pluginProcess->process<double>(
+            processSoftBypassed<double>(
                 ( double** ) in, ( double** ) out, numInChannels, numOutChannels,
-                data.numSamples, sampleFramesSize
+                numBypassChannels, data.numSamples, ( double** ) sideChain, numSideChainChannels
             );
         }
         else {
             // 32-bit samples, e.g. Ableton Live, Bitwig Studio... (oddly enough also when 64-bit?)
-            pluginProcess->process<float>(
+            processSoftBypassed<float>(
                 ( float** ) in, ( float** ) out, numInChannels, numOutChannels,
-                data.numSamples, sampleFramesSize
+                numBypassChannels, data.numSamples, ( float** ) sideChain, numSideChainChannels
             );
         }
         // update isSilentOutput accordingly
@@ -239,11 +319,104 @@ tresult PLUGIN_API __PLUGIN_NAME__::process( ProcessData& data )
 
     data.outputs[ 0 ].silenceFlags = isSilentOutput ? (( uint64 ) 1 << numOutChannels ) - 1 : 0;
 
-    // float outputGain = pluginProcess->limiter->getLinearGR();
+    // metering
+
+    if ( isDoublePrecision )
+        _meter.measureOutput<double>(( double** ) out, numOutChannels, data.numSamples );
+    else
+        _meter.measureOutput<float>(( float** ) out, numOutChannels, data.numSamples );
+
+    if ( isDoublePrecision )
+        _analysis.write<double>(( double** ) out, numOutChannels, data.numSamples );
+    else
+        _analysis.write<float>(( float** ) out, numOutChannels, data.numSamples );
+
+    float outputGain = isBypassed ? 1.f : pluginProcess->getGainReduction();
+    _meter.update( outputGain, data.numSamples );
+
+    // report the gain reduction to the host (only when it has changed)
+
+    IParameterChanges* outParamChanges = data.outputParameterChanges;
+    if ( outParamChanges && fabs( outputGain - _lastGainReduction ) > 0.0001f )
+    {
+        int32 index = 0;
+        IParamValueQueue* paramQueue = outParamChanges->addParameterData( kOutputGainReductionId, index );
+        if ( paramQueue )
+        {
+            int32 queueIndex = 0;
+            paramQueue->addPoint( 0, 1.f - outputGain, queueIndex );
+        }
+        _lastGainReduction = outputGain;
+    }
+
+    // signal the controller the latency has changed, so it can request the host to query it
+
+    int32 latency = pluginProcess->getLatencySamples();
+    if ( outParamChanges && latency != _signalledLatency )
+    {
+        _signalledLatency = latency;
+
+        int32 index = 0;
+        IParamValueQueue* paramQueue = outParamChanges->addParameterData( kLatencyId, index );
+        if ( paramQueue )
+        {
+            int32 queueIndex = 0;
+            paramQueue->addPoint( 0, std::min( 1.0, latency / 8192.0 ), queueIndex );
+        }
+    }
 
     return kResultOk;
 }
 
+//------------------------------------------------------------------------
+template <typename SampleType>
+void __PLUGIN_NAME__::processSoftBypassed( SampleType** in, SampleType** out, int32 numInChannels, int32 numOutChannels,
+                                           int32 numBypassChannels, int32 numSamples, SampleType** sideChain, int32 numSideChainChannels )
+{
+    int32 chunkSize = std::max( 1, processSetup.maxSamplesPerBlock );
+
+    if ( numSamples <= chunkSize )
+    {
+        _softBypass.storeInput<SampleType>( in, numBypassChannels, numSamples );
+        pluginProcess->process<SampleType>(
+            in, out, numInChannels, numOutChannels,
+            numSamples, getSampleFramesSizeInBytes( processSetup, numSamples ), sideChain, numSideChainChannels
+        );
+        _softBypass.mix<SampleType>( out, numBypassChannels, numSamples );
+        return;
+    }
+
+    // the soft bypass retains at most maxSamplesPerBlock samples of the input, as such larger blocks (from hosts
+    // not honouring the setup) are processed in chunks, so the crossfade (and bypassed signal) remain intact
+
+    const int32 MAX_CHUNK_CHANNELS = 32;
+
+    SampleType* inChunk       [ MAX_CHUNK_CHANNELS ];
+    SampleType* outChunk      [ MAX_CHUNK_CHANNELS ];
+    SampleType* sideChainChunk[ MAX_CHUNK_CHANNELS ];
+
+    numInChannels        = std::min( numInChannels,  MAX_CHUNK_CHANNELS );
+    numOutChannels       = std::min( numOutChannels, MAX_CHUNK_CHANNELS );
+    numSideChainChannels = sideChain != nullptr ? std::min( numSideChainChannels, MAX_CHUNK_CHANNELS ) : 0;
+
+    for ( int32 offset = 0; offset < numSamples; offset += chunkSize )
+    {
+        for ( int32 c = 0; c < numInChannels; ++c )
+            inChunk[ c ] = in[ c ] + offset;
+
+        for ( int32 c = 0; c < numOutChannels; ++c )
+            outChunk[ c ] = out[ c ] + offset;
+
+        for ( int32 c = 0; c < numSideChainChannels; ++c )
+            sideChainChunk[ c ] = sideChain[ c ] + offset;
+
+        processSoftBypassed<SampleType>(
+            inChunk, outChunk, numInChannels, numOutChannels, numBypassChannels,
+            std::min( chunkSize, numSamples - offset ), sideChain != nullptr ? sideChainChunk : nullptr, numSideChainChannels
+        );
+    }
+}
+
 //------------------------------------------------------------------------
 tresult __PLUGIN_NAME__::receiveText( const char* text )
 {
@@ -262,46 +435,19 @@ tresult PLUGIN_API __PLUGIN_NAME__::setState( IBStream* state )
 
     IBStreamer streamer( state, kLittleEndian );
 
-    int32 savedBypass = 0;
-    if ( streamer.readInt32( savedBypass ) == false )
-        return kResultFalse;
-
-// --- AUTO-GENERATED SETSTATE START
+    // values not present in the stream retain their current value
 
-    float savedBitDepth = 0.f;
-    if ( streamer.readFloat( savedBitDepth ) == false )
-        return kResultFalse;
-
-    float savedBitCrushLfo = 0.f;
-    if ( streamer.readFloat( savedBitCrushLfo ) == false )
-        return kResultFalse;
-
-    float savedBitCrushLfoDepth = 0.f;
-    if ( streamer.readFloat( savedBitCrushLfoDepth ) == false )
-        return kResultFalse;
-
-    float savedWetMix = 0.f;
-    if ( streamer.readFloat( savedWetMix ) == false )
-        return kResultFalse;
+    PresetRecord record = createRecord();
 
-    float savedDryMix = 0.f;
-    if ( streamer.readFloat( savedDryMix ) == false )
+    if ( !PresetBank::readState( streamer, record ))
         return kResultFalse;
 
+    applyRecord( record );
 
-// --- AUTO-GENERATED SETSTATE END
+    // no smoothing is applied when restoring state
 
-    _bypass = savedBypass > 0;
-
-// --- AUTO-GENERATED SETSTATE APPLY START
-
-    fBitDepth = savedBitDepth;
-    fBitCrushLfo = savedBitCrushLfo;
-    fBitCrushLfoDepth = savedBitCrushLfoDepth;
-    fWetMix = savedWetMix;
-    fDryMix = savedDryMix;
-
-// --- AUTO-GENERATED SETSTATE APPLY END
+    _smoothedModel = _model;
+    _isSmoothing   = false;
 
     syncModel();
 
@@ -345,17 +491,8 @@ tresult PLUGIN_API __PLUGIN_NAME__::getState( IBStream* state )
 
     IBStreamer streamer( state, kLittleEndian );
 
-    streamer.writeInt32( _bypass ? 1 : 0 );
-
-// --- AUTO-GENERATED GETSTATE START
-
-    streamer.writeFloat( fBitDepth );
-    streamer.writeFloat( fBitCrushLfo );
-    streamer.writeFloat( fBitCrushLfoDepth );
-    streamer.writeFloat( fWetMix );
-    streamer.writeFloat( fDryMix );
-
-// --- AUTO-GENERATED GETSTATE END
+    if ( !PresetBank::writeState( streamer, createRecord()))
+        return kResultFalse;
 
     return kResultOk;
 }
@@ -368,26 +505,94 @@ tresult PLUGIN_API __PLUGIN_NAME__::setupProcessing( ProcessSetup& newSetup )
     // here we keep a trace of the processing mode (offline,...) for example.
     currentProcessMode = newSetup.processMode;
 
-    VST::SAMPLE_RATE = newSetup.sampleRate;
+    _meter.setSampleRate( newSetup.sampleRate );
 
-    // spotted to fire multiple times...
+    preparePluginProcess( newSetup );
+    syncModel();
 
-    if ( pluginProcess != nullptr )
+    return AudioEffect::setupProcessing( newSetup );
+}
+
+//------------------------------------------------------------------------
+void __PLUGIN_NAME__::preparePluginProcess( const ProcessSetup& setup )
+{
+    // allocate for the channel amount of the main busses (as negotiated in setBusArrangements())
+
+    SpeakerArrangement input  = SpeakerArr::kStereo;
+    SpeakerArrangement output = SpeakerArr::kStereo;
+    getBusArrangement( kInput,  0, input );
+    getBusArrangement( kOutput, 0, output );
+
+    int amountOfChannels = std::max( 1, std::max( SpeakerArr::getChannelCount( input ), SpeakerArr::getChannelCount( output )));
+
+    // setupProcessing has been spotted to fire multiple times, only recreate the
+    // processors when the channel configuration has changed
+
+    if ( pluginProcess != nullptr && pluginProcess->getAmountOfChannels() != amountOfChannels )
+    {
         delete pluginProcess;
+        pluginProcess = nullptr;
+    }
 
-    // TODO: creating a bunch of extra channels for no apparent reason?
-    // get the correct channel amount and don't allocate more than necessary...
-    pluginProcess = new PluginProcess( 6 );
+    // the processors derive their sample rate dependent values from the context of this instance
+    // (instances can process at different rates, e.g. during an offline render)
 
-    syncModel();
+    ProcessingContext context(
+        ( float ) setup.sampleRate, setup.maxSamplesPerBlock, amountOfChannels, ( ProcessingContext::Mode ) setup.processMode
+    );
 
-    return AudioEffect::setupProcessing( newSetup );
+    if ( pluginProcess == nullptr )
+    {
+        pluginProcess = new PluginProcess( context );
+        pluginProcess->setInternalBlockSize( INTERNAL_BLOCK_SIZE, INTERNAL_BLOCK_MODE );
+    }
+    pluginProcess->setProcessingContext( context );
+
+    prepareSoftBypass( setup );
+
+    _analysis.prepare( setup.maxSamplesPerBlock, ( float ) setup.sampleRate );
+}
+
+//------------------------------------------------------------------------
+void __PLUGIN_NAME__::prepareSoftBypass( const ProcessSetup& setup )
+{
+    // the unprocessed signal is delayed by the processing latency to remain aligned with the processed signal
+    // its delay lines are sized for the largest latency, so changes to the latency during playback do not allocate
+
+    _reportedLatency  = pluginProcess->getLatencySamples();
+    _signalledLatency = _reportedLatency;
+
+    _softBypass.setResumeMode( BYPASS_RESUME_MODE );
+    _softBypass.prepare(
+        pluginProcess->getAmountOfChannels(), setup.maxSamplesPerBlock,
+        ( int ) ( BYPASS_FADE_TIME * setup.sampleRate ), _reportedLatency, pluginProcess->getMaxLatencySamples()
+    );
+}
+
+//------------------------------------------------------------------------
+uint32 PLUGIN_API __PLUGIN_NAME__::getLatencySamples()
+{
+    return pluginProcess != nullptr ? pluginProcess->getLatencySamples() : 0;
 }
 
 //------------------------------------------------------------------------
 tresult PLUGIN_API __PLUGIN_NAME__::setBusArrangements( SpeakerArrangement* inputs,  int32 numIns,
                                                  SpeakerArrangement* outputs, int32 numOuts )
 {
+    // instances providing a sidechain receive its arrangement as the second input (mono or stereo)
+
+    SpeakerArrangement sideChainArrangement = SpeakerArr::kStereo;
+
+    if ( _hasSideChain && numIns == 2 )
+    {
+        int32 sideChainChannels = SpeakerArr::getChannelCount( inputs[1] );
+        if ( sideChainChannels < 1 || sideChainChannels > PluginProcess::MAX_SIDECHAIN_CHANNELS )
+            return kResultFalse;
+
+        sideChainArrangement = inputs[1];
+        numIns = 1;
+    }
+
     if ( numIns == 1 && numOuts == 1 )
     {
         // the host wants Mono => Mono (or 1 channel -> 1 channel)
@@ -404,6 +609,7 @@ tresult PLUGIN_API __PLUGIN_NAME__::setBusArrangements( SpeakerArrangement* inpu
                     addAudioInput ( STR16( "Mono In" ),  inputs[0] );
                     addAudioOutput( STR16( "Mono Out" ), inputs[0] );
                 }
+                updateSideChainBus( sideChainArrangement );
                 return kResultOk;
             }
         }
@@ -421,6 +627,7 @@ tresult PLUGIN_API __PLUGIN_NAME__::setBusArrangements( SpeakerArrangement* inpu
                     removeAudioBusses();
                     addAudioInput  ( STR16( "Stereo In"),  inputs[0] );
                     addAudioOutput ( STR16( "Stereo Out"), outputs[0]);
+                    updateSideChainBus( sideChainArrangement );
                     result = kResultTrue;
                 }
                 // the host want something different than 1->1 or 2->2 : in this case we want stereo
@@ -429,6 +636,7 @@ tresult PLUGIN_API __PLUGIN_NAME__::setBusArrangements( SpeakerArrangement* inpu
                     removeAudioBusses();
                     addAudioInput ( STR16( "Stereo In"),  SpeakerArr::kStereo );
                     addAudioOutput( STR16( "Stereo Out"), SpeakerArr::kStereo );
+                    updateSideChainBus( SpeakerArr::kStereo );
                     result = kResultFalse;
                 }
                 return result;
@@ -438,6 +646,24 @@ tresult PLUGIN_API __PLUGIN_NAME__::setBusArrangements( SpeakerArrangement* inpu
     return kResultFalse;
 }
 
+//------------------------------------------------------------------------
+void __PLUGIN_NAME__::updateSideChainBus( SpeakerArrangement arrangement )
+{
+    if ( !_hasSideChain )
+        return;
+
+    // the sidechain bus is an auxiliary input which is inactive by default
+
+    if ( audioInputs.size() < 2 )
+    {
+        addAudioInput( STR16( "Sidechain In" ), arrangement, kAux, 0 );
+        return;
+    }
+    AudioBus* bus = FCast<AudioBus>( audioInputs.at( 1 ));
+    if ( bus )
+        bus->setArrangement( arrangement );
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API __PLUGIN_NAME__::canProcessSampleSize( int32 symbolicSampleSize )
 {
@@ -457,6 +683,16 @@ tresult PLUGIN_API __PLUGIN_NAME__::notify( IMessage* message )
     if ( !message )
         return kInvalidArgument;
 
+    if ( !strcmp( message->getMessageID(), "LoadPreset" ))
+    {
+        // request to recall a preset, it will be applied on the next process cycle
+        double value = 0;
+        if ( message->getAttributes()->getFloat( "value", value ) == kResultOk ) {
+            loadPreset( value );
+        }
+        return kResultOk;
+    }
+
     if ( !strcmp( message->getMessageID(), "BinaryMessage" ))
     {
         const void* data;
@@ -476,15 +712,127 @@ tresult PLUGIN_API __PLUGIN_NAME__::notify( IMessage* message )
     return AudioEffect::notify( message );
 }
 
+void __PLUGIN_NAME__::loadPreset( ParamValue value )
+{
+    PresetBank* bank = PresetBank::getInstance();
+    int amountOfPresets = bank->getPresetCount();
+
+    if ( amountOfPresets == 0 )
+        return;
+
+    int index = ( int ) round( value * ( amountOfPresets - 1 ));
+    const PresetRecord* preset = bank->getPreset( index );
+
+    if ( preset != nullptr ) {
+        _pendingPreset.store( preset );
+    }
+}
+
+PresetRecord __PLUGIN_NAME__::createRecord()
+{
+    PresetRecord record;
+    record.bypass = _bypass ? 1 : 0;
+    record.model  = _model;
+
+    return record;
+}
+
+void __PLUGIN_NAME__::applyRecord( const PresetRecord& record )
+{
+    _bypass = record.bypass > 0;
+    _model  = record.model;
+}
+
+void __PLUGIN_NAME__::sendDisplayQueues( bool active )
+{
+    DisplayQueueRegistry* registry = DisplayQueueRegistry::getInstance();
+
+    if ( _displayQueuesToken != 0 ) {
+        registry->remove( _displayQueuesToken );
+        _displayQueuesToken = 0;
+    }
+
+    if ( active )
+        _displayQueuesToken = registry->add({ _meter.getFifo(), &_analysis });
+
+    if ( IPtr<IMessage> message = owned( allocateMessage()))
+    {
+        message->setMessageID( "DisplayQueues" );
+        message->getAttributes()->setInt( "token", _displayQueuesToken );
+        sendMessage( message );
+    }
+}
+
+void __PLUGIN_NAME__::smoothModel( int32 numSamples )
+{
+    TRACE_ZONE( "Plugin::smoothModel" );
+
+    const float* target = getModelValues( _model );
+    float* current      = getModelValues( _smoothedModel );
+
+    // early exit when no values have changed since the last cycle
+
+    if ( !_isSmoothing && memcmp( target, current, sizeof( PluginModel )) == 0 )
+        return;
+
+    // one-pole smoothing with a time constant of SMOOTHING_TIME seconds, applied per block
+
+    const float SMOOTHING_TIME = 0.02f;
+    const float coefficient    = 1.f - expf( -( float ) numSamples / ( SMOOTHING_TIME * ( float ) processSetup.sampleRate ));
+
+    _isSmoothing = false;
+
+    for ( int32 i = 0; i < MODEL_PARAMETER_COUNT; ++i )
+    {
+        if ( !PARAMETERS[ i ].smooth ) {
+            current[ i ] = target[ i ];
+            continue;
+        }
+        float delta = target[ i ] - current[ i ];
+
+        if ( fabs( delta ) < 0.0001f ) {
+            current[ i ] = target[ i ];
+        } else {
+            current[ i ] += delta * coefficient;
+            _isSmoothing  = true;
+        }
+    }
+    syncModel();
+}
+
 void __PLUGIN_NAME__::syncModel()
 {
-    // forward the protected model values onto the plugin process and related processors
+    TRACE_ZONE( "Plugin::syncModel" );
+
+    if ( pluginProcess == nullptr )
+        return;
+
+    // forward the smoothed model values onto the plugin process and related processors
     // NOTE: when dealing with "bool"-types, use Calc::toBool() to determine on/off
-    pluginProcess->bitCrusher->setAmount( fBitDepth );
-    pluginProcess->bitCrusher->setLFO( fBitCrushLfo, fBitCrushLfoDepth );
+    // when the processor requires plain values, use getParameterDescriptor( kXId ).toPlain()
+    pluginProcess->bitCrusher->setAmount( _smoothedModel.bitDepth );
+    pluginProcess->bitCrusher->setLFO( _smoothedModel.bitCrushLfo, _smoothedModel.bitCrushLfoDepth );
+    pluginProcess->bitCrusher->setAntiAliasing(( BitCrusher::AntiAliasing ) round( _smoothedModel.bitCrushAntiAliasing * 2 ));
+    pluginProcess->bitCrusher->setDither(( Dither::Mode ) round( _smoothedModel.bitCrushDither * 2 ));
     // output mix
-    pluginProcess->setDryMix( fDryMix );
-    pluginProcess->setWetMix( fWetMix );
+    pluginProcess->setDryMix( _smoothedModel.dryMix );
+    pluginProcess->setWetMix( _smoothedModel.wetMix );
+    // sidechain
+    pluginProcess->setSideChainDuck( _smoothedModel.sideChainDuck );
+    pluginProcess->setSideChainCrush( _smoothedModel.sideChainCrush );
+    // output
+    pluginProcess->setLimiterEnabled( Calc::toBool( _smoothedModel.outputLimiter ));
+    // delay
+    pluginProcess->setDelayTime( _smoothedModel.delayTime );
+    pluginProcess->setDelayFeedback( _smoothedModel.delayFeedback );
+    pluginProcess->setDelayMix( _smoothedModel.delayMix );
+    // filter bank
+    pluginProcess->filterBank->setHighPass( getParameterDescriptor( kFilterHighPassId ).toPlain( _smoothedModel.filterHighPass ));
+    pluginProcess->filterBank->setLowPass( getParameterDescriptor( kFilterLowPassId ).toPlain( _smoothedModel.filterLowPass ));
+    pluginProcess->filterBank->setTilt( getParameterDescriptor( kFilterTiltId ).toPlain( _smoothedModel.filterTilt ));
+    // convolver
+    pluginProcess->convolver->setImpulse(( Convolver::Impulse ) round( _smoothedModel.convolverImpulse * ( Convolver::IMPULSE_COUNT - 1 )));
+    pluginProcess->convolver->setMix( _smoothedModel.convolverMix );
 }
 
 }
@@ -25,7 +25,14 @@
 
 #include "public.sdk/source/vst/vstaudioeffect.h"
 #include "plugin_process.h"
+#include "meter.h"
+#include "analysisring.h"
+#include "displayqueues.h"
+#include "presetbank.h"
+#include "softbypass.h"
+#include "model.h"
 #include "global.h"
+#include <atomic>
 
 using namespace Steinberg::Vst;
 
@@ -37,7 +44,7 @@ namespace Igorski {
 class __PLUGIN_NAME__ : public AudioEffect
 {
     public:
-        __PLUGIN_NAME__ ();
+        __PLUGIN_NAME__ ( bool hasSideChain = false );
         virtual ~__PLUGIN_NAME__(); // do not forget virtual here
 
         //--- ---------------------------------------------------------------------
@@ -46,6 +53,9 @@ class __PLUGIN_NAME__ : public AudioEffect
         //--- ---------------------------------------------------------------------
         static FUnknown* createInstance( void* /*context*/ ) { return ( IAudioProcessor* ) new __PLUGIN_NAME__; }
 
+        // variant of the Plug-in providing an additional (auxiliary) sidechain input bus
+        static FUnknown* createSideChainInstance( void* /*context*/ ) { return ( IAudioProcessor* ) new __PLUGIN_NAME__( true ); }
+
         //--- ---------------------------------------------------------------------
         // AudioEffect overrides:
         //--- ---------------------------------------------------------------------
@@ -71,6 +81,9 @@ class __PLUGIN_NAME__ : public AudioEffect
         /** Will be called before any process call */
         tresult PLUGIN_API setupProcessing( ProcessSetup& newSetup ) SMTG_OVERRIDE;
 
+        /** Reports the latency introduced by the processing (e.g. the block adapter) */
+        uint32 PLUGIN_API getLatencySamples() SMTG_OVERRIDE;
+
         /** Bus arrangement managing */
         tresult PLUGIN_API setBusArrangements( SpeakerArrangement* inputs, int32 numIns,
                                                SpeakerArrangement* outputs,
@@ -84,27 +97,95 @@ class __PLUGIN_NAME__ : public AudioEffect
 
     protected:
 
-        // our model values, these are all 0 - 1 range
-        // (normalized) RangeParameter values
+        // our model values, these are all 0 - 1 range (normalized) values (see model.h)
+        // _model holds the values as set by the host, _smoothedModel the values applied to the
+        // processors (equal to _model except for parameters that are smoothed over time)
 
-// --- AUTO-GENERATED START
+        Igorski::PluginModel _model;
+        Igorski::PluginModel _smoothedModel;
+        bool _isSmoothing = false;
 
-        float fBitDepth = 1.f;    // Resolution
-        float fBitCrushLfo = 0.f;    // Bit crush LFO
-        float fBitCrushLfoDepth = 0.f;    // Bit crush LFO depth
-        float fWetMix = 1.f;    // Wet mix
-        float fDryMix = 0.f;    // Dry mix
+        bool _bypass { false };
 
-// --- AUTO-GENERATED END
+        // the size of the internal blocks the audio is processed in (see PluginProcess::setInternalBlockSize()),
+        // for block based or vectorised processors. FIXED_LATENCY delays the output by the block size (reported to
+        // the host through getLatencySamples()), ZERO_LATENCY processes the ragged edges of each host block through
+        // the FIFO instead. As none of the current processors require it, it is disabled (0)
 
-        bool _bypass { false };
+        static constexpr int INTERNAL_BLOCK_SIZE = 0;
+        static constexpr Igorski::BlockAdapter::Mode INTERNAL_BLOCK_MODE = Igorski::BlockAdapter::Mode::ZERO_LATENCY;
+
+        // crossfades between the processed and unprocessed signal when toggling the bypass, when
+        // fully bypassed the processing is skipped (see SoftBypass::Resume for the behaviour on resume)
+
+        static constexpr float BYPASS_FADE_TIME = 0.01f; // in seconds
+        static constexpr Igorski::SoftBypass::Resume BYPASS_RESUME_MODE = Igorski::SoftBypass::Resume::RESET;
+        Igorski::SoftBypass _softBypass;
+        bool _hasSideChain;
+
+        // creates or updates the sidechain input bus (when this instance provides one)
+
+        void updateSideChainBus( SpeakerArrangement arrangement );
 
         int32 currentProcessMode;
         Igorski::PluginProcess* pluginProcess;
 
+        // metering (read by the controller, see PluginController::onDisplayTimer())
+
+        Igorski::Meter _meter;
+        float _lastGainReduction = 1.f;
+
+        // the latency last reported to the host (see getLatencySamples()), changes to the latency of the
+        // processing (e.g. when toggling the bit crushers anti-aliasing) are signalled through kLatencyId
+
+        int32 _reportedLatency  = 0;
+        int32 _signalledLatency = 0;
+
+        // the most recent output, for spectrum analysis and the oscilloscope (only written to
+        // while enabled by the controller, see PluginController::didOpen())
+
+        Igorski::OutputAnalysisRing _analysis;
+
+        // share the meter queue and analysis ring with the controller, these are registered in the
+        // DisplayQueueRegistry and only their token is sent (0 signals the processor is no longer processing)
+
+        int64 _displayQueuesToken = 0;
+        void sendDisplayQueues( bool active );
+
+        // prepare the bypass crossfade for given setup and the current processing latency
+        void prepareSoftBypass( const ProcessSetup& setup );
+
+        // process given buffers, crossfading with the input while the bypass is toggled, blocks larger than
+        // the maximum block size of the setup are processed in consecutive chunks (see SoftBypass::storeInput())
+
+        template <typename SampleType>
+        void processSoftBypassed( SampleType** in, SampleType** out, int32 numInChannels, int32 numOutChannels,
+                                  int32 numBypassChannels, int32 numSamples, SampleType** sideChain, int32 numSideChainChannels );
+
+        // allocate the processors (or update these for given setup), deferred until
+        // processing is set up to keep instantiation (e.g. during a host scan) cheap
+
+        void preparePluginProcess( const ProcessSetup& setup );
+
         // synchronize the processors model with UI led changes
 
         void syncModel();
+
+        // move the values of smoothed parameters towards their target over given amount of samples
+
+        void smoothModel( int32 numSamples );
+
+        // presets, recalling a preset swaps in a pointer to its record (see presetbank.h)
+        // which is applied at the start of the next process cycle
+
+        std::atomic<const Igorski::PresetRecord*> _pendingPreset { nullptr };
+
+        void loadPreset( ParamValue normalizedValue );
+
+        // convert between the model and its fixed layout representation
+
+        Igorski::PresetRecord createRecord();
+        void applyRecord( const Igorski::PresetRecord& record );
 };
 
 }
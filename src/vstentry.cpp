@@ -23,9 +23,23 @@
 #include "vst.h"
 #include "ui/controller.h"
 #include "global.h"
+#include "presetbank.h"
+#include "kernels/kernels.h"
+#include "resourceregistry.h"
+#include "trace.h"
 #include "version.h"
 
 #include "public.sdk/source/main/pluginfactory.h"
+#include "public.sdk/source/main/moduleinit.h"
+
+#include <string>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
 
 #if TARGET_OS_IPHONE
 #include "public.sdk/source/vst/vstguieditor.h"
@@ -40,6 +54,88 @@ using namespace Igorski;
 extern void* moduleHandle;
 #endif
 
+//------------------------------------------------------------------------
+//  Module initialization
+//------------------------------------------------------------------------
+
+// retrieves the path of given file inside the bundles Resources folder
+// (e.g. __PLUGIN_NAME__.vst3/Contents/Resources) by resolving the location of this module
+// (e.g. __PLUGIN_NAME__.vst3/Contents/{architecture}/__PLUGIN_NAME__.so)
+
+static std::string getResourcePath( const char* filename )
+{
+    std::string modulePath;
+#ifdef _WIN32
+    HMODULE module = nullptr;
+    char path[ MAX_PATH ];
+    if ( GetModuleHandleExA( GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                             ( LPCSTR ) &getResourcePath, &module ) &&
+         GetModuleFileNameA( module, path, MAX_PATH ) > 0 ) {
+        modulePath = path;
+    }
+    const char* separators = "\\/";
+#else
+    Dl_info info;
+    if ( dladdr(( void* ) &getResourcePath, &info ) != 0 && info.dli_fname != nullptr ) {
+        modulePath = info.dli_fname;
+    }
+    const char* separators = "/";
+#endif
+    // strip the module filename and architecture folder
+    for ( int i = 0; i < 2; ++i ) {
+        size_t separator = modulePath.find_last_of( separators );
+        if ( separator == std::string::npos ) {
+            return "";
+        }
+        modulePath.erase( separator );
+    }
+    return modulePath + "/Resources/" + filename;
+}
+
+// map the factory preset bank into memory once for all instances
+
+static ModuleInitializer initPresetBank([] () {
+    PresetBank::getInstance()->open( getResourcePath( "presets.bin" ).c_str());
+});
+
+static ModuleTerminator terminatePresetBank([] () {
+    PresetBank::getInstance()->close();
+});
+
+// build the read-only DSP resources that don't depend on the sample rate once
+// for all instances (other resources are shared once acquired, see resourceregistry.h)
+
+static ModuleInitializer initResources([] () {
+    Kernels::init(); // select the DSP kernels for this CPU
+    ResourceRegistry::getInstance()->preload( ResourceId::SINE_TABLE );
+});
+
+static ModuleTerminator terminateResources([] () {
+    ResourceRegistry::getInstance()->clear();
+});
+
+#if TRACE_ZONES
+
+// record trace zones while the module is loaded, when the TRACE_OUTPUT environment
+// variable provides the file the trace is exported to upon unloading (see trace.h)
+
+static ModuleInitializer initTrace([] () {
+    if ( getenv( "TRACE_OUTPUT" ) != nullptr ) {
+        Trace::start();
+    }
+});
+
+static ModuleTerminator terminateTrace([] () {
+    const char* filename = getenv( "TRACE_OUTPUT" );
+    if ( filename != nullptr && Trace::isEnabled()) {
+        Trace::stop();
+        Trace::exportChromeTrace( filename );
+    }
+    Trace::release();
+});
+
+#endif
+
 //------------------------------------------------------------------------
 //  VST Plug-in Entry
 //------------------------------------------------------------------------
@@ -63,6 +159,17 @@ BEGIN_FACTORY_DEF( "igorski.nl",
                 kVstVersionString,               // the VST 3 SDK version (do not change this)
                 __PLUGIN_NAME__::createInstance )       // function pointer called when this component should be instantiated
 
+    // the same component, providing an additional sidechain input bus
+    DEF_CLASS2( INLINE_UID_FROM_FUID( Igorski::VST::PluginWithSideChainProcessorUID ),
+                PClassInfo::kManyInstances,      // cardinality
+                kVstAudioEffectClass,            // the component category (do not change this)
+                "__PLUGIN_NAME__ Sidechain",     // plug-in name
+                Vst::kDistributable,             // means that component and controller could be distributed on different computers
+                "Fx",                            // Subcategory for this Plug-in
+                FULL_VERSION_STR,                // Plug-in version
+                kVstVersionString,               // the VST 3 SDK version (do not change this)
+                __PLUGIN_NAME__::createSideChainInstance ) // function pointer called when this component should be instantiated
+
     // its kVstComponentControllerClass component
     DEF_CLASS2( INLINE_UID_FROM_FUID( Igorski::VST::PluginControllerUID ),
                 PClassInfo::kManyInstances,   // cardinality
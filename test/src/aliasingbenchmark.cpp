@@ -0,0 +1,342 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * Compares the antiderivative anti-aliasing (ADAA) of the BitCrusher against oversampling the
+ * plain quantizer, measuring both the aliasing and the CPU cost of each. A sine is crushed
+ * and the energy outside its harmonics (e.g. the harmonics folded back from above Nyquist)
+ * is expressed relative to that of the harmonics, within the audible band.
+ *
+ * The oversampling runs the plain quantizer at 2, 4, 8 or 16 times the sample rate, between
+ * cascaded polyphase halfband filters (as an efficient oversampler would). The benchmark
+ * then reports which oversampling factor matches the suppression of each ADAA order and
+ * the cost of doing so, in relation to the ADAA.
+ *
+ * This is not a test (e.g. it does not fail), its timing is specific to the machine.
+ *
+ * usage: aliasingbenchmark [--amount A] [--frequency HZ] [--repeat N]
+ *        amount is the BitCrusher amount (defaults to .2), frequency that of the sine
+ *        (defaults to 2 kHz) and repeat the amount of renders to time (defaults to 100)
+ */
+#include "bitcrusher.h"
+#include "fft.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Igorski;
+
+namespace {
+
+const double SAMPLE_RATE    = 44100.0;
+const double AUDIBLE_LIMIT  = 20000.0; // upper bound of the measured band, in Hz
+const int    LENGTH         = 8192;    // size of the analysed render (and its FFT)
+const int    BLOCK_SIZE     = 512;
+const double PI             = 3.141592653589793;
+
+struct Options {
+    float amount     = .2f;
+    double frequency = 2000.0;
+    int repeat       = 100;
+};
+
+/**
+ * A halfband lowpass (cutoff at a quarter of the rate it runs at), used to double or halve
+ * the sample rate. Every other coefficient of a halfband filter is zero (apart from the centre
+ * tap of .5), meaning each output sample only requires HALF_TAPS multiplications of sample pairs.
+ * The coefficients are a Blackman windowed sinc (4 * HALF_TAPS + 1 taps).
+ */
+class HalfbandFilter
+{
+    public:
+        static const int HALF_TAPS = 16;
+
+        HalfbandFilter()
+        {
+            const int centre = 2 * HALF_TAPS;
+            double sum = 0.0;
+
+            for ( int k = 0; k < HALF_TAPS; ++k ) {
+                int offset    = 2 * k + 1;
+                double n      = centre + offset;
+                double window = .42 - .5 * cos( PI * n / centre ) + .08 * cos( 2.0 * PI * n / centre );
+                double sinc   = sin( PI * offset * .5 ) / ( PI * offset * .5 );
+
+                _coefficients[ k ] = .5 * sinc * window;
+                sum += _coefficients[ k ];
+            }
+            // normalize for unity gain at DC (the centre tap provides half)
+
+            for ( float& coefficient : _coefficients ) {
+                coefficient *= .25 / sum;
+            }
+        }
+
+        void prepare( int maxBufferSize )
+        {
+            _upBuffer.assign( UP_HISTORY + maxBufferSize, 0.f );
+            _downBuffer.assign( DOWN_HISTORY + maxBufferSize * 2, 0.f );
+        }
+
+        // double the rate of given signal, output holds twice the size (delays by HALF_TAPS output samples)
+
+        void upsample( const float* input, float* output, int size )
+        {
+            float* buffer = _upBuffer.data(); // the input history followed by the input
+            std::copy( input, input + size, buffer + UP_HISTORY );
+
+            for ( int i = 0; i < size; ++i ) {
+                const float* centre = buffer + i + UP_HISTORY / 2; // the input sample of the centre tap
+                float sum = 0.f;
+                for ( int k = 0; k < HALF_TAPS; ++k ) {
+                    sum += _coefficients[ k ] * ( centre[ -k ] + centre[ k + 1 ]);
+                }
+                // zero stuffing halves the gain, as such the output is doubled
+                output[ i * 2 ]     = centre[ 0 ];
+                output[ i * 2 + 1 ] = 2.f * sum;
+            }
+            std::copy( buffer + size, buffer + size + UP_HISTORY, buffer );
+        }
+
+        // halve the rate of given signal holding twice the size of output (delays by HALF_TAPS input samples)
+
+        void downsample( const float* input, float* output, int size )
+        {
+            float* buffer = _downBuffer.data();
+            std::copy( input, input + size * 2, buffer + DOWN_HISTORY );
+
+            for ( int i = 0; i < size; ++i ) {
+                const float* centre = buffer + i * 2 + DOWN_HISTORY / 2;
+                float sum = .5f * centre[ 0 ];
+                for ( int k = 0; k < HALF_TAPS; ++k ) {
+                    sum += _coefficients[ k ] * ( centre[ -( 2 * k + 1 )] + centre[ 2 * k + 1 ]);
+                }
+                output[ i ] = sum;
+            }
+            std::copy( buffer + size * 2, buffer + size * 2 + DOWN_HISTORY, buffer );
+        }
+
+    private:
+        static const int UP_HISTORY   = HALF_TAPS * 2;
+        static const int DOWN_HISTORY = HALF_TAPS * 4;
+
+        float _coefficients[ HALF_TAPS ]; // of the odd offsets from the centre tap (the filter is symmetric)
+        std::vector<float> _upBuffer;
+        std::vector<float> _downBuffer;
+};
+
+/**
+ * The crushing variants under comparison, processing a single channel in blocks
+ */
+class Variant
+{
+    public:
+        // factor is the amount of oversampling (a power of two, 1 disables oversampling)
+
+        Variant( const std::string& name, BitCrusher::AntiAliasing antiAliasing, int factor, float amount )
+          : name( name ), factor( factor ), _crusher( amount, 1.f, 1.f ), _stages( 0 )
+        {
+            while (( 1 << _stages ) < factor ) {
+                ++_stages;
+            }
+            _crusher.setAntiAliasing( antiAliasing );
+            _crusher.setSampleRate(( float ) ( SAMPLE_RATE * factor ));
+
+            _upFilters.resize( _stages );
+            _downFilters.resize( _stages );
+            for ( int i = 0; i < _stages; ++i ) {
+                _upFilters[ i ].prepare( BLOCK_SIZE << i );
+                _downFilters[ i ].prepare( BLOCK_SIZE << i );
+            }
+            _buffers.resize( _stages + 1 );
+            for ( int i = 0; i <= _stages; ++i ) {
+                _buffers[ i ].resize( BLOCK_SIZE << i );
+            }
+        }
+
+        void process( const float* input, float* output, int size )
+        {
+            std::copy( input, input + size, _buffers[ 0 ].data());
+
+            for ( int i = 0; i < _stages; ++i ) {
+                _upFilters[ i ].upsample( _buffers[ i ].data(), _buffers[ i + 1 ].data(), size << i );
+            }
+            float* samples = _buffers[ _stages ].data();
+            int oversampledSize = size << _stages;
+
+            _crusher.begin();
+            for ( int i = 0; i < oversampledSize; ++i ) {
+                samples[ i ] = _crusher.tick( samples[ i ], i );
+            }
+
+            for ( int i = _stages - 1; i >= 0; --i ) {
+                _downFilters[ i ].downsample( _buffers[ i + 1 ].data(), _buffers[ i ].data(), size << i );
+            }
+            std::copy( _buffers[ 0 ].data(), _buffers[ 0 ].data() + size, output );
+        }
+
+        const std::string name;
+        const int factor;
+
+        double aliasing = 0.0; // in dB relative to the harmonics
+        double cost     = 0.0; // in nanoseconds per sample (at the non-oversampled rate)
+
+    private:
+        BitCrusher _crusher;
+        int _stages;
+        std::vector<HalfbandFilter> _upFilters;
+        std::vector<HalfbandFilter> _downFilters;
+        std::vector<std::vector<float>> _buffers;
+};
+
+bool parseOptions( int argc, char* argv[], Options& options )
+{
+    for ( int i = 1; i < argc; ++i ) {
+        std::string arg = argv[ i ];
+        bool hasValue   = i + 1 < argc;
+
+        if ( arg == "--amount" && hasValue )         options.amount    = ( float ) atof( argv[ ++i ]);
+        else if ( arg == "--frequency" && hasValue ) options.frequency = atof( argv[ ++i ]);
+        else if ( arg == "--repeat" && hasValue )    options.repeat    = std::max( 1, atoi( argv[ ++i ]));
+        else {
+            return false;
+        }
+    }
+    return options.frequency > 0.0 && options.frequency < AUDIBLE_LIMIT;
+}
+
+// render given input through given variant in blocks
+
+void render( Variant& variant, const std::vector<float>& input, std::vector<float>& output )
+{
+    for ( size_t offset = 0; offset < input.size(); offset += BLOCK_SIZE ) {
+        int size = ( int ) std::min<size_t>( BLOCK_SIZE, input.size() - offset );
+        variant.process( &input[ offset ], &output[ offset ], size );
+    }
+}
+
+// the energy outside the harmonics of the fundamental (at given FFT bin) relative to that of the harmonics,
+// in dB. The fundamental is centred on a bin and the render is periodic within the FFT, so no window is required
+
+double measureAliasing( const float* render, int fundamentalBin )
+{
+    FFT fft( LENGTH );
+    std::vector<float> real( render, render + LENGTH );
+    std::vector<float> imag( LENGTH, 0.f );
+    fft.forward( real.data(), imag.data());
+
+    int lastBin = std::min( LENGTH / 2 - 1, ( int ) ( AUDIBLE_LIMIT * LENGTH / SAMPLE_RATE ));
+    double harmonics = 0.0;
+    double aliases   = 0.0;
+
+    for ( int bin = 1; bin <= lastBin; ++bin ) {
+        double power = ( double ) real[ bin ] * real[ bin ] + ( double ) imag[ bin ] * imag[ bin ];
+        if ( bin % fundamentalBin == 0 ) {
+            harmonics += power;
+        } else {
+            aliases += power;
+        }
+    }
+    return 10.0 * log10( std::max( aliases, 1e-30 ) / harmonics );
+}
+
+}
+
+int main( int argc, char* argv[] )
+{
+    Options options;
+    if ( !parseOptions( argc, argv, options )) {
+        fprintf( stderr, "usage: %s [--amount A] [--frequency HZ] [--repeat N]\n", argv[ 0 ]);
+        return 1;
+    }
+
+    // the sine is centred on an FFT bin, the render is preceded by a lead-in
+    // that settles the filters (of which the output is not analysed)
+
+    int fundamentalBin = std::max( 1, ( int ) round( options.frequency * LENGTH / SAMPLE_RATE ));
+    double frequency   = fundamentalBin * SAMPLE_RATE / LENGTH;
+    int leadIn         = BLOCK_SIZE * 2;
+
+    std::vector<float> input( leadIn + LENGTH );
+    for ( size_t i = 0; i < input.size(); ++i ) {
+        input[ i ] = .9f * ( float ) sin( 2.0 * PI * frequency * i / SAMPLE_RATE );
+    }
+    std::vector<float> output( input.size());
+
+    std::vector<Variant> variants;
+    variants.reserve( 7 );
+    variants.emplace_back( "plain",              BitCrusher::AntiAliasing::NONE,         1,  options.amount );
+    variants.emplace_back( "ADAA first order",   BitCrusher::AntiAliasing::FIRST_ORDER,  1,  options.amount );
+    variants.emplace_back( "ADAA second order",  BitCrusher::AntiAliasing::SECOND_ORDER, 1,  options.amount );
+    variants.emplace_back( "2x oversampling",    BitCrusher::AntiAliasing::NONE,         2,  options.amount );
+    variants.emplace_back( "4x oversampling",    BitCrusher::AntiAliasing::NONE,         4,  options.amount );
+    variants.emplace_back( "8x oversampling",    BitCrusher::AntiAliasing::NONE,         8,  options.amount );
+    variants.emplace_back( "16x oversampling",   BitCrusher::AntiAliasing::NONE,         16, options.amount );
+
+    for ( Variant& variant : variants ) {
+        render( variant, input, output );
+        variant.aliasing = measureAliasing( &output[ leadIn ], fundamentalBin );
+
+        auto start = std::chrono::steady_clock::now();
+        for ( int i = 0; i < options.repeat; ++i ) {
+            render( variant, input, output );
+        }
+        auto end = std::chrono::steady_clock::now();
+        variant.cost = std::chrono::duration<double, std::nano>( end - start ).count() / options.repeat / input.size();
+    }
+
+    // report
+
+    const Variant& plain = variants[ 0 ];
+
+    printf( "%.0f Hz sine crushed at amount %.2f (%.0f Hz sample rate), aliasing below %.0f Hz relative to the harmonics\n",
+            frequency, options.amount, SAMPLE_RATE, AUDIBLE_LIMIT );
+    printf( "%-20s %14s %14s %10s\n", "", "aliasing (dB)", "ns / sample", "cost" );
+
+    for ( const Variant& variant : variants ) {
+        printf( "%-20s %14.2f %14.2f %9.1fx\n", variant.name.c_str(), variant.aliasing, variant.cost, variant.cost / plain.cost );
+    }
+
+    // the least oversampling suppressing the aliasing at least as well as each ADAA order
+
+    printf( "\n" );
+    for ( const Variant& adaa : variants ) {
+        if ( adaa.factor != 1 || &adaa == &plain ) {
+            continue;
+        }
+        auto match = std::find_if( variants.begin(), variants.end(), [ &adaa ]( const Variant& variant ) {
+            return variant.factor > 1 && variant.aliasing <= adaa.aliasing;
+        });
+        if ( match == variants.end()) {
+            printf( "%s: none of the oversampling factors matches its suppression\n", adaa.name.c_str());
+        } else {
+            printf( "%s: matched by %s (%.2f dB) at %.1fx its cost\n", adaa.name.c_str(), match->name.c_str(),
+                    match->aliasing, match->cost / adaa.cost );
+        }
+    }
+    return 0;
+}
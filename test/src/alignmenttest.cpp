@@ -0,0 +1,154 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * Verifies the dry signal is aligned with the latency of the anti-aliased BitCrusher (see
+ * BitCrusher::AntiAliasing), where the first order delays the wet signal by half a sample and
+ * the second order by a full sample. At full resolution the wet signal equals the dry signal, as
+ * such mixing both at 50% must null against either signal mixed at 100% (a misaligned dry signal
+ * comb filters the highs). Renders a sine near the top of the spectrum, where misalignment is most audible.
+ *
+ * usage: alignmenttest [--tolerance T] (the largest absolute difference of a sample, defaults to 1e-6)
+ */
+#include "plugin_process.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Igorski;
+
+namespace {
+
+static const float SAMPLE_RATE  = 44100.f;
+static const int BLOCK_SIZE     = 256;
+static const int CHANNELS       = 2;
+static const int LENGTH         = 8192; // in sample frames
+static const double FREQUENCY   = 15000.0;
+static const double PI          = 3.141592653589793;
+
+// renders a sine through PluginProcess at given mix, the effect chain is neutral apart from the
+// anti-aliasing of the BitCrusher (at full resolution its quantizer is bypassed)
+
+template <typename SampleType>
+std::vector<double> render( BitCrusher::AntiAliasing antiAliasing, float dryMix, float wetMix )
+{
+    PluginProcess process( ProcessingContext( SAMPLE_RATE, BLOCK_SIZE, CHANNELS, ProcessingContext::Mode::OFFLINE ));
+    process.setDryMix( dryMix );
+    process.setWetMix( wetMix );
+    process.bitCrusher->setAmount( 1.f );
+    process.bitCrusher->setAntiAliasing( antiAliasing );
+
+    std::vector<std::vector<SampleType>> inBuffers( CHANNELS, std::vector<SampleType>( BLOCK_SIZE ));
+    std::vector<std::vector<SampleType>> outBuffers( CHANNELS, std::vector<SampleType>( BLOCK_SIZE ));
+
+    SampleType* in[ CHANNELS ];
+    SampleType* out[ CHANNELS ];
+    for ( int c = 0; c < CHANNELS; ++c ) {
+        in[ c ]  = inBuffers[ c ].data();
+        out[ c ] = outBuffers[ c ].data();
+    }
+
+    std::vector<double> output( LENGTH * CHANNELS );
+
+    for ( int offset = 0; offset < LENGTH; offset += BLOCK_SIZE ) {
+        for ( int i = 0; i < BLOCK_SIZE; ++i ) {
+            for ( int c = 0; c < CHANNELS; ++c ) {
+                in[ c ][ i ] = ( SampleType ) ( .8 * sin( 2.0 * PI * FREQUENCY * ( offset + i ) / SAMPLE_RATE + c * .5 ));
+            }
+        }
+        process.process<SampleType>( in, out, CHANNELS, CHANNELS, BLOCK_SIZE, BLOCK_SIZE * sizeof( SampleType ));
+
+        for ( int i = 0; i < BLOCK_SIZE; ++i ) {
+            for ( int c = 0; c < CHANNELS; ++c ) {
+                output[( offset + i ) * CHANNELS + c ] = ( double ) out[ c ][ i ];
+            }
+        }
+    }
+    return output;
+}
+
+double getMaxDifference( const std::vector<double>& a, const std::vector<double>& b )
+{
+    double difference = 0.0;
+    for ( size_t i = 0; i < a.size(); ++i ) {
+        double error = fabs( a[ i ] - b[ i ]);
+        // a NaN fails the comparison as well
+        difference = std::isnan( error ) ? INFINITY : std::max( difference, error );
+    }
+    return difference;
+}
+
+template <typename SampleType>
+bool testAlignment( BitCrusher::AntiAliasing antiAliasing, const char* name, const char* precision, double tolerance )
+{
+    std::vector<double> mixed = render<SampleType>( antiAliasing, .5f, .5f );
+    std::vector<double> dry   = render<SampleType>( antiAliasing, 1.f, 0.f );
+    std::vector<double> wet   = render<SampleType>( antiAliasing, 0.f, 1.f );
+
+    double dryDifference = getMaxDifference( mixed, dry );
+    double wetDifference = getMaxDifference( mixed, wet );
+    bool passed = dryDifference <= tolerance && wetDifference <= tolerance;
+
+    printf( "%-13s %-6s difference to dry %.3g, to wet %.3g %s\n", name, precision, dryDifference, wetDifference, passed ? "ok" : "FAILED" );
+
+    return passed;
+}
+
+}
+
+int main( int argc, char* argv[] )
+{
+    double tolerance = 1e-6;
+
+    for ( int i = 1; i < argc; ++i ) {
+        std::string arg = argv[ i ];
+        if ( arg == "--tolerance" && i + 1 < argc ) {
+            tolerance = atof( argv[ ++i ]);
+        } else {
+            fprintf( stderr, "usage: %s [--tolerance T]\n", argv[ 0 ]);
+            return 1;
+        }
+    }
+
+    const struct {
+        BitCrusher::AntiAliasing mode;
+        const char* name;
+    } modes[] = {
+        { BitCrusher::AntiAliasing::NONE,         "none" },
+        { BitCrusher::AntiAliasing::FIRST_ORDER,  "first order" },
+        { BitCrusher::AntiAliasing::SECOND_ORDER, "second order" },
+    };
+
+    bool passed = true;
+    for ( const auto& mode : modes ) {
+        passed = testAlignment<float> ( mode.mode, mode.name, "float",  tolerance ) && passed;
+        passed = testAlignment<double>( mode.mode, mode.name, "double", tolerance ) && passed;
+    }
+
+    printf( "%s\n", passed ? "The dry signal is aligned with the wet signal" : "The dry signal is misaligned with the wet signal" );
+
+    return passed ? 0 : 1;
+}
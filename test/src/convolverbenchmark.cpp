@@ -0,0 +1,180 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * Measures the cost of each block processed by the Convolver, comparing the average against the worst
+ * case (e.g. the blocks in which frames complete), with the tail convolved on the audio thread and with
+ * its far partitions deferred to the worker (see Convolver::setDeferredTail()). The blocks are paced in
+ * realtime so the worker runs as it would in a host, additionally reporting the amount of deferred
+ * frames computed on the audio thread as the worker had not completed these in time (fallbacks) and
+ * the largest difference between the output of both (which only differs in rounding).
+ *
+ * This is not a test (e.g. it does not fail), its timing is specific to the machine.
+ *
+ * usage: convolverbenchmark [--impulse cabinet|room|hall] [--block N] [--seconds S]
+ *        impulse defaults to hall, block to the sizes of 64, 256 and 1024 samples and seconds
+ *        (the duration of each render, as paced in realtime) to 2
+ */
+#include "convolver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Igorski;
+
+namespace {
+
+const float SAMPLE_RATE = 44100.f;
+const int   CHANNELS    = 2;
+
+struct Options {
+    Convolver::Impulse impulse = Convolver::Impulse::HALL;
+    std::vector<int> blockSizes { 64, 256, 1024 };
+    double seconds = 2.0;
+};
+
+struct Result {
+    double average  = 0.0; // in microseconds
+    double p99      = 0.0;
+    double worst    = 0.0;
+    int fallbacks   = 0;
+    std::vector<float> output; // of the first channel
+};
+
+bool parseOptions( int argc, char* argv[], Options& options )
+{
+    for ( int i = 1; i < argc; ++i ) {
+        std::string arg = argv[ i ];
+        bool hasValue   = i + 1 < argc;
+
+        if ( arg == "--impulse" && hasValue ) {
+            std::string name = argv[ ++i ];
+            if ( name == "cabinet" )   options.impulse = Convolver::Impulse::CABINET;
+            else if ( name == "room" ) options.impulse = Convolver::Impulse::ROOM;
+            else if ( name == "hall" ) options.impulse = Convolver::Impulse::HALL;
+            else return false;
+        }
+        else if ( arg == "--block" && hasValue )   options.blockSizes = { std::max( 1, atoi( argv[ ++i ])) };
+        else if ( arg == "--seconds" && hasValue ) options.seconds = std::max( .1, atof( argv[ ++i ]));
+        else return false;
+    }
+    return true;
+}
+
+// renders noise in blocks of given size, paced in realtime, timing the processing of each block
+
+Result render( const Options& options, int blockSize, bool deferred )
+{
+    Convolver convolver( CHANNELS );
+    convolver.setSampleRate( SAMPLE_RATE );
+    convolver.setDeferredTail( deferred ? blockSize : 0 );
+    convolver.setImpulse( options.impulse );
+    convolver.setMix( 1.f );
+    convolver.loadImpulse(); // rather than awaiting the loading thread
+
+    int blocks = std::max( 1, ( int ) ( options.seconds * SAMPLE_RATE / blockSize ));
+    auto blockDuration = std::chrono::duration<double>( blockSize / SAMPLE_RATE );
+
+    std::vector<std::vector<float>> buffers( CHANNELS, std::vector<float>( blockSize ));
+    std::vector<double> timings;
+    Result result;
+
+    uint32_t seed = 1;
+    auto start = std::chrono::steady_clock::now();
+
+    for ( int b = 0; b < blocks; ++b ) {
+        for ( auto& buffer : buffers ) {
+            for ( float& sample : buffer ) {
+                seed   = seed * 1664525u + 1013904223u;
+                sample = (( seed >> 8 ) / 8388608.f - 1.f ) * .5f;
+            }
+        }
+
+        auto blockStart = std::chrono::steady_clock::now();
+
+        convolver.prepare();
+        for ( int c = 0; c < CHANNELS; ++c ) {
+            float* buffer = buffers[ c ].data();
+            convolver.begin( c );
+            for ( int i = 0; i < blockSize; ++i ) {
+                buffer[ i ] = convolver.tick( buffer[ i ], i );
+            }
+        }
+        auto blockEnd = std::chrono::steady_clock::now();
+        timings.push_back( std::chrono::duration<double, std::micro>( blockEnd - blockStart ).count());
+
+        result.output.insert( result.output.end(), buffers[ 0 ].begin(), buffers[ 0 ].end());
+
+        std::this_thread::sleep_until( start + std::chrono::duration_cast<std::chrono::steady_clock::duration>( blockDuration * ( b + 1 )));
+    }
+
+    for ( double timing : timings ) {
+        result.average += timing;
+    }
+    result.average /= timings.size();
+
+    std::sort( timings.begin(), timings.end());
+    result.p99       = timings[ std::min( timings.size() - 1, ( size_t ) ( timings.size() * .99 ))];
+    result.worst     = timings.back();
+    result.fallbacks = convolver.getTailFallbackCount();
+
+    return result;
+}
+
+void report( const char* name, int blockSize, const Result& result )
+{
+    printf( "%-12s block %5d  average %8.2f us  p99 %8.2f us  worst %8.2f us  (worst / average %6.2f)  fallbacks %d\n",
+            name, blockSize, result.average, result.p99, result.worst, result.worst / std::max( 1e-9, result.average ), result.fallbacks );
+}
+
+}
+
+int main( int argc, char* argv[] )
+{
+    Options options;
+
+    if ( !parseOptions( argc, argv, options )) {
+        fprintf( stderr, "usage: %s [--impulse cabinet|room|hall] [--block N] [--seconds S]\n", argv[ 0 ]);
+        return 1;
+    }
+
+    for ( int blockSize : options.blockSizes ) {
+        Result audioThread = render( options, blockSize, false );
+        Result deferred    = render( options, blockSize, true );
+
+        double difference = 0.0;
+        for ( size_t i = 0; i < audioThread.output.size(); ++i ) {
+            difference = std::max( difference, ( double ) fabsf( audioThread.output[ i ] - deferred.output[ i ]));
+        }
+
+        report( "audio thread", blockSize, audioThread );
+        report( "deferred",     blockSize, deferred );
+        printf( "%-12s block %5d  largest difference of the output %.3g\n\n", "", blockSize, difference );
+    }
+    return 0;
+}
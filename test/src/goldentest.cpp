@@ -0,0 +1,482 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * Renders a fixed input signal through PluginProcess at fixed parameter sets and compares the
+ * result against the golden renders stored in test/golden (32-bit floating point WAV files for the
+ * float path, 64-bit for the double path). Each parameter set is rendered in several block sizes
+ * (including single sample blocks and blocks exceeding the maximum block size, which are processed
+ * in chunks), each with its own golden render as the output depends on the block size (e.g. where
+ * the processors update their state per block). The renders are made with the scalar kernels (see
+ * kernels.h) and are compared within a tolerance (the largest absolute difference of a sample, 0
+ * requiring a bit exact match) as the math library of other platforms and compilers differs in rounding.
+ *
+ * Additionally, the render time of each parameter set can be compared against a stored baseline,
+ * failing when it exceeds the baseline by more than the threshold. As timings are specific to
+ * the machine, update the baseline on the machine running the comparison.
+ *
+ * usage: goldentest [options]
+ *
+ * --golden DIR       directory holding the golden renders and timing baseline (defaults to test/golden)
+ * --tolerance T      largest allowed absolute difference of a sample (defaults to 1e-6)
+ * --update           (re)write the golden renders and timing baseline rather than comparing against them
+ * --timing           compare the render times against the timing baseline
+ * --threshold P      allowed increase of the render time over the baseline, in percent (defaults to 25)
+ */
+#include "plugin_process.h"
+#include "kernels/kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef GOLDEN_DIRECTORY
+#define GOLDEN_DIRECTORY "test/golden"
+#endif
+
+using namespace Igorski;
+
+namespace {
+
+static const float SAMPLE_RATE   = 44100.f;
+static const int MAX_BLOCK_SIZE  = 512;
+static const int CHANNELS        = 2;
+static const int LENGTH          = 4096; // in sample frames
+static const int TIMING_RUNS     = 5;    // the fastest run is compared against the baseline
+static const double PI           = 3.141592653589793;
+
+// the block sizes each parameter set is rendered in (where the first block of 1000 samples
+// is processed in chunks of MAX_BLOCK_SIZE), the timing renders in blocks of MAX_BLOCK_SIZE
+
+static const int BLOCK_SIZES[] = { 1, 300, 1000 };
+
+struct Options {
+    std::string directory = GOLDEN_DIRECTORY;
+    double tolerance      = 1e-6;
+    double threshold      = 25.0;
+    bool update           = false;
+    bool timing           = false;
+};
+
+struct ParameterSet {
+    const char* name;
+    bool sideChain; // whether the sidechain is fed the key signal
+    std::function<void( PluginProcess& )> apply;
+};
+
+const std::vector<ParameterSet> PARAMETER_SETS = {
+    { "crush", false, []( PluginProcess& process ) {
+        process.setDryMix( .3f );
+        process.setWetMix( 1.f );
+        process.bitCrusher->setAmount( .4f );
+        process.bitCrusher->setLFO( .5f, .5f );
+    }},
+    { "crush_antialiased_dithered", false, []( PluginProcess& process ) {
+        process.setDryMix( .5f );
+        process.setWetMix( 1.f );
+        process.bitCrusher->setAmount( .7f );
+        process.bitCrusher->setAntiAliasing( BitCrusher::AntiAliasing::SECOND_ORDER );
+        process.bitCrusher->setDither( Dither::Mode::SHAPED );
+    }},
+    { "filter_delay", false, []( PluginProcess& process ) {
+        process.setDryMix( 0.f );
+        process.setWetMix( 1.f );
+        process.bitCrusher->setAmount( .2f );
+        process.filterBank->setHighPass( 200.f );
+        process.filterBank->setLowPass( 6000.f );
+        process.filterBank->setTilt( 3.f );
+        process.setTempo( 240.0, 3, 4 );
+        process.setDelayTime( 0.f );
+        process.setDelayFeedback( .6f );
+        process.setDelayMix( .5f );
+    }},
+    { "convolver", false, []( PluginProcess& process ) {
+        process.setDryMix( .5f );
+        process.setWetMix( .8f );
+        process.convolver->setImpulse( Convolver::Impulse::ROOM );
+        process.convolver->setMix( .7f );
+        process.setLimiterEnabled( true ); // the room exceeds 0 dBFS
+    }},
+    { "sidechain", true, []( PluginProcess& process ) {
+        process.setDryMix( .2f );
+        process.setWetMix( 1.f );
+        process.bitCrusher->setAmount( .3f );
+        process.setSideChainDuck( .8f );
+        process.setSideChainCrush( .6f );
+    }},
+    { "internal_blocks", false, []( PluginProcess& process ) {
+        process.setInternalBlockSize( 64, BlockAdapter::Mode::FIXED_LATENCY );
+        process.setDryMix( .3f );
+        process.setWetMix( 1.f );
+        process.bitCrusher->setAmount( .5f );
+        process.bitCrusher->setAntiAliasing( BitCrusher::AntiAliasing::FIRST_ORDER );
+        process.setDelayTime( 1.f );
+        process.setDelayFeedback( .4f );
+        process.setDelayMix( .3f );
+    }},
+    { "internal_blocks_zero_latency", true, []( PluginProcess& process ) {
+        process.setInternalBlockSize( 64, BlockAdapter::Mode::ZERO_LATENCY );
+        process.setDryMix( .3f );
+        process.setWetMix( 1.f );
+        process.bitCrusher->setAmount( .5f );
+        process.filterBank->setLowPass( 4000.f );
+        process.setSideChainDuck( .5f );
+        process.setSideChainCrush( .4f );
+        process.setDelayTime( .5f );
+        process.setDelayFeedback( .4f );
+        process.setDelayMix( .3f );
+    }},
+};
+
+bool parseOptions( int argc, char* argv[], Options& options )
+{
+    for ( int i = 1; i < argc; ++i ) {
+        std::string arg = argv[ i ];
+        bool hasValue   = i + 1 < argc;
+
+        if ( arg == "--golden" && hasValue )          options.directory = argv[ ++i ];
+        else if ( arg == "--tolerance" && hasValue )  options.tolerance = atof( argv[ ++i ]);
+        else if ( arg == "--threshold" && hasValue )  options.threshold = atof( argv[ ++i ]);
+        else if ( arg == "--update" )                 options.update    = true;
+        else if ( arg == "--timing" )                 options.timing    = true;
+        else {
+            fprintf( stderr, "Unknown option \"%s\"\n", arg.c_str());
+            return false;
+        }
+    }
+    return options.tolerance >= 0.0 && options.threshold >= 0.0;
+}
+
+// the input signal: a sine sweep with a burst of noise, followed by silence (to render the tails)
+// and a key signal (for the sidechain) gated in short pulses
+
+void createInput( std::vector<float>& input, std::vector<float>& key )
+{
+    input.resize( LENGTH * CHANNELS );
+    key.resize( LENGTH );
+
+    uint32_t seed = 1;
+    double phase  = 0.0;
+
+    for ( int i = 0; i < LENGTH; ++i ) {
+        double position  = ( double ) i / LENGTH;
+        double frequency = 80.0 * pow( 100.0, position ); // 80 Hz - 8 kHz
+        phase += 2.0 * PI * frequency / SAMPLE_RATE;
+
+        for ( int c = 0; c < CHANNELS; ++c ) {
+            seed = seed * 1664525u + 1013904223u;
+            double noise  = ( position > .4 && position < .45 ) ? (( seed >> 8 ) / 8388608.0 - 1.0 ) * .5 : 0.0;
+            double sample = position < .75 ? .8 * sin( phase + c * .5 ) + noise : 0.0;
+
+            input[ i * CHANNELS + c ] = ( float ) sample;
+        }
+        key[ i ] = ( i / 1024 ) % 2 == 1 ? ( float ) ( .9 * sin( 2.0 * PI * 60.0 * i / SAMPLE_RATE )) : 0.f;
+    }
+}
+
+// renders the input in given block size, writing the interleaved output, returns the render time in microseconds
+
+template <typename SampleType>
+double render( const ParameterSet& set, int blockSize, const std::vector<float>& input, const std::vector<float>& key,
+               std::vector<double>& output )
+{
+    PluginProcess process( ProcessingContext( SAMPLE_RATE, MAX_BLOCK_SIZE, CHANNELS, ProcessingContext::Mode::OFFLINE ));
+    set.apply( process );
+    process.convolver->loadImpulse(); // rather than awaiting the loading thread
+
+    std::vector<std::vector<SampleType>> inBuffers( CHANNELS, std::vector<SampleType>( blockSize ));
+    std::vector<std::vector<SampleType>> outBuffers( CHANNELS, std::vector<SampleType>( blockSize ));
+    std::vector<SampleType> keyBuffer( blockSize );
+
+    SampleType* in[ CHANNELS ];
+    SampleType* out[ CHANNELS ];
+    for ( int c = 0; c < CHANNELS; ++c ) {
+        in[ c ]  = inBuffers[ c ].data();
+        out[ c ] = outBuffers[ c ].data();
+    }
+    SampleType* sideChain[ 1 ] = { keyBuffer.data() };
+
+    output.resize( LENGTH * CHANNELS );
+    double duration = 0.0;
+
+    for ( int offset = 0; offset < LENGTH; offset += blockSize ) {
+        int size = std::min( blockSize, LENGTH - offset );
+
+        for ( int i = 0; i < size; ++i ) {
+            for ( int c = 0; c < CHANNELS; ++c ) {
+                in[ c ][ i ] = ( SampleType ) input[( offset + i ) * CHANNELS + c ];
+            }
+            keyBuffer[ i ] = ( SampleType ) key[ offset + i ];
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        process.process<SampleType>( in, out, CHANNELS, CHANNELS, size, size * sizeof( SampleType ),
+                                     set.sideChain ? sideChain : nullptr, set.sideChain ? 1 : 0 );
+        auto end = std::chrono::steady_clock::now();
+        duration += std::chrono::duration<double, std::micro>( end - start ).count();
+
+        for ( int i = 0; i < size; ++i ) {
+            for ( int c = 0; c < CHANNELS; ++c ) {
+                output[( offset + i ) * CHANNELS + c ] = ( double ) out[ c ][ i ];
+            }
+        }
+    }
+    return duration;
+}
+
+/* golden files, stored as 32-bit (float) or 64-bit (double) floating point WAV files */
+
+std::string getGoldenPath( const Options& options, const ParameterSet& set, int bitsPerSample, int blockSize )
+{
+    return options.directory + "/" + set.name + ( bitsPerSample == 64 ? "_double_" : "_float_" ) + std::to_string( blockSize ) + ".wav";
+}
+
+template <typename T>
+void writeValue( std::ofstream& file, T value )
+{
+    file.write( reinterpret_cast<const char*>( &value ), sizeof( T )); // little endian platforms only
+}
+
+bool writeWav( const std::string& path, const std::vector<double>& samples, int bitsPerSample )
+{
+    std::ofstream file( path, std::ios::binary );
+    if ( !file ) {
+        return false;
+    }
+    uint32_t bytesPerSample = bitsPerSample / 8;
+    uint32_t dataSize       = ( uint32_t ) samples.size() * bytesPerSample;
+
+    file.write( "RIFF", 4 );
+    writeValue<uint32_t>( file, 36 + dataSize );
+    file.write( "WAVEfmt ", 8 );
+    writeValue<uint32_t>( file, 16 );
+    writeValue<uint16_t>( file, 3 ); // IEEE floating point
+    writeValue<uint16_t>( file, CHANNELS );
+    writeValue<uint32_t>( file, ( uint32_t ) SAMPLE_RATE );
+    writeValue<uint32_t>( file, ( uint32_t ) SAMPLE_RATE * CHANNELS * bytesPerSample );
+    writeValue<uint16_t>( file, ( uint16_t ) ( CHANNELS * bytesPerSample ));
+    writeValue<uint16_t>( file, ( uint16_t ) bitsPerSample );
+    file.write( "data", 4 );
+    writeValue<uint32_t>( file, dataSize );
+
+    for ( double sample : samples ) {
+        if ( bitsPerSample == 64 ) {
+            writeValue<double>( file, sample );
+        } else {
+            writeValue<float>( file, ( float ) sample );
+        }
+    }
+    return file.good();
+}
+
+bool readWav( const std::string& path, std::vector<double>& samples, int bitsPerSample )
+{
+    std::ifstream file( path, std::ios::binary );
+    if ( !file ) {
+        return false;
+    }
+    std::vector<char> data(( std::istreambuf_iterator<char>( file )), std::istreambuf_iterator<char>());
+    if ( data.size() < 44 || memcmp( data.data(), "RIFF", 4 ) != 0 || memcmp( data.data() + 8, "WAVE", 4 ) != 0 ) {
+        return false;
+    }
+    uint16_t format, channels, bits;
+    uint32_t dataSize;
+    memcpy( &format,   data.data() + 20, 2 );
+    memcpy( &channels, data.data() + 22, 2 );
+    memcpy( &bits,     data.data() + 34, 2 );
+    memcpy( &dataSize, data.data() + 40, 4 );
+
+    if ( format != 3 || channels != CHANNELS || bits != bitsPerSample || data.size() < 44 + ( size_t ) dataSize ) {
+        return false;
+    }
+    const char* values = data.data() + 44;
+    samples.resize( dataSize / ( bits / 8 ));
+
+    for ( size_t i = 0; i < samples.size(); ++i ) {
+        if ( bits == 64 ) {
+            memcpy( &samples[ i ], values + i * 8, 8 );
+        } else {
+            float value;
+            memcpy( &value, values + i * 4, 4 );
+            samples[ i ] = value;
+        }
+    }
+    return true;
+}
+
+/* timing baseline, stored as lines of: "name microseconds" */
+
+std::string getTimingPath( const Options& options )
+{
+    return options.directory + "/timing.txt";
+}
+
+std::map<std::string, double> readTimings( const std::string& path )
+{
+    std::map<std::string, double> timings;
+    std::ifstream file( path );
+    std::string line;
+
+    while ( std::getline( file, line )) {
+        if ( line.empty() || line[ 0 ] == '#' ) {
+            continue;
+        }
+        std::istringstream stream( line );
+        std::string name;
+        double microseconds;
+        if ( stream >> name >> microseconds ) {
+            timings[ name ] = microseconds;
+        }
+    }
+    return timings;
+}
+
+// compares the render against the golden render, returns the largest absolute difference (infinite when their size differs)
+
+double compare( const std::vector<double>& golden, const std::vector<double>& rendered )
+{
+    if ( golden.size() != rendered.size()) {
+        return INFINITY;
+    }
+    double maxError = 0.0;
+    for ( size_t i = 0; i < golden.size(); ++i ) {
+        double error = fabs( golden[ i ] - rendered[ i ] );
+        maxError = std::isnan( error ) ? INFINITY : std::max( maxError, error );
+    }
+    return maxError;
+}
+
+template <typename SampleType>
+bool testParameterSet( const Options& options, const ParameterSet& set, const std::vector<float>& input,
+                       const std::vector<float>& key, std::map<std::string, double>& timings )
+{
+    const int bitsPerSample = sizeof( SampleType ) * 8;
+    const char* typeName    = bitsPerSample == 64 ? "double" : "float";
+
+    std::vector<double> golden;
+    std::vector<double> rendered;
+    bool passed = true;
+
+    for ( int blockSize : BLOCK_SIZES ) {
+        const std::string path = getGoldenPath( options, set, bitsPerSample, blockSize );
+
+        render<SampleType>( set, blockSize, input, key, rendered );
+
+        if ( options.update ) {
+            if ( !writeWav( path, rendered, bitsPerSample )) {
+                fprintf( stderr, "Could not write \"%s\"\n", path.c_str());
+                passed = false;
+            }
+            continue;
+        }
+        if ( !readWav( path, golden, bitsPerSample )) {
+            fprintf( stderr, "Could not read \"%s\" (create the golden renders using --update)\n", path.c_str());
+            passed = false;
+            continue;
+        }
+        double error = compare( golden, rendered );
+        bool matches = error <= options.tolerance;
+
+        printf( "%-28s %-6s block %4d  max error %.3g %s\n", set.name, typeName, blockSize, error, matches ? "ok" : "FAILED" );
+        passed = passed && matches;
+    }
+
+    // the render time of the float path in the golden block size
+
+    if (( options.update || options.timing ) && bitsPerSample == 32 ) {
+        double fastest = INFINITY;
+        for ( int run = 0; run < TIMING_RUNS; ++run ) {
+            fastest = std::min( fastest, render<SampleType>( set, MAX_BLOCK_SIZE, input, key, rendered ));
+        }
+
+        if ( options.update ) {
+            timings[ set.name ] = fastest;
+        } else if ( timings.count( set.name ) == 0 ) {
+            fprintf( stderr, "No timing baseline for \"%s\" (create it using --update)\n", set.name );
+            passed = false;
+        } else {
+            double baseline = timings[ set.name ];
+            double change   = 100.0 * ( fastest - baseline ) / baseline;
+            bool withinThreshold = change <= options.threshold;
+
+            printf( "%-28s render time %.1f us, baseline %.1f us (%+.1f %%) %s\n",
+                    set.name, fastest, baseline, change, withinThreshold ? "ok" : "REGRESSED" );
+            passed = passed && withinThreshold;
+        }
+    }
+    return passed;
+}
+
+}
+
+int main( int argc, char* argv[] )
+{
+    Options options;
+    if ( !parseOptions( argc, argv, options )) {
+        fprintf( stderr, "usage: %s [--golden DIR] [--tolerance T] [--update] [--timing] [--threshold PERCENT]\n", argv[ 0 ]);
+        return 1;
+    }
+
+    // the golden renders are made with the scalar reference kernels (see kernels.h)
+
+    Kernels::init( Kernels::ISA::SCALAR );
+
+    std::vector<float> input;
+    std::vector<float> key;
+    createInput( input, key );
+
+    std::map<std::string, double> timings;
+    if ( options.timing && !options.update ) {
+        timings = readTimings( getTimingPath( options ));
+    }
+
+    bool passed = true;
+    for ( const ParameterSet& set : PARAMETER_SETS ) {
+        passed = testParameterSet<float>( options, set, input, key, timings ) && passed;
+        passed = testParameterSet<double>( options, set, input, key, timings ) && passed;
+    }
+
+    if ( options.update ) {
+        printf( "Wrote the golden renders to %s\n", options.directory.c_str());
+
+        std::ofstream file( getTimingPath( options ));
+        file << "# render time (in microseconds) of " << LENGTH << " sample frames in blocks of " << MAX_BLOCK_SIZE << " samples\n";
+        for ( const auto& timing : timings ) {
+            file << timing.first << " " << timing.second << "\n";
+        }
+        printf( "Wrote %s\n", getTimingPath( options ).c_str());
+    }
+
+    printf( "%s\n", passed ? "All renders match the golden renders" : "Renders deviate from the golden renders" );
+
+    return passed ? 0 : 1;
+}
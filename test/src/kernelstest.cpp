@@ -0,0 +1,215 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * Verifies the vectorised kernel variants of each instruction set supported by the CPU against
+ * the scalar reference (see src/kernels/kernels.h), for sizes covering the vector widths and their
+ * remainders. The variants sum in a different order (and use fused multiply-add where available),
+ * as such their results are compared within a tolerance relative to the magnitude of the result.
+ *
+ * usage: kernelstest [--tolerance T] (defaults to 1e-5)
+ */
+#include "kernels/kernels.h"
+#include "fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Igorski;
+
+namespace {
+
+struct Result {
+    double maxError = 0.0;
+    bool passed     = true;
+};
+
+std::mt19937 random( 1 );
+
+std::vector<float> createSignal( int size )
+{
+    std::uniform_real_distribution<float> distribution( -1.f, 1.f );
+    std::vector<float> signal( size );
+    for ( float& sample : signal ) {
+        sample = distribution( random );
+    }
+    return signal;
+}
+
+// compare given values against the reference, the error is relative to the largest reference magnitude
+
+void compare( const std::vector<float>& reference, const std::vector<float>& values, double tolerance, Result& result )
+{
+    double magnitude = 1.0;
+    for ( float value : reference ) {
+        magnitude = std::max( magnitude, ( double ) fabsf( value ));
+    }
+    for ( size_t i = 0; i < reference.size(); ++i ) {
+        double error = fabs(( double ) reference[ i ] - values[ i ] ) / magnitude;
+
+        // a NaN fails the comparison as well
+
+        if ( !( error <= tolerance )) {
+            result.passed = false;
+        }
+        result.maxError = std::max( result.maxError, error );
+    }
+}
+
+void report( const char* kernel, Kernels::ISA isa, const Result& result )
+{
+    printf( "%-28s %-7s max error %.3g %s\n", kernel, Kernels::getName( isa ), result.maxError, result.passed ? "ok" : "FAILED" );
+}
+
+bool testTable( const Kernels::Table& reference, const Kernels::Table& table, double tolerance )
+{
+    Result dotProduct, complexMultiplyAccumulate, fftButterflies, feedbackMix, fft;
+
+    for ( int size = 0; size <= 133; ++size ) {
+        std::vector<float> a = createSignal( size );
+        std::vector<float> b = createSignal( size );
+
+        compare({ reference.dotProduct( a.data(), b.data(), size )},
+                { table.dotProduct( a.data(), b.data(), size )}, tolerance, dotProduct );
+
+        std::vector<float> aImag = createSignal( size );
+        std::vector<float> bImag = createSignal( size );
+        std::vector<float> outReal = createSignal( size ), outImag = createSignal( size );
+        std::vector<float> expectedReal = outReal, expectedImag = outImag;
+
+        reference.complexMultiplyAccumulate( expectedReal.data(), expectedImag.data(), a.data(), aImag.data(), b.data(), bImag.data(), size );
+        table.complexMultiplyAccumulate( outReal.data(), outImag.data(), a.data(), aImag.data(), b.data(), bImag.data(), size );
+        compare( expectedReal, outReal, tolerance, complexMultiplyAccumulate );
+        compare( expectedImag, outImag, tolerance, complexMultiplyAccumulate );
+
+        std::vector<float> samples = createSignal( size ), tap = createSignal( size );
+        std::vector<float> expectedSamples = samples, expectedTap = tap;
+
+        reference.feedbackMix( expectedSamples.data(), expectedTap.data(), .7f, .4f, size );
+        table.feedbackMix( samples.data(), tap.data(), .7f, .4f, size );
+        compare( expectedSamples, samples, tolerance, feedbackMix );
+        compare( expectedTap, tap, tolerance, feedbackMix );
+    }
+
+    // each stage of the transform sizes in use (including the half spans below the vector widths)
+
+    for ( int size = 2; size <= 4096; size <<= 1 ) {
+        for ( int half = 1; half < size; half <<= 1 ) {
+            std::vector<float> real = createSignal( size ), imag = createSignal( size );
+            std::vector<float> twiddleReal = createSignal( half ), twiddleImag = createSignal( half );
+            std::vector<float> expectedReal = real, expectedImag = imag;
+
+            reference.fftButterflies( expectedReal.data(), expectedImag.data(), twiddleReal.data(), twiddleImag.data(), half, size );
+            table.fftButterflies( real.data(), imag.data(), twiddleReal.data(), twiddleImag.data(), half, size );
+            compare( expectedReal, real, tolerance, fftButterflies );
+            compare( expectedImag, imag, tolerance, fftButterflies );
+        }
+    }
+
+    // the complete transform, as dispatched by the FFT
+
+    for ( int size = 2; size <= 4096; size <<= 1 ) {
+        FFT transform( size );
+        std::vector<float> real = createSignal( size ), imag = createSignal( size );
+        std::vector<float> expectedReal = real, expectedImag = imag;
+
+        Kernels::init( reference.isa );
+        transform.forward( expectedReal.data(), expectedImag.data());
+        Kernels::init( table.isa );
+        transform.forward( real.data(), imag.data());
+
+        compare( expectedReal, real, tolerance, fft );
+        compare( expectedImag, imag, tolerance, fft );
+    }
+
+    report( "dotProduct",                table.isa, dotProduct );
+    report( "complexMultiplyAccumulate", table.isa, complexMultiplyAccumulate );
+    report( "fftButterflies",            table.isa, fftButterflies );
+    report( "feedbackMix",               table.isa, feedbackMix );
+    report( "FFT::forward",              table.isa, fft );
+
+    return dotProduct.passed && complexMultiplyAccumulate.passed && fftButterflies.passed && feedbackMix.passed && fft.passed;
+}
+
+}
+
+int main( int argc, char* argv[] )
+{
+    double tolerance = 1e-5;
+
+    for ( int i = 1; i < argc; ++i ) {
+        std::string arg = argv[ i ];
+        if ( arg == "--tolerance" && i + 1 < argc ) {
+            tolerance = atof( argv[ ++i ]);
+        } else {
+            fprintf( stderr, "usage: %s [--tolerance T]\n", argv[ 0 ]);
+            return 1;
+        }
+    }
+
+    const Kernels::Table reference = Kernels::getTable( Kernels::ISA::SCALAR );
+    bool passed = true;
+
+    // the scalar reference is in place until initialized and can be selected explicitly
+
+    if ( Kernels::get().isa != Kernels::ISA::SCALAR ) {
+        fprintf( stderr, "The scalar reference is not in place prior to initialization\n" );
+        passed = false;
+    }
+
+    for ( int i = 0; i < Kernels::ISA_COUNT; ++i ) {
+        Kernels::ISA isa = ( Kernels::ISA ) i;
+
+        if ( !Kernels::isSupported( isa )) {
+            // unsupported instruction sets resolve to the scalar reference
+
+            if ( Kernels::getTable( isa ).isa != Kernels::ISA::SCALAR ) {
+                fprintf( stderr, "Unsupported instruction set %s did not resolve to the scalar reference\n", Kernels::getName( isa ));
+                passed = false;
+            }
+            printf( "%-28s %-7s not supported, skipped\n", "", Kernels::getName( isa ));
+            continue;
+        }
+        Kernels::Table table = Kernels::getTable( isa );
+        if ( table.isa != isa ) {
+            fprintf( stderr, "Instruction set %s is supported yet its variants are not compiled in\n", Kernels::getName( isa ));
+            passed = false;
+            continue;
+        }
+        passed = testTable( reference, table, tolerance ) && passed;
+    }
+
+    Kernels::init( Kernels::ISA::SCALAR );
+    if ( Kernels::get().isa != Kernels::ISA::SCALAR ) {
+        fprintf( stderr, "The scalar reference could not be selected\n" );
+        passed = false;
+    }
+
+    printf( "%s\n", passed ? "All kernel variants match the scalar reference" : "Kernel variants deviate from the scalar reference" );
+
+    return passed ? 0 : 1;
+}
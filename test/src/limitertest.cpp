@@ -0,0 +1,100 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * Verifies the output Limiter (as configured by PluginProcess, e.g. limiting at 0 dBFS) keeps
+ * the output within its ceiling and reports a gain reduction within the 0 - 1 range, for signals
+ * peaking above the ceiling (sustained as well as single sample peaks) in either precision.
+ *
+ * usage: limitertest
+ */
+#include "limiter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const int CHANNELS   = 2;
+const int BLOCK_SIZE = 256;
+const int BLOCKS     = 64;
+const double PI      = 3.141592653589793;
+
+// the ceiling of a Limiter limiting at 0 dBFS (at unity trim), allowing for rounding of the gain
+
+const double CEILING = 1.0 + 1e-6;
+
+template <typename SampleType>
+bool testPeak( double peak )
+{
+    Limiter limiter( .15f, .5f, 1.f );
+
+    std::vector<std::vector<SampleType>> channels( CHANNELS, std::vector<SampleType>( BLOCK_SIZE ));
+    SampleType* buffers[ CHANNELS ] = { channels[ 0 ].data(), channels[ 1 ].data() };
+
+    double maxOutput = 0.0, minGR = 1.0, maxGR = 0.0;
+
+    for ( int block = 0; block < BLOCKS; ++block ) {
+        for ( int i = 0; i < BLOCK_SIZE; ++i ) {
+            int position = block * BLOCK_SIZE + i;
+
+            // a sine at given peak on the first channel and single sample peaks (of either polarity)
+            // on an otherwise quiet second channel, followed by silence to exercise the release
+
+            bool isSilent = block >= BLOCKS - 8;
+            channels[ 0 ][ i ] = isSilent ? 0 : ( SampleType ) ( peak * sin( 2.0 * PI * 440.0 * position / 44100.0 ));
+            channels[ 1 ][ i ] = isSilent ? 0 : ( SampleType ) (( position % 97 == 0 ) ? ( position % 2 ? -peak : peak ) : .1 );
+        }
+        limiter.process<SampleType>( buffers, BLOCK_SIZE, CHANNELS );
+
+        for ( int c = 0; c < CHANNELS; ++c ) {
+            for ( SampleType sample : channels[ c ] ) {
+                maxOutput = std::max( maxOutput, fabs(( double ) sample ));
+            }
+        }
+        minGR = std::min( minGR, ( double ) limiter.getLinearGR());
+        maxGR = std::max( maxGR, ( double ) limiter.getLinearGR());
+    }
+
+    bool passed = maxOutput <= CEILING && minGR >= 0.0 && maxGR <= 1.0;
+
+    printf( "%-7s peak %5.2f  max output %.6f  gain reduction %.4f - %.4f %s\n", sizeof( SampleType ) == 4 ? "float" : "double",
+            peak, maxOutput, minGR, maxGR, passed ? "ok" : "FAILED" );
+
+    return passed;
+}
+
+}
+
+int main()
+{
+    bool passed = true;
+
+    for ( double peak : { 1.5, 3.0, 10.0 }) {
+        passed = testPeak<float>( peak ) && passed;
+        passed = testPeak<double>( peak ) && passed;
+    }
+    printf( "%s\n", passed ? "The limiter output remains within its ceiling" : "The limiter output exceeds its ceiling" );
+
+    return passed ? 0 : 1;
+}